@@ -0,0 +1,326 @@
+#include "LifeBoard.hpp"
+#include "FrameRenderer.hpp"
+#include "TemporalStepper.hpp"
+#include "PaddedStepper.hpp"
+#include "ThreadPool.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <ostream>
+#include <streambuf>
+#include <utility>
+
+/**
+ * \file
+ * \brief Micro and macro benchmarks of the LifeBoard functions.
+ *
+ * Board sizes run from 64x64 up to 16384x16384 for the whole board operations, the per-cell 
+ * getAliveNeighbours() and the text renderer stop at 4096x4096 since they are far slower. 
+ * Run through `make bench`, which writes the results as JSON so builds can be compared.
+ */
+
+namespace
+{
+    /// Seed used for every random board so each run measures the same boards.
+    constexpr unsigned int benchmarkSeed = 20181;
+
+    /**
+     *\brief Creates a square board where each cell is alive with a given probability.
+     *\param size number of rows and columns.
+     *\param densityPercent percentage chance of each cell being alive.
+     *\return LifeBoard holding the random cells.
+     */
+    LifeBoard randomBoard(int size, int densityPercent)
+    {
+        std::default_random_engine generator(benchmarkSeed);
+        std::bernoulli_distribution alive(densityPercent / 100.0);
+
+        LifeBoard board(size, size, LifeBoard::Dead);
+        for(int row = 0; row < size; ++row)
+        {
+            for(int col = 0; col < size; ++col)
+            {
+                if(alive(generator))
+                {
+                    board(row,col) = LifeBoard::Alive;
+                }
+            }
+        }
+
+        return board;
+    }
+
+    /**
+     * \enum Pattern
+     * \brief Enumeration type to identify the standard patterns benchmarked.
+     */
+    enum Pattern
+    {
+        Glider,
+        Sink,
+        Blinker,
+        RPentominoSoup,
+    };
+
+    /**
+     *\brief Creates a square board with a standard pattern in the middle.
+     *\param size number of rows and columns.
+     *\param pattern Pattern to place.
+     *\return LifeBoard holding the pattern.
+     */
+    LifeBoard patternBoard(int size, Pattern pattern)
+    {
+        LifeBoard board(size, size, LifeBoard::Dead);
+        int centre = size / 2;
+
+        // Offsets of the live cells of each pattern from the centre of the board.
+        static const std::pair<int,int> glider[]      = {{-1,0}, {0,1}, {1,-1}, {1,0}, {1,1}};
+        static const std::pair<int,int> sink[]        = {{0,0}, {0,1}, {1,0}, {1,1}};
+        static const std::pair<int,int> blinker[]     = {{-1,0}, {0,0}, {1,0}};
+        static const std::pair<int,int> rPentomino[]  = {{-1,0}, {-1,1}, {0,-1}, {0,0}, {1,0}};
+
+        const std::pair<int,int> *begin = glider;
+        const std::pair<int,int> *end   = glider + 5;
+        switch(pattern)
+        {
+            case Sink:
+                begin = sink;
+                end   = sink + 4;
+                break;
+            case Blinker:
+                begin = blinker;
+                end   = blinker + 3;
+                break;
+            case RPentominoSoup:
+                begin = rPentomino;
+                end   = rPentomino + 5;
+                break;
+            default:
+                break;
+        }
+
+        for(const std::pair<int,int> *cell = begin; cell != end; ++cell)
+        {
+            board(centre + cell->first, centre + cell->second) = LifeBoard::Alive;
+        }
+
+        // Let the R-pentomino spread into a soup of debris before timing.
+        if(pattern == RPentominoSoup)
+        {
+            LifeBoard next = board;
+            for(int generation = 0; generation < 500; ++generation)
+            {
+                update(next, board);
+                std::swap(next, board);
+            }
+        }
+
+        return board;
+    }
+
+    /**
+     * \class NullBuffer
+     * \brief Stream buffer that throws away everything written to it so only formatting is timed.
+     */
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int character) override
+        {
+            return character;
+        }
+
+        std::streamsize xsputn(const char*, std::streamsize count) override
+        {
+            return count;
+        }
+    };
+}
+
+static void BM_Update(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard current = randomBoard(size, static_cast<int>(state.range(1)));
+    LifeBoard updated = current;
+
+    for(auto _ : state)
+    {
+        update(updated, current);
+        std::swap(updated, current);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_Update)->ArgNames({"size", "density"})
+    ->ArgsProduct({benchmark::CreateRange(64, 16384, 4), {10, 50}})->Unit(benchmark::kMicrosecond);
+
+static void BM_TemporalStepper(benchmark::State &state)
+{
+    int size  = static_cast<int>(state.range(0));
+    int depth = static_cast<int>(state.range(1));
+    LifeBoard current = randomBoard(size, 50);
+    LifeBoard updated = current;
+    TemporalStepper stepper;
+
+    for(auto _ : state)
+    {
+        stepper.step(updated, current, depth);
+        std::swap(updated, current);
+        benchmark::ClobberMemory();
+    }
+
+    // Count cell updates so the depths can be compared with each other and with BM_Update.
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size * depth);
+}
+BENCHMARK(BM_TemporalStepper)->ArgNames({"size", "depth"})
+    ->ArgsProduct({{1024, 16384}, {1, 4, 8, 16}})->Unit(benchmark::kMicrosecond);
+
+static void BM_PaddedStepper(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    ThreadPool pool(1);
+    PaddedStepper stepper;
+    stepper.setBoard(randomBoard(size, 50));
+
+    for(auto _ : state)
+    {
+        stepper.step(pool);
+        benchmark::ClobberMemory();
+    }
+
+    // Count cell updates so it can be compared with BM_Update.
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_PaddedStepper)->ArgName("size")->RangeMultiplier(4)->Range(64, 16384)->Unit(benchmark::kMicrosecond);
+
+static void BM_UpdateWithStatistics(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard current = randomBoard(size, static_cast<int>(state.range(1)));
+    current.setStatisticsTracking(true);
+    LifeBoard updated = current;
+
+    for(auto _ : state)
+    {
+        update(updated, current);
+        std::swap(updated, current);
+        benchmark::DoNotOptimize(current.centreOfMass());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_UpdateWithStatistics)->ArgNames({"size", "density"})
+    ->ArgsProduct({benchmark::CreateRange(64, 16384, 4), {10, 50}})->Unit(benchmark::kMicrosecond);
+
+static void BM_GetAliveNeighbours(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard board = randomBoard(size, static_cast<int>(state.range(1)));
+
+    for(auto _ : state)
+    {
+        long long total = 0;
+        for(int row = 0; row < size; ++row)
+        {
+            for(int col = 0; col < size; ++col)
+            {
+                total += board.getAliveNeighbours(row, col);
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_GetAliveNeighbours)->ArgNames({"size", "density"})
+    ->ArgsProduct({benchmark::CreateRange(64, 4096, 4), {10, 50}})->Unit(benchmark::kMicrosecond);
+
+static void BM_CentreOfMass(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard board = randomBoard(size, static_cast<int>(state.range(1)));
+
+    // Throw away the cached statistics so every iteration measures the scan of the board.
+    for(auto _ : state)
+    {
+        board.invalidateStatistics();
+        benchmark::DoNotOptimize(board.centreOfMass());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_CentreOfMass)->ArgNames({"size", "density"})
+    ->ArgsProduct({benchmark::CreateRange(64, 16384, 4), {10, 50}})->Unit(benchmark::kMicrosecond);
+
+static void BM_Randomise(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard board(size, size, LifeBoard::Dead);
+    std::default_random_engine generator(benchmarkSeed);
+
+    for(auto _ : state)
+    {
+        board.randomise(generator);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_Randomise)->ArgName("size")->RangeMultiplier(4)->Range(64, 16384)->Unit(benchmark::kMicrosecond);
+
+static void BM_Render(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard board = randomBoard(size, static_cast<int>(state.range(1)));
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+
+    for(auto _ : state)
+    {
+        out << board;
+    }
+
+    // Each cell is rendered as a symbol and a space.
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(size) * (2 * size + 1));
+}
+BENCHMARK(BM_Render)->ArgNames({"size", "density"})
+    ->ArgsProduct({benchmark::CreateRange(64, 4096, 4), {10, 50}})->Unit(benchmark::kMicrosecond);
+
+static void BM_FrameRenderer(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard board = randomBoard(size, 50);
+    FrameRenderer renderer(-1, static_cast<RenderMode>(state.range(1)));
+
+    // Frames are only built, writing them would measure the terminal instead.
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(renderer.buildFrame(board).data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_FrameRenderer)->ArgNames({"size", "mode"})
+    ->ArgsProduct({benchmark::CreateRange(64, 4096, 4), {static_cast<int>(RenderMode::Cells), static_cast<int>(RenderMode::HalfBlock), static_cast<int>(RenderMode::Braille)}})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_UpdatePattern(benchmark::State &state)
+{
+    int size = static_cast<int>(state.range(0));
+    LifeBoard current = patternBoard(size, static_cast<Pattern>(state.range(1)));
+    LifeBoard updated = current;
+
+    for(auto _ : state)
+    {
+        update(updated, current);
+        std::swap(updated, current);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(size) * size);
+}
+BENCHMARK(BM_UpdatePattern)->ArgNames({"size", "pattern"})
+    ->ArgsProduct({{256, 4096}, {Glider, Sink, Blinker, RPentominoSoup}})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,179 @@
+#include "LifeBoard.hpp"
+#include "BoardBuffers.hpp"
+#include "ThreadPool.hpp"
+#include "TiledStepper.hpp"
+#include "TemporalStepper.hpp"
+#include "PaddedStepper.hpp"
+#include "Checks.hpp"
+#include <atomic> // For counting allocations from every thread.
+#include <cstdlib> // For std::malloc and std::free.
+#include <iostream>
+#include <new> // For std::bad_alloc.
+#include <string>
+
+/**
+ * \file
+ * \brief Checks that stepping a board never allocates once the steppers have warmed up.
+ *
+ * The global operator new and operator delete are replaced with versions that count every 
+ * allocation, from any thread. Each way of stepping the board is run once to warm up and then 
+ * for checkedSteps generations, which must not allocate at all. Run through `make check`, which 
+ * fails if any of them does.
+ */
+
+namespace
+{
+    /// Number of allocations made through operator new since the program started.
+    std::atomic<long> allocationCount{0};
+
+    /// Number of generations each stepper is checked over after its warm up.
+    constexpr int checkedSteps = 50;
+
+    /// Number of rows and columns of the boards, not a multiple of 64 so the rows have padding bits.
+    constexpr int boardSize = 300;
+
+    /// Number of checks that allocated.
+    int failures = 0;
+
+    /**
+     *\brief Allocates memory, counting the allocation.
+     *\param size number of bytes to allocate.
+     *\return pointer to the memory.
+     */
+    void* countedAllocate(std::size_t size)
+    {
+        ++allocationCount;
+        void *memory = std::malloc(size != 0 ? size : 1);
+        if(memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return memory;
+    }
+
+    /**
+     *\brief Runs a step once to warm up, then checks it does not allocate over checkedSteps steps.
+     *\param name std::string naming the step in the report.
+     *\param step callable that advances the board one step.
+     */
+    template<typename Step>
+    void checkStep(const std::string &name, const Step &step)
+    {
+        step();
+        long before = allocationCount;
+        for(int count = 0; count < checkedSteps; ++count)
+        {
+            step();
+        }
+        long allocations = allocationCount - before;
+
+        std::cout << (allocations == 0 ? "ok    " : "FAIL  ") << name << ": " << allocations << " allocations in " << checkedSteps << " steps\n";
+        if(allocations != 0)
+        {
+            ++failures;
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+int checkAllocations()
+{
+    for(int threads : {1, 3})
+    {
+        ThreadPool pool(threads);
+        std::string suffix = " (" + std::to_string(threads) + (threads == 1 ? " thread)" : " threads)");
+
+        LifeBoard initial(boardSize, boardSize, LifeBoard::Dead);
+        initial.randomise(5, 0.4, pool);
+        BoardBuffers buffers(initial, 0, pool);
+        LifeBoard &current = buffers.current();
+        LifeBoard &next = buffers.next();
+
+        checkStep("flip" + suffix, [&]()
+        {
+            buffers.flip();
+        });
+
+        checkStep("update" + suffix, [&]()
+        {
+            update(next, current, pool);
+            buffers.flip();
+        });
+
+        current.setStatisticsTracking(true);
+        current.setHashTracking(true);
+        checkStep("update with statistics and hash" + suffix, [&]()
+        {
+            update(next, current, pool);
+            buffers.flip();
+        });
+        current.setStatisticsTracking(false);
+        current.setHashTracking(false);
+
+        checkStep("update<DeadEdge>" + suffix, [&]()
+        {
+            update<DeadEdge>(next, current);
+            buffers.flip();
+        });
+
+        TiledStepper tiledStepper(boardSize, boardSize);
+        checkStep("TiledStepper" + suffix, [&]()
+        {
+            tiledStepper.step(next, current);
+            buffers.flip();
+        });
+
+        TemporalStepper temporalStepper;
+        checkStep("TemporalStepper" + suffix, [&]()
+        {
+            temporalStepper.step(next, current, 4, pool);
+            buffers.flip();
+        });
+
+        PaddedStepper paddedStepper;
+        paddedStepper.setBoard(current);
+        checkStep("PaddedStepper" + suffix, [&]()
+        {
+            paddedStepper.step(pool);
+            paddedStepper.copyToBoard(next);
+            buffers.flip();
+        });
+    }
+
+    if(failures != 0)
+    {
+        std::cout << failures << " steppers allocated.\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,89 @@
+#include "LifeBoard.hpp"
+#include "PatternCensus.hpp"
+#include "ThreadPool.hpp"
+#include "Checks.hpp"
+#include <iostream>
+#include <string>
+#include <vector> // For the cells of the objects.
+#include <utility> // For std::pair.
+
+/**
+ * \file
+ * \brief Checks that the census names a lone object in every phase, wherever it lies.
+ *
+ * Each object is placed alone on a torus, in the middle and across the corner so it wraps round
+ * both edges, and stepped through its period. Every phase must be counted as one object under
+ * the object's name, including the phases of the toad and the beacon that fall apart into two
+ * pieces.
+ */
+
+namespace
+{
+    /// Number of rows and columns of the boards, not a multiple of 64 so the rows have padding bits.
+    constexpr int boardSize = 40;
+
+    /**
+     * \struct CheckedObject
+     * \brief An object the census is checked on.
+     */
+    struct CheckedObject
+    {
+        /// Name the census should give the object.
+        const char *name;
+
+        /// Number of generations before the object returns to its first phase.
+        int period;
+
+        /// Live cells of the first phase.
+        std::vector<std::pair<int,int>> cells;
+    };
+}
+
+int checkCensus()
+{
+    const std::vector<CheckedObject> objects =
+    {
+        {"blinker", 2, {{0, 0}, {0, 1}, {0, 2}}},
+        {"toad",    2, {{0, 1}, {0, 2}, {0, 3}, {1, 0}, {1, 1}, {1, 2}}},
+        {"beacon",  2, {{0, 0}, {0, 1}, {1, 0}, {1, 1}, {2, 2}, {2, 3}, {3, 2}, {3, 3}}},
+        {"glider",  4, {{0, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}}}
+    };
+    const std::pair<int,int> offsets[] = {{boardSize / 2, boardSize / 2}, {-1, -2}};
+
+    int failures = 0;
+    for(int threads : {1, 3})
+    {
+        ThreadPool pool(threads);
+        PatternCensus census;
+        for(const CheckedObject &object : objects)
+        {
+            for(const std::pair<int,int> &offset : offsets)
+            {
+                LifeBoard current(boardSize, boardSize, LifeBoard::Dead);
+                LifeBoard next(boardSize, boardSize, LifeBoard::Dead);
+                for(const std::pair<int,int> &cell : object.cells)
+                {
+                    current(offset.first + cell.first, offset.second + cell.second) = LifeBoard::Alive;
+                }
+
+                for(int phase = 0; phase < object.period; ++phase)
+                {
+                    const std::vector<CensusEntry> &entries = census.count(current, true, pool);
+                    bool named = census.getObjectCount() == 1 && entries.size() == 1 && entries[0].name == object.name;
+                    std::cout << (named ? "ok    " : "FAIL  ") << object.name << " phase " << phase << " at " << offset.first << ',' << offset.second
+                              << " (" << threads << (threads == 1 ? " thread)" : " threads)") << ": " << (entries.empty() ? std::string("nothing") : entries[0].name)
+                              << ", " << census.getObjectCount() << " objects\n";
+                    if(!named)
+                    {
+                        ++failures;
+                    }
+
+                    update(next, current, pool);
+                    std::swap(current, next);
+                }
+            }
+        }
+    }
+
+    return failures;
+}
@@ -0,0 +1,19 @@
+#include "Checks.hpp"
+#include <iostream>
+
+/**
+ * \file
+ * \brief Runs every check, failing if any of them does.
+ */
+
+int main()
+{
+    int failures = checkAllocations() + checkCensus();
+    if(failures != 0)
+    {
+        std::cout << failures << " checks failed.\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef Checks_hpp
+#define Checks_hpp
+
+/**
+ * \file
+ * \brief Checks run by `make check`, each returning the number of its checks that failed.
+ */
+
+/**
+ *\brief Checks that stepping a board never allocates once the steppers have warmed up.
+ *\return number of steppers that allocated.
+ */
+int checkAllocations();
+
+/**
+ *\brief Checks that the census names lone objects in every one of their phases.
+ *\return number of phases that were not counted as a single object under their name.
+ */
+int checkCensus();
+
+#endif /* Checks_hpp */
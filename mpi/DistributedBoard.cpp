@@ -0,0 +1,408 @@
+#include "DistributedBoard.hpp"
+#include "EvolveKernels.hpp"
+#include <stdexcept> // For reporting boards too small for the grid of ranks.
+#include <algorithm> // For std::swap.
+
+namespace
+{
+    /**
+     * \enum Direction
+     * \brief Enumeration type to identify the neighbours of a block, the value is also the tag of messages travelling that way.
+     */
+    enum Direction
+    {
+        Up,
+        Down,
+        Left,
+        Right,
+        UpLeft,
+        UpRight,
+        DownLeft,
+        DownRight,
+    };
+
+    /**
+     *\brief Gets the direction opposite to another, which messages arriving from a neighbour travel in.
+     *\param direction Direction to reverse.
+     *\return the opposite Direction.
+     */
+    int opposite(int direction)
+    {
+        return (direction < UpLeft) ? (direction ^ 1) : (UpLeft + DownRight - direction);
+    }
+
+    /**
+     *\brief Reads one cell of a packed row.
+     *\param row words of the row.
+     *\param col column of the cell.
+     *\return the cell, 1 if it is alive and 0 if it is dead.
+     */
+    LifeBoard::Word getBit(const LifeBoard::Word *row, int col)
+    {
+        return (row[col / LifeBoard::cellsPerWord] >> (col % LifeBoard::cellsPerWord)) & 1;
+    }
+
+    /**
+     *\brief Writes one cell of a packed row.
+     *\param row words of the row.
+     *\param col column of the cell.
+     *\param bit the cell, 1 if it is alive and 0 if it is dead.
+     */
+    void setBit(LifeBoard::Word *row, int col, LifeBoard::Word bit)
+    {
+        LifeBoard::Word mask = LifeBoard::Word(1) << (col % LifeBoard::cellsPerWord);
+        row[col / LifeBoard::cellsPerWord] = (row[col / LifeBoard::cellsPerWord] & ~mask) | (bit ? mask : 0);
+    }
+
+    /**
+     *\brief Copies a rectangle of cells from one board to another.
+     *\param from LifeBoard object to copy from.
+     *\param fromRow top row of the rectangle on from.
+     *\param fromCol left column of the rectangle on from.
+     *\param to LifeBoard object to copy to.
+     *\param toRow top row of the rectangle on to.
+     *\param toCol left column of the rectangle on to.
+     *\param rows number of rows in the rectangle.
+     *\param cols number of columns in the rectangle.
+     */
+    void copyCells(const LifeBoard &from, int fromRow, int fromCol, LifeBoard &to, int toRow, int toCol, int rows, int cols)
+    {
+        for(int row = 0; row < rows; ++row)
+        {
+            const LifeBoard::Word *source = from.rowData(fromRow + row);
+            LifeBoard::Word *destination  = to.rowData(toRow + row);
+            for(int col = 0; col < cols; ++col)
+            {
+                setBit(destination, toCol + col, getBit(source, fromCol + col));
+            }
+        }
+    }
+
+    /**
+     *\brief Adds up the live cells of a block and their coordinates on the whole board.
+     *\param block LifeBoard object holding the block with its ghost cells.
+     *\param rowBegin first row of the whole board in the block.
+     *\param colBegin first column of the whole board in the block.
+     *\param sums array the population, the sum of the rows and the sum of the columns are written to.
+     */
+    void sumBlock(const LifeBoard &block, int rowBegin, int colBegin, long long sums[3])
+    {
+        // Masks of the bits whose index within the word has each bit set, so the sum of the
+        // indices of the set bits of a word is the sum of the counts under each mask times 2^bit.
+        static const LifeBoard::Word indexMasks[6] =
+        {
+            0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+            0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL,
+        };
+
+        int localRows = block.getRows() - 2;
+        int localCols = block.getCols() - 2;
+        int words = block.getWordsPerRow();
+
+        sums[0] = sums[1] = sums[2] = 0;
+        for(int row = 1; row <= localRows; ++row)
+        {
+            const LifeBoard::Word *data = block.rowData(row);
+
+            // The ghost cells at either end of the row are not part of the block.
+            long long population = -static_cast<long long>(getBit(data, 0) + getBit(data, localCols + 1));
+            long long colSum = -static_cast<long long>(getBit(data, localCols + 1)) * (localCols + 1);
+            for(int word = 0; word < words; ++word)
+            {
+                long long count = __builtin_popcountll(data[word]);
+                population += count;
+                colSum += count * word * LifeBoard::cellsPerWord;
+                for(int bit = 0; bit < 6; ++bit)
+                {
+                    colSum += static_cast<long long>(__builtin_popcountll(data[word] & indexMasks[bit])) << bit;
+                }
+            }
+
+            // Column c of the block is column c+1 of the row.
+            sums[0] += population;
+            sums[1] += population * (rowBegin + row - 1);
+            sums[2] += colSum + population * (colBegin - 1);
+        }
+    }
+}
+
+DistributedBoard::DistributedBoard(MPI_Comm comm, int rows, int cols) :
+m_rowCount{rows},
+m_colCount{cols},
+m_current(1, 1, LifeBoard::Dead),
+m_updated(1, 1, LifeBoard::Dead)
+{
+    // Arrange the ranks in as square a periodic grid as possible.
+    int size;
+    MPI_Comm_size(comm, &size);
+    m_dims[0] = m_dims[1] = 0;
+    MPI_Dims_create(size, 2, m_dims);
+    if(rows < m_dims[0] || cols < m_dims[1])
+    {
+        throw std::invalid_argument("The board is too small to split between the ranks.");
+    }
+
+    int periods[2] = {1, 1};
+    MPI_Cart_create(comm, 2, m_dims, periods, 0, &m_comm);
+    MPI_Comm_rank(m_comm, &m_rank);
+    MPI_Cart_coords(m_comm, m_rank, 2, m_coords);
+    blockOf(m_rank, m_rowBegin, m_localRows, m_colBegin, m_localCols);
+
+    // Find the ranks of the eight neighbours, wrapping round the grid.
+    const int offsets[8][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+    for(int direction = 0; direction < 8; ++direction)
+    {
+        int coords[2] =
+        {
+            (m_coords[0] + offsets[direction][0] + m_dims[0]) % m_dims[0],
+            (m_coords[1] + offsets[direction][1] + m_dims[1]) % m_dims[1],
+        };
+        MPI_Cart_rank(m_comm, coords, &m_neighbours[direction]);
+    }
+
+    m_current = LifeBoard(m_localRows + 2, m_localCols + 2, LifeBoard::Dead);
+    m_updated = m_current;
+
+    int columnWords = (m_localRows + LifeBoard::cellsPerWord - 1) / LifeBoard::cellsPerWord;
+    for(int side = 0; side < 2; ++side)
+    {
+        m_sendColumns[side].assign(columnWords, 0);
+        m_receiveColumns[side].assign(columnWords, 0);
+    }
+}
+
+DistributedBoard::~DistributedBoard()
+{
+    MPI_Comm_free(&m_comm);
+}
+
+void DistributedBoard::blockOf(int rank, int &rowBegin, int &rows, int &colBegin, int &cols) const
+{
+    int coords[2];
+    MPI_Cart_coords(m_comm, rank, 2, coords);
+
+    // Split the rows and columns as evenly as possible between the ranks.
+    rowBegin = static_cast<int>(static_cast<long long>(m_rowCount) * coords[0] / m_dims[0]);
+    rows     = static_cast<int>(static_cast<long long>(m_rowCount) * (coords[0] + 1) / m_dims[0]) - rowBegin;
+    colBegin = static_cast<int>(static_cast<long long>(m_colCount) * coords[1] / m_dims[1]);
+    cols     = static_cast<int>(static_cast<long long>(m_colCount) * (coords[1] + 1) / m_dims[1]) - colBegin;
+}
+
+void DistributedBoard::scatter(const LifeBoard &board, int root)
+{
+    if(m_rank != root)
+    {
+        MPI_Recv(m_current.rowData(0), (m_localRows + 2) * m_current.getWordsPerRow(), MPI_UINT64_T, root, 0, m_comm, MPI_STATUS_IGNORE);
+        return;
+    }
+
+    int size;
+    MPI_Comm_size(m_comm, &size);
+    for(int rank = 0; rank < size; ++rank)
+    {
+        int rowBegin, rows, colBegin, cols;
+        blockOf(rank, rowBegin, rows, colBegin, cols);
+        if(rank == m_rank)
+        {
+            copyCells(board, rowBegin, colBegin, m_current, 1, 1, rows, cols);
+        }
+        else
+        {
+            LifeBoard block(rows + 2, cols + 2, LifeBoard::Dead);
+            copyCells(board, rowBegin, colBegin, block, 1, 1, rows, cols);
+            MPI_Send(block.rowData(0), (rows + 2) * block.getWordsPerRow(), MPI_UINT64_T, rank, 0, m_comm);
+        }
+    }
+}
+
+void DistributedBoard::randomise(std::uint64_t seed, double density)
+{
+    int boardWords = (m_colCount + LifeBoard::cellsPerWord - 1) / LifeBoard::cellsPerWord;
+    int firstWord  = m_colBegin / LifeBoard::cellsPerWord;
+    int lastWord   = (m_colBegin + m_localCols - 1) / LifeBoard::cellsPerWord;
+    std::vector<LifeBoard::Word> words(lastWord - firstWord + 1);
+
+    for(int row = 0; row < m_localRows; ++row)
+    {
+        std::uint64_t index = static_cast<std::uint64_t>(m_rowBegin + row) * boardWords;
+        for(int word = firstWord; word <= lastWord; ++word)
+        {
+            words[word - firstWord] = LifeBoard::randomWord(seed, index + word, density);
+        }
+
+        LifeBoard::Word *data = m_current.rowData(row + 1);
+        for(int col = 0; col < m_localCols; ++col)
+        {
+            setBit(data, col + 1, getBit(words.data(), m_colBegin + col - firstWord * LifeBoard::cellsPerWord));
+        }
+    }
+}
+
+void DistributedBoard::gather(LifeBoard &board, int root)
+{
+    if(m_rank != root)
+    {
+        const LifeBoard &current = m_current;
+        MPI_Send(current.rowData(0), (m_localRows + 2) * current.getWordsPerRow(), MPI_UINT64_T, root, 0, m_comm);
+        return;
+    }
+
+    int size;
+    MPI_Comm_size(m_comm, &size);
+    for(int rank = 0; rank < size; ++rank)
+    {
+        int rowBegin, rows, colBegin, cols;
+        blockOf(rank, rowBegin, rows, colBegin, cols);
+        if(rank == m_rank)
+        {
+            copyCells(m_current, 1, 1, board, rowBegin, colBegin, rows, cols);
+        }
+        else
+        {
+            LifeBoard block(rows + 2, cols + 2, LifeBoard::Dead);
+            MPI_Recv(block.rowData(0), (rows + 2) * block.getWordsPerRow(), MPI_UINT64_T, rank, 0, m_comm, MPI_STATUS_IGNORE);
+            copyCells(block, 1, 1, board, rowBegin, colBegin, rows, cols);
+        }
+    }
+}
+
+void DistributedBoard::startHaloExchange()
+{
+    int words = m_current.getWordsPerRow();
+    int columnWords = static_cast<int>(m_sendColumns[0].size());
+    const LifeBoard &current = m_current;
+
+    // Pack the edge columns, the edge rows are sent straight from the block.
+    std::fill(m_sendColumns[0].begin(), m_sendColumns[0].end(), 0);
+    std::fill(m_sendColumns[1].begin(), m_sendColumns[1].end(), 0);
+    for(int row = 0; row < m_localRows; ++row)
+    {
+        const LifeBoard::Word *data = current.rowData(row + 1);
+        m_sendColumns[0][row / LifeBoard::cellsPerWord] |= getBit(data, 1) << (row % LifeBoard::cellsPerWord);
+        m_sendColumns[1][row / LifeBoard::cellsPerWord] |= getBit(data, m_localCols) << (row % LifeBoard::cellsPerWord);
+    }
+    m_sendCorners[UpLeft - UpLeft]    = getBit(current.rowData(1), 1);
+    m_sendCorners[UpRight - UpLeft]   = getBit(current.rowData(1), m_localCols);
+    m_sendCorners[DownLeft - UpLeft]  = getBit(current.rowData(m_localRows), 1);
+    m_sendCorners[DownRight - UpLeft] = getBit(current.rowData(m_localRows), m_localCols);
+
+    // Each ghost cell arrives from the neighbour in its direction, in a message travelling the opposite way.
+    MPI_Irecv(m_current.rowData(0), words, MPI_UINT64_T, m_neighbours[Up], opposite(Up), m_comm, &m_requests[Up]);
+    MPI_Irecv(m_current.rowData(m_localRows + 1), words, MPI_UINT64_T, m_neighbours[Down], opposite(Down), m_comm, &m_requests[Down]);
+    MPI_Irecv(m_receiveColumns[0].data(), columnWords, MPI_UINT64_T, m_neighbours[Left], opposite(Left), m_comm, &m_requests[Left]);
+    MPI_Irecv(m_receiveColumns[1].data(), columnWords, MPI_UINT64_T, m_neighbours[Right], opposite(Right), m_comm, &m_requests[Right]);
+    for(int corner = UpLeft; corner <= DownRight; ++corner)
+    {
+        MPI_Irecv(&m_receiveCorners[corner - UpLeft], 1, MPI_UINT64_T, m_neighbours[corner], opposite(corner), m_comm, &m_requests[corner]);
+    }
+
+    MPI_Isend(current.rowData(1), words, MPI_UINT64_T, m_neighbours[Up], Up, m_comm, &m_requests[8 + Up]);
+    MPI_Isend(current.rowData(m_localRows), words, MPI_UINT64_T, m_neighbours[Down], Down, m_comm, &m_requests[8 + Down]);
+    MPI_Isend(m_sendColumns[0].data(), columnWords, MPI_UINT64_T, m_neighbours[Left], Left, m_comm, &m_requests[8 + Left]);
+    MPI_Isend(m_sendColumns[1].data(), columnWords, MPI_UINT64_T, m_neighbours[Right], Right, m_comm, &m_requests[8 + Right]);
+    for(int corner = UpLeft; corner <= DownRight; ++corner)
+    {
+        MPI_Isend(&m_sendCorners[corner - UpLeft], 1, MPI_UINT64_T, m_neighbours[corner], corner, m_comm, &m_requests[8 + corner]);
+    }
+}
+
+void DistributedBoard::finishHaloExchange()
+{
+    MPI_Waitall(16, m_requests, MPI_STATUSES_IGNORE);
+
+    // The ghost rows arrived whole but their ends are the sender's stale ghost cells, so the
+    // corners are written after them.
+    for(int row = 0; row < m_localRows; ++row)
+    {
+        LifeBoard::Word *data = m_current.rowData(row + 1);
+        setBit(data, 0, (m_receiveColumns[0][row / LifeBoard::cellsPerWord] >> (row % LifeBoard::cellsPerWord)) & 1);
+        setBit(data, m_localCols + 1, (m_receiveColumns[1][row / LifeBoard::cellsPerWord] >> (row % LifeBoard::cellsPerWord)) & 1);
+    }
+    setBit(m_current.rowData(0), 0, m_receiveCorners[UpLeft - UpLeft]);
+    setBit(m_current.rowData(0), m_localCols + 1, m_receiveCorners[UpRight - UpLeft]);
+    setBit(m_current.rowData(m_localRows + 1), 0, m_receiveCorners[DownLeft - UpLeft]);
+    setBit(m_current.rowData(m_localRows + 1), m_localCols + 1, m_receiveCorners[DownRight - UpLeft]);
+}
+
+void DistributedBoard::step()
+{
+    // The ghost cells hold the neighbouring blocks so the block is evolved as if its edges were
+    // dead, the ghost cells of the result are wrong but they are overwritten before being read.
+    RowKernel evolveRow = getRowKernel<DeadEdge>(activeKernel());
+    int words = m_current.getWordsPerRow();
+    int cols = m_current.getCols();
+    LifeBoard::Word lastMask = m_current.lastWordMask();
+    const LifeBoard &current = m_current;
+
+    startHaloExchange();
+
+    // Rows away from the top and bottom edges only need the ghost columns for their end words.
+    for(int row = 2; row < m_localRows; ++row)
+    {
+        evolveRow(current.rowData(row - 1), current.rowData(row), current.rowData(row + 1), m_updated.rowData(row), words, cols, lastMask, 0, words);
+    }
+
+    finishHaloExchange();
+
+    int lastWord = m_localCols / LifeBoard::cellsPerWord;
+    for(int row = 1; row <= m_localRows; ++row)
+    {
+        bool edgeRow = (row == 1 || row == m_localRows);
+        const LifeBoard::Word *above = current.rowData(row - 1);
+        const LifeBoard::Word *middle = current.rowData(row);
+        const LifeBoard::Word *below = current.rowData(row + 1);
+        LifeBoard::Word *out = m_updated.rowData(row);
+        if(edgeRow || lastWord == 0)
+        {
+            evolveRow(above, middle, below, out, words, cols, lastMask, 0, words);
+        }
+        else
+        {
+            evolveRow(above, middle, below, out, words, cols, lastMask, 0, 1);
+            evolveRow(above, middle, below, out, words, cols, lastMask, lastWord, words);
+        }
+    }
+
+    std::swap(m_current, m_updated);
+}
+
+long long DistributedBoard::getPopulation() const
+{
+    long long local[3];
+    sumBlock(m_current, m_rowBegin, m_colBegin, local);
+
+    long long population;
+    MPI_Allreduce(&local[0], &population, 1, MPI_LONG_LONG, MPI_SUM, m_comm);
+    return population;
+}
+
+std::pair<double,double> DistributedBoard::centreOfMass() const
+{
+    long long local[3];
+    long long global[3];
+    sumBlock(m_current, m_rowBegin, m_colBegin, local);
+    MPI_Allreduce(local, global, 3, MPI_LONG_LONG, MPI_SUM, m_comm);
+
+    double population = static_cast<double>(global[0]);
+    return std::pair<double,double>(global[1] / population, global[2] / population);
+}
+
+int DistributedBoard::getRows() const
+{
+    return m_rowCount;
+}
+
+int DistributedBoard::getCols() const
+{
+    return m_colCount;
+}
+
+int DistributedBoard::getProcessRows() const
+{
+    return m_dims[0];
+}
+
+int DistributedBoard::getProcessCols() const
+{
+    return m_dims[1];
+}
@@ -0,0 +1,189 @@
+#ifndef DistributedBoard_hpp
+#define DistributedBoard_hpp
+
+#include <mpi.h> // For the communicator the board is spread over.
+#include <vector> // For the halo buffers.
+#include <utility> // For std::pair.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+
+/**
+ * \file
+ * \brief Class to model a toroidal board split into 2D blocks across MPI ranks.
+ *
+ * The ranks are arranged in a periodic grid and each one owns a block of the board, which it
+ * stores with a ghost cell on every side so its cells can be evolved by the same row kernels as
+ * update(). Every generation each rank sends its edge rows, edge columns and corner cells to
+ * its eight neighbours. While those messages are in flight it evolves the cells that do not
+ * depend on them, then finishes the cells next to the ghost cells once they have arrived.
+ *
+ * The blocks are evolved exactly as the whole board would be, so the boards gathered onto one
+ * rank match a single process run of update() generation for generation.
+ */
+class DistributedBoard
+{
+private:
+    /// Member variable that holds the periodic grid of ranks the board is spread over.
+    MPI_Comm m_comm;
+
+    /// Member variable that holds the rank of this process in m_comm.
+    int m_rank;
+
+    /// Member variable that holds the number of rows and columns of ranks.
+    int m_dims[2];
+
+    /// Member variable that holds the row and column of this rank in the grid.
+    int m_coords[2];
+
+    /// Member variable that holds the number of rows of the whole board.
+    int m_rowCount;
+
+    /// Member variable that holds the number of columns of the whole board.
+    int m_colCount;
+
+    /// Member variable that holds the first row of the whole board in this block.
+    int m_rowBegin;
+
+    /// Member variable that holds the number of rows in this block.
+    int m_localRows;
+
+    /// Member variable that holds the first column of the whole board in this block.
+    int m_colBegin;
+
+    /// Member variable that holds the number of columns in this block.
+    int m_localCols;
+
+    /// Member variable that holds the ranks of the neighbours, indexed by the Direction they lie in.
+    int m_neighbours[8];
+
+    /// Member variable that holds the block with its ghost cells, cell (row, col) of the block is at (row+1, col+1).
+    LifeBoard m_current;
+
+    /// Member variable that holds the block being written by the step.
+    LifeBoard m_updated;
+
+    /// Member variable that holds the packed edge columns being sent, left then right.
+    std::vector<LifeBoard::Word> m_sendColumns[2];
+
+    /// Member variable that holds the packed ghost columns being received, left then right.
+    std::vector<LifeBoard::Word> m_receiveColumns[2];
+
+    /// Member variable that holds the corner cells being sent, indexed by Direction minus 4.
+    LifeBoard::Word m_sendCorners[4];
+
+    /// Member variable that holds the ghost corner cells being received, indexed by Direction minus 4.
+    LifeBoard::Word m_receiveCorners[4];
+
+    /// Member variable that holds the outstanding sends and receives of the halo exchange.
+    MPI_Request m_requests[16];
+
+    /**
+     *\brief Sends this block's edges to its neighbours and starts receiving the ghost cells.
+     */
+    void startHaloExchange();
+
+    /**
+     *\brief Waits for the halo exchange and copies the ghost columns and corners into the block.
+     */
+    void finishHaloExchange();
+
+    /**
+     *\brief Finds the rows and columns of the whole board held by a rank.
+     *\param rank rank in the grid communicator.
+     *\param rowBegin first row of the block, set by the function.
+     *\param rows number of rows in the block, set by the function.
+     *\param colBegin first column of the block, set by the function.
+     *\param cols number of columns in the block, set by the function.
+     */
+    void blockOf(int rank, int &rowBegin, int &rows, int &colBegin, int &cols) const;
+
+public:
+    /**
+     *\brief Constructor that spreads an all dead board over the ranks of a communicator.
+     *\param comm communicator holding every rank taking part, the grid of ranks is made from it.
+     *\param rows number of rows of the whole board, at least the number of rows of ranks.
+     *\param cols number of columns of the whole board, at least the number of columns of ranks.
+     */
+    DistributedBoard(MPI_Comm comm, int rows, int cols);
+
+    /**
+     *\brief Destructor that frees the grid communicator.
+     */
+    ~DistributedBoard();
+
+    DistributedBoard(const DistributedBoard&) = delete;
+    DistributedBoard& operator=(const DistributedBoard&) = delete;
+
+    /**
+     *\brief Copies a whole board from one rank into the blocks of every rank, collective.
+     *\param board LifeBoard object of the size of the whole board, only read on the root.
+     *\param root rank in the communicator passed to the constructor holding the board.
+     */
+    void scatter(const LifeBoard &board, int root = 0);
+
+    /**
+     *\brief Randomises the whole board from a seed, each rank filling its own block.
+     *
+     * The block is cut out of the words LifeBoard::randomWord() gives the whole board, so the 
+     * board is the same as LifeBoard::randomise() with the same seed and no rank holds more than 
+     * its block.
+     *
+     *\param seed seed the board is generated from.
+     *\param density probability of each cell being alive, between 0 and 1.
+     */
+    void randomise(std::uint64_t seed, double density = 0.5);
+
+    /**
+     *\brief Copies the blocks of every rank into a whole board on one rank, collective.
+     *\param board LifeBoard object of the size of the whole board, only written on the root.
+     *\param root rank in the communicator passed to the constructor receiving the board.
+     */
+    void gather(LifeBoard &board, int root = 0);
+
+    /**
+     *\brief Evolves the whole board by one generation with periodic boundary conditions, collective.
+     */
+    void step();
+
+    /**
+     *\brief Counts the live cells of the whole board, collective.
+     *\return Long integer value representing the population, on every rank.
+     */
+    long long getPopulation() const;
+
+    /**
+     *\brief Calculates the centre of mass of the live cells of the whole board, collective.
+     *
+     * The sums of the coordinates are reduced as integers so the result is identical to
+     * LifeBoard::centreOfMass() of the gathered board.
+     *
+     *\return pair of doubles representing the row and column of the centre of mass, on every rank.
+     */
+    std::pair<double,double> centreOfMass() const;
+
+    /**
+     *\brief Getter for the number of rows of the whole board.
+     *\return Integer value holding the number of rows.
+     */
+    int getRows() const;
+
+    /**
+     *\brief Getter for the number of columns of the whole board.
+     *\return Integer value holding the number of columns.
+     */
+    int getCols() const;
+
+    /**
+     *\brief Getter for the number of rows of ranks in the grid.
+     *\return Integer value holding the number of rows of ranks.
+     */
+    int getProcessRows() const;
+
+    /**
+     *\brief Getter for the number of columns of ranks in the grid.
+     *\return Integer value holding the number of columns of ranks.
+     */
+    int getProcessCols() const;
+};
+
+#endif /* DistributedBoard_hpp */
@@ -0,0 +1,221 @@
+#include "DistributedBoard.hpp"
+#include "LifeBoard.hpp"
+#include "EvolveKernels.hpp"
+#include "Rule.hpp"
+#include "PatternIO.hpp"
+#include <mpi.h>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <boost/program_options.hpp>
+
+namespace
+{
+    /**
+     *\brief Runs the distributed simulation, split out of main() so every object is destroyed before MPI_Finalize.
+     *\param argc number of command line arguments.
+     *\param argv command line arguments.
+     *\param rank rank of this process in MPI_COMM_WORLD.
+     *\return the exit status of the program, the same on every rank.
+     */
+    int run(int argc, char const *argv[], int rank)
+    {
+        // By default seed the pseudo random number generator using the system clock.
+        unsigned int seed = static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count());
+
+        // Input parameters.
+        int rowCount;
+        int colCount;
+        long long generations;
+        int outputFrequency;
+        std::string rule;
+        std::string patternFile;
+        double density;
+
+        boost::program_options::options_description desc("Options for the distributed Game of Life program, run with mpirun -np N");
+        desc.add_options()
+            ("column-count,c", boost::program_options::value<int>(&rowCount)->default_value(50), "The number of rows in the board.")
+            ("row-count,r", boost::program_options::value<int>(&colCount)->default_value(50), "The number of columns in the board.")
+            ("generations,g", boost::program_options::value<long long>(&generations)->default_value(1000), "The number of generations to run.")
+            ("output-frequency,f", boost::program_options::value<int>(&outputFrequency)->default_value(0), "Report the population and centre of mass every this many generations, 0 to only report them at the end.")
+            ("rule", boost::program_options::value<std::string>(&rule)->default_value("B3/S23"), "The Life-like rule in B/S notation, for example B36/S23 for HighLife.")
+            ("seed,s", boost::program_options::value<unsigned int>(&seed), "The seed for the random initial board, taken from the clock if not given.")
+            ("density", boost::program_options::value<double>(&density)->default_value(0.5), "The probability of each cell of the random initial board being alive.")
+            ("pattern,p", boost::program_options::value<std::string>(&patternFile), "Initialise with a pattern file (.rle, .lif, .life or .cells), its rule is used unless --rule is given.")
+            ("verify", "Also run the board on rank 0 alone with update() and check the two runs finish identically.")
+            ("help,h", "Produce help message");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(boost::program_options::parse_command_line(argc,argv,desc), vm);
+        boost::program_options::notify(vm);
+
+        if(vm.count("help"))
+        {
+            if(rank == 0)
+            {
+                std::cout << desc << '\n';
+            }
+            return 1;
+        }
+
+        // Every rank must start from the same seed and rule, so rank 0 decides them.
+        MPI_Bcast(&seed, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+        try
+        {
+            setActiveRule(Rule(rule));
+        }
+        catch(const std::invalid_argument &error)
+        {
+            if(rank == 0)
+            {
+                std::cerr << error.what() << '\n';
+            }
+            return 1;
+        }
+
+        // Only rank 0 holds the whole board, to load a pattern and check the result.
+        bool wholeBoard = rank == 0 && (vm.count("pattern") || vm.count("verify"));
+        LifeBoard board(wholeBoard ? rowCount : 1, wholeBoard ? colCount : 1, LifeBoard::Dead);
+        int status = 0;
+        if(rank == 0)
+        {
+            if(vm.count("pattern"))
+            {
+                std::ifstream patternInput(patternFile);
+                try
+                {
+                    if(!patternInput)
+                    {
+                        throw std::runtime_error("could not open the file");
+                    }
+                    PatternInfo info = readPattern(patternInput, patternFormatFromFileName(patternFile), board);
+                    if(!info.rule.empty() && vm["rule"].defaulted())
+                    {
+                        rule = info.rule;
+                        setActiveRule(Rule(rule));
+                    }
+                }
+                catch(const std::exception &error)
+                {
+                    std::cerr << "Could not read pattern file " << patternFile << ": " << error.what() << '\n';
+                    status = 1;
+                }
+            }
+        }
+
+        // The pattern file may have changed the rule on rank 0.
+        MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if(status != 0)
+        {
+            return status;
+        }
+        int ruleLength = static_cast<int>(rule.size());
+        MPI_Bcast(&ruleLength, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        rule.resize(ruleLength);
+        MPI_Bcast(&rule[0], ruleLength, MPI_CHAR, 0, MPI_COMM_WORLD);
+        setActiveRule(Rule(rule));
+
+        try
+        {
+            // A random board is generated by every rank for its own block, only a pattern goes through rank 0.
+            DistributedBoard distributed(MPI_COMM_WORLD, rowCount, colCount);
+            if(vm.count("pattern"))
+            {
+                distributed.scatter(board);
+            }
+            else
+            {
+                distributed.randomise(seed, density);
+                if(rank == 0 && vm.count("verify"))
+                {
+                    board.randomise(seed, density);
+                }
+            }
+
+            MPI_Barrier(MPI_COMM_WORLD);
+            auto start = std::chrono::steady_clock::now();
+
+            for(long long generation = 1; generation <= generations; ++generation)
+            {
+                distributed.step();
+                if(outputFrequency > 0 && generation % outputFrequency == 0)
+                {
+                    long long population = distributed.getPopulation();
+                    std::pair<double,double> centreOfMass = distributed.centreOfMass();
+                    if(rank == 0)
+                    {
+                        std::cout << generation << ' ' << population << ' ' << centreOfMass.first << ' ' << centreOfMass.second << '\n';
+                    }
+                }
+            }
+
+            MPI_Barrier(MPI_COMM_WORLD);
+            double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            long long population = distributed.getPopulation();
+            std::pair<double,double> centreOfMass = distributed.centreOfMass();
+
+            if(rank == 0)
+            {
+                double cells = static_cast<double>(rowCount) * colCount * generations;
+                std::cout << "Seed:              " << seed << '\n';
+                std::cout << "Board:             " << rowCount << 'x' << colCount << '\n';
+                std::cout << "Ranks:             " << distributed.getProcessRows() << 'x' << distributed.getProcessCols() << '\n';
+                std::cout << "Generations:       " << generations << '\n';
+                std::cout << "Wall time (s):     " << wallTime << '\n';
+                std::cout << "Cells/s:           " << cells / wallTime << '\n';
+                std::cout << "Final population:  " << population << '\n';
+                std::cout << "Centre of mass:    " << centreOfMass.first << ' ' << centreOfMass.second << '\n';
+            }
+
+            if(vm.count("verify"))
+            {
+                LifeBoard gathered(rank == 0 ? rowCount : 1, rank == 0 ? colCount : 1, LifeBoard::Dead);
+                distributed.gather(gathered);
+                if(rank == 0)
+                {
+                    // Run the same generations in this process for comparison.
+                    LifeBoard boardUpdated = board;
+                    for(long long generation = 0; generation < generations; ++generation)
+                    {
+                        update(boardUpdated, board);
+                        std::swap(boardUpdated, board);
+                    }
+
+                    const LifeBoard &expected = board;
+                    const LifeBoard &actual = gathered;
+                    bool identical = std::equal(expected.rowData(0), expected.rowData(0) + rowCount * expected.getWordsPerRow(), actual.rowData(0));
+                    identical = identical && expected.getPopulation() == population && (population == 0 || expected.centreOfMass() == centreOfMass);
+
+                    std::cout << "Verified:          " << (identical ? "identical to a single process run" : "DIFFERS from a single process run") << '\n';
+                    status = identical ? 0 : 1;
+                }
+                MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            }
+        }
+        catch(const std::invalid_argument &error)
+        {
+            if(rank == 0)
+            {
+                std::cerr << error.what() << '\n';
+            }
+            return 1;
+        }
+
+        return status;
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    MPI_Init(nullptr, nullptr);
+
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int status = run(argc, argv, rank);
+
+    MPI_Finalize();
+    return status;
+}
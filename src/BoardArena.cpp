@@ -0,0 +1,93 @@
+#include "BoardArena.hpp"
+#include "ThreadPool.hpp"
+#include <new> // For std::bad_alloc.
+#include <algorithm> // For std::fill and std::max.
+#include <cstdint> // For std::uintptr_t.
+#include <sys/mman.h> // For mmap, madvise and munmap.
+
+BoardArena::BoardArena(std::size_t bytes) :
+m_data{nullptr},
+m_capacity{(std::max<std::size_t>(bytes, 1) + hugePageBytes - 1) / hugePageBytes * hugePageBytes},
+m_used{0}
+{
+    // Map a huge page more than needed and trim the ends so the arena starts on a huge page.
+    std::size_t mapped = m_capacity + hugePageBytes;
+    void *memory = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(memory == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+
+    char *begin = static_cast<char*>(memory);
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(begin);
+    std::size_t lead = (hugePageBytes - address % hugePageBytes) % hugePageBytes;
+    if(lead > 0)
+    {
+        munmap(begin, lead);
+    }
+    munmap(begin + lead + m_capacity, hugePageBytes - lead);
+    m_data = begin + lead;
+
+    // Only a hint, the kernel falls back to normal pages if huge ones are disabled or unavailable.
+#ifdef MADV_HUGEPAGE
+    madvise(m_data, m_capacity, MADV_HUGEPAGE);
+#endif
+}
+
+BoardArena::~BoardArena()
+{
+    munmap(m_data, m_capacity);
+}
+
+std::size_t BoardArena::boardBytes(int rows, int cols)
+{
+    std::size_t words = static_cast<std::size_t>(rows) * ((cols + LifeBoard::cellsPerWord - 1) / LifeBoard::cellsPerWord);
+    return (words * sizeof(LifeBoard::Word) + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+}
+
+LifeBoard::Word* BoardArena::allocate(std::size_t words)
+{
+    // Anonymous mappings start zeroed and the arena never reuses memory, so nothing needs clearing.
+    std::size_t bytes = (words * sizeof(LifeBoard::Word) + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+    if(bytes > m_capacity - m_used)
+    {
+        throw std::bad_alloc();
+    }
+
+    LifeBoard::Word *storage = reinterpret_cast<LifeBoard::Word*>(m_data + m_used);
+    m_used += bytes;
+    return storage;
+}
+
+LifeBoard BoardArena::makeBoard(int rows, int cols)
+{
+    int words = (cols + LifeBoard::cellsPerWord - 1) / LifeBoard::cellsPerWord;
+    return LifeBoard(rows, cols, allocate(static_cast<std::size_t>(rows) * words));
+}
+
+LifeBoard BoardArena::makeBoard(int rows, int cols, ThreadPool &pool)
+{
+    int words = (cols + LifeBoard::cellsPerWord - 1) / LifeBoard::cellsPerWord;
+    LifeBoard::Word *storage = allocate(static_cast<std::size_t>(rows) * words);
+
+    // Writing the zeros the memory already holds is what places each page near its worker.
+    int bands = pool.getThreadCount();
+    pool.run([&](int worker)
+    {
+        int beginRow = static_cast<int>(static_cast<long long>(rows) * worker / bands);
+        int endRow   = static_cast<int>(static_cast<long long>(rows) * (worker + 1) / bands);
+        std::fill(storage + static_cast<std::size_t>(beginRow) * words, storage + static_cast<std::size_t>(endRow) * words, LifeBoard::Word(0));
+    });
+
+    return LifeBoard(rows, cols, storage);
+}
+
+std::size_t BoardArena::getCapacity() const
+{
+    return m_capacity;
+}
+
+std::size_t BoardArena::getUsed() const
+{
+    return m_used;
+}
@@ -0,0 +1,102 @@
+#ifndef BoardArena_hpp
+#define BoardArena_hpp
+
+#include <cstddef> // For std::size_t.
+#include "LifeBoard.hpp"
+
+class ThreadPool;
+
+/**
+ * \file
+ * \brief Class to model a block of memory that boards are carved out of once and never freed separately.
+ *
+ * The arena maps all of its memory in one go, aligned to and rounded up to huge pages with the
+ * kernel asked to back it with them, so large boards take few TLB entries. Boards are handed out
+ * as views into the arena with a bump allocator and the memory is only given back when the arena
+ * is destroyed, so the arena must outlive every board made from it.
+ *
+ * Memory is placed on a NUMA node by the thread that first touches it, so the threaded version of
+ * makeBoard() has each worker zero the rows it will later update with update(), which splits the
+ * rows between the workers in the same way.
+ */
+class BoardArena
+{
+private:
+    /// Member variable that holds the start of the mapped memory.
+    char *m_data;
+
+    /// Member variable that holds the size of the mapped memory in bytes.
+    std::size_t m_capacity;
+
+    /// Member variable that holds the number of bytes handed out so far.
+    std::size_t m_used;
+
+public:
+    /// Size in bytes of the huge pages the arena is aligned to.
+    static constexpr std::size_t hugePageBytes = std::size_t(1) << 21;
+
+    /// Alignment in bytes of each allocation, a cache line so boards never share one.
+    static constexpr std::size_t alignmentBytes = 64;
+
+    /**
+     *\brief Constructor that maps the memory of the arena.
+     *\param bytes number of bytes the arena must be able to hand out, rounded up to whole huge pages.
+     *\throws std::bad_alloc if the memory cannot be mapped.
+     */
+    explicit BoardArena(std::size_t bytes);
+
+    /**
+     *\brief Destructor that unmaps the memory, invalidating every board made from the arena.
+     */
+    ~BoardArena();
+
+    BoardArena(const BoardArena&) = delete;
+    BoardArena& operator=(const BoardArena&) = delete;
+
+    /**
+     *\brief Works out the number of bytes makeBoard() takes for a board, alignment included.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     *\return number of bytes to reserve for the board.
+     */
+    static std::size_t boardBytes(int rows, int cols);
+
+    /**
+     *\brief Hands out words from the arena, aligned to a cache line and zeroed.
+     *\param words number of words needed.
+     *\return pointer to the first word.
+     *\throws std::bad_alloc if the arena does not have enough memory left.
+     */
+    LifeBoard::Word* allocate(std::size_t words);
+
+    /**
+     *\brief Makes a board of dead cells in the arena, its pages are placed by whoever touches them first.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     *\return LifeBoard view of the cells in the arena.
+     */
+    LifeBoard makeBoard(int rows, int cols);
+
+    /**
+     *\brief Makes a board of dead cells in the arena with each worker first touching the band of rows it updates.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     *\param pool ThreadPool reference, the rows are shared out between the workers as update() does.
+     *\return LifeBoard view of the cells in the arena.
+     */
+    LifeBoard makeBoard(int rows, int cols, ThreadPool &pool);
+
+    /**
+     *\brief Getter for the size of the arena.
+     *\return number of bytes the arena can hand out in total.
+     */
+    std::size_t getCapacity() const;
+
+    /**
+     *\brief Getter for the memory handed out.
+     *\return number of bytes handed out so far.
+     */
+    std::size_t getUsed() const;
+};
+
+#endif /* BoardArena_hpp */
@@ -0,0 +1,42 @@
+#include "BoardBuffers.hpp"
+#include "ThreadPool.hpp"
+#include <utility> // For std::swap.
+
+BoardBuffers::BoardBuffers(const LifeBoard &board, int scratchCount, ThreadPool &pool) :
+m_arena((2 + scratchCount) * BoardArena::boardBytes(board.getRows(), board.getCols()))
+{
+    m_boards.reserve(2 + scratchCount);
+    for(int index = 0; index < 2 + scratchCount; ++index)
+    {
+        m_boards.push_back(m_arena.makeBoard(board.getRows(), board.getCols(), pool));
+    }
+
+    // Assigning a board of the same dimensions copies into the views rather than replacing them.
+    m_boards[0] = board;
+    m_boards[1] = board;
+}
+
+LifeBoard& BoardBuffers::current()
+{
+    return m_boards[0];
+}
+
+LifeBoard& BoardBuffers::next()
+{
+    return m_boards[1];
+}
+
+LifeBoard& BoardBuffers::scratch(int index)
+{
+    return m_boards[2 + index];
+}
+
+int BoardBuffers::getScratchCount() const
+{
+    return static_cast<int>(m_boards.size()) - 2;
+}
+
+void BoardBuffers::flip()
+{
+    std::swap(m_boards[0], m_boards[1]);
+}
@@ -0,0 +1,72 @@
+#ifndef BoardBuffers_hpp
+#define BoardBuffers_hpp
+
+#include <vector> // For holding the boards.
+#include "LifeBoard.hpp"
+#include "BoardArena.hpp"
+
+class ThreadPool;
+
+/**
+ * \file
+ * \brief Class to model the boards a simulation steps between, all held in a single arena.
+ *
+ * Every generation is written from the current board into the next one and the two then swap
+ * roles. The buffers make the current, next and any scratch boards once, as views into one arena
+ * with each worker first touching the rows it updates, so that stepping from then on neither
+ * allocates nor moves cells around: flip() only exchanges the views and the references handed
+ * out by current() and next() keep referring to whichever board currently has that role.
+ */
+class BoardBuffers
+{
+private:
+    /// Member variable that holds the memory of all the boards.
+    BoardArena m_arena;
+
+    /// Member variable that holds the current board, the next board and then the scratch boards.
+    std::vector<LifeBoard> m_boards;
+
+public:
+    /**
+     *\brief Constructor that sets up the boards with the current and next boards copies of a board.
+     *\param board LifeBoard to start from, its tracking settings are copied too.
+     *\param scratchCount number of scratch boards of the same dimensions to set up, all dead.
+     *\param pool ThreadPool reference whose workers first touch the rows they update.
+     */
+    BoardBuffers(const LifeBoard &board, int scratchCount, ThreadPool &pool);
+
+    BoardBuffers(const BoardBuffers&) = delete;
+    BoardBuffers& operator=(const BoardBuffers&) = delete;
+
+    /**
+     *\brief Gives access to the board holding the current generation.
+     *\return reference to the current board.
+     */
+    LifeBoard& current();
+
+    /**
+     *\brief Gives access to the board the next generation is written to.
+     *\return reference to the next board.
+     */
+    LifeBoard& next();
+
+    /**
+     *\brief Gives access to a scratch board.
+     *\param index index of the scratch board in the range [0, getScratchCount()).
+     *\return reference to the scratch board.
+     */
+    LifeBoard& scratch(int index);
+
+    /**
+     *\brief Getter for the number of scratch boards.
+     *\return Integer value representing the number of scratch boards.
+     */
+    int getScratchCount() const;
+
+    /**
+     *\brief Makes the next board the current one and the current board the one written to next.
+     */
+    void flip();
+};
+
+#endif /* BoardBuffers_hpp */
@@ -0,0 +1,43 @@
+#ifndef BoardHash_hpp
+#define BoardHash_hpp
+
+#include <cstdint> // For fixed width integers.
+#include <cstddef> // For std::size_t.
+
+/**
+ * \file
+ * \brief Additive 64-bit hash of the packed words of a board.
+ *
+ * The hash of a board is the sum, modulo 2^64, of a mixed value for every non-zero word that 
+ * depends on the word and its position. Since it is a sum, bands of rows can be hashed separately 
+ * and added, and when only part of a board changes the hash can be updated by taking away the 
+ * contribution of the old words and adding that of the new ones. Dead words contribute nothing, so 
+ * an empty board hashes to 0.
+ */
+
+/**
+ *\brief Hashes a run of consecutive words of a board.
+ *\param index position of the first word in the board, row * words per row + word.
+ *\param words pointer to the first word.
+ *\param count number of words.
+ *\return the sum of the contributions of the words.
+ */
+inline std::uint64_t hashWords(std::size_t index, const std::uint64_t *words, int count)
+{
+    std::uint64_t hash = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        if(words[i] != 0)
+        {
+            // Finaliser of SplitMix64 applied to the word offset by its position.
+            std::uint64_t mixed = words[i] + (index + i + 1) * 0x9E3779B97F4A7C15ull;
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+            hash += mixed ^ (mixed >> 31);
+        }
+    }
+
+    return hash;
+}
+
+#endif /* BoardHash_hpp */
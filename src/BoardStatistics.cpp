@@ -0,0 +1,325 @@
+#include "BoardStatistics.hpp"
+#include <vector> // For the angle tables.
+#include <algorithm> // For std::min and std::max.
+#include <limits> // For std::numeric_limits.
+#include <cmath> // For std::cos, std::sin and std::atan2.
+
+namespace
+{
+    /// 2 pi, the angle of one whole turn round the board.
+    const double fullTurn = 2 * std::acos(-1.0);
+
+    /// Number of bit planes in the small column counters rows are first added to.
+    constexpr int rowPlaneCount = 4;
+
+    /**
+     * \struct AngleTables
+     * \brief Cosines and sines of coordinates taken as angles round a board of a given size.
+     */
+    struct AngleTables
+    {
+        int rows = -1;
+        int cols = -1;
+
+        /// Cosine and sine of each row.
+        std::vector<double> rowCos;
+        std::vector<double> rowSin;
+
+        /// Cosine and sine of each column.
+        std::vector<double> colCos;
+        std::vector<double> colSin;
+    };
+
+    /**
+     *\brief Fills the cosines and sines of the positions round a periodic dimension.
+     *\param size size of the dimension.
+     *\param cosines std::vector reference to fill with the cosines.
+     *\param sines std::vector reference to fill with the sines.
+     */
+    void fillAngles(int size, std::vector<double> &cosines, std::vector<double> &sines)
+    {
+        cosines.resize(size);
+        sines.resize(size);
+        for(int i = 0; i < size; ++i)
+        {
+            cosines[i] = std::cos(fullTurn * i / size);
+            sines[i]   = std::sin(fullTurn * i / size);
+        }
+    }
+
+    /**
+     *\brief Gets the angle tables for a board, building them if the size has changed.
+     *
+     * The tables are kept per thread so bands of a board can be added up in parallel.
+     *
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     *\return constant reference to the tables.
+     */
+    const AngleTables& angleTables(int rows, int cols)
+    {
+        thread_local AngleTables tables;
+        if(tables.rows != rows)
+        {
+            tables.rows = rows;
+            fillAngles(rows, tables.rowCos, tables.rowSin);
+        }
+        if(tables.cols != cols)
+        {
+            tables.cols = cols;
+            fillAngles(cols, tables.colCos, tables.colSin);
+        }
+
+        return tables;
+    }
+
+    /**
+     *\brief Counts the live cells of a row and adds them to the small column counters.
+     *\param words pointer to the packed words of the row.
+     *\param wordCount number of words in the row.
+     *\param rowPlanes pointer to the small column counters, rowPlaneCount words per word of the row.
+     *\return Long integer value holding the population of the row.
+     */
+    inline __attribute__((always_inline)) long long countRow(const std::uint64_t *words, int wordCount, std::uint64_t *rowPlanes)
+    {
+        long long population = 0;
+        for(int word = 0; word < wordCount; ++word)
+        {
+            std::uint64_t cells = words[word];
+            if(cells == 0)
+            {
+                continue;
+            }
+            population += __builtin_popcountll(cells);
+
+            // A chain of half adders, which cannot overflow before the counters are flushed.
+            std::uint64_t *planes = rowPlanes + static_cast<std::size_t>(word) * rowPlaneCount;
+            std::uint64_t carry0 = planes[0] & cells;
+            planes[0] ^= cells;
+            std::uint64_t carry1 = planes[1] & carry0;
+            planes[1] ^= carry0;
+            std::uint64_t carry2 = planes[2] & carry1;
+            planes[2] ^= carry1;
+            planes[3] ^= carry2;
+        }
+
+        return population;
+    }
+
+    /// Type of the countRow() builds for each instruction set.
+    typedef long long (*RowCounter)(const std::uint64_t *words, int wordCount, std::uint64_t *rowPlanes);
+
+    long long countRowGeneric(const std::uint64_t *words, int wordCount, std::uint64_t *rowPlanes)
+    {
+        return countRow(words, wordCount, rowPlanes);
+    }
+
+    __attribute__((target("popcnt")))
+    long long countRowPopcnt(const std::uint64_t *words, int wordCount, std::uint64_t *rowPlanes)
+    {
+        return countRow(words, wordCount, rowPlanes);
+    }
+
+    /**
+     *\brief Converts sums of cosines and sines back to a position round a periodic dimension.
+     *\param cosSum sum of the cosines.
+     *\param sinSum sum of the sines.
+     *\param size size of the dimension.
+     *\return position in [0, size).
+     */
+    double circularPosition(double cosSum, double sinSum, int size)
+    {
+        double angle = std::atan2(sinSum, cosSum);
+        if(angle < 0)
+        {
+            angle += fullTurn;
+        }
+
+        double position = angle * size / fullTurn;
+        return (position >= size) ? 0 : position;
+    }
+}
+
+BoardStatistics::BoardStatistics(int rows, int cols)
+{
+    reset(rows, cols);
+}
+
+void BoardStatistics::reset(int rows, int cols)
+{
+    m_rowCount    = rows;
+    m_colCount    = cols;
+    m_population  = 0;
+    m_rowSum      = 0;
+    m_colSum      = 0;
+    m_minRow      = std::numeric_limits<int>::max();
+    m_maxRow      = -1;
+    m_minCol      = std::numeric_limits<int>::max();
+    m_maxCol      = -1;
+    m_rowCos      = 0;
+    m_rowSin      = 0;
+    m_colCos      = 0;
+    m_colSin      = 0;
+    m_pendingRows = 0;
+    m_columnPlanes.clear();
+    m_rowPlanes.clear();
+
+    // Enough planes to count every row of a column.
+    m_planeCount = 1;
+    while((1LL << m_planeCount) <= rows)
+    {
+        ++m_planeCount;
+    }
+}
+
+void BoardStatistics::addRow(int row, const std::uint64_t *words, int wordCount)
+{
+    if(m_columnPlanes.empty())
+    {
+        m_columnPlanes.assign(static_cast<std::size_t>(wordCount) * m_planeCount, 0);
+        m_rowPlanes.assign(static_cast<std::size_t>(wordCount) * rowPlaneCount, 0);
+    }
+
+    // Use the popcount instruction when the CPU has it, the build targets CPUs without it.
+    static const RowCounter counter = __builtin_cpu_supports("popcnt") ? countRowPopcnt : countRowGeneric;
+    long long population = counter(words, wordCount, m_rowPlanes.data());
+
+    if(++m_pendingRows == (1 << rowPlaneCount) - 1)
+    {
+        flushRows();
+    }
+
+    if(population == 0)
+    {
+        return;
+    }
+
+    const AngleTables &tables = angleTables(m_rowCount, m_colCount);
+    m_population += population;
+    m_rowSum += static_cast<long long>(row) * population;
+    m_rowCos += tables.rowCos[row] * population;
+    m_rowSin += tables.rowSin[row] * population;
+    m_minRow = std::min(m_minRow, row);
+    m_maxRow = std::max(m_maxRow, row);
+}
+
+void BoardStatistics::flushRows()
+{
+    int wordCount = static_cast<int>(m_rowPlanes.size()) / rowPlaneCount;
+    for(int word = 0; word < wordCount; ++word)
+    {
+        std::uint64_t *pending = &m_rowPlanes[static_cast<std::size_t>(word) * rowPlaneCount];
+        std::uint64_t *planes = &m_columnPlanes[static_cast<std::size_t>(word) * m_planeCount];
+
+        // Ripple carry addition of the small counters into the full ones.
+        std::uint64_t carry = 0;
+        for(int plane = 0; plane < m_planeCount && (plane < rowPlaneCount || carry != 0); ++plane)
+        {
+            std::uint64_t addend = (plane < rowPlaneCount) ? pending[plane] : 0;
+            std::uint64_t sum = planes[plane] ^ addend ^ carry;
+            carry = (planes[plane] & addend) | (carry & (planes[plane] ^ addend));
+            planes[plane] = sum;
+        }
+        std::fill_n(pending, rowPlaneCount, 0);
+    }
+    m_pendingRows = 0;
+}
+
+void BoardStatistics::finish()
+{
+    flushRows();
+
+    const AngleTables &tables = angleTables(m_rowCount, m_colCount);
+    int wordCount = static_cast<int>(m_columnPlanes.size()) / m_planeCount;
+
+    for(int word = 0; word < wordCount; ++word)
+    {
+        const std::uint64_t *planes = &m_columnPlanes[static_cast<std::size_t>(word) * m_planeCount];
+
+        // Columns with any live cells bound the box.
+        std::uint64_t occupied = 0;
+        for(int plane = 0; plane < m_planeCount; ++plane)
+        {
+            occupied |= planes[plane];
+        }
+        if(occupied == 0)
+        {
+            continue;
+        }
+        m_minCol = std::min(m_minCol, word * 64 + __builtin_ctzll(occupied));
+        m_maxCol = std::max(m_maxCol, word * 64 + 63 - __builtin_clzll(occupied));
+
+        // Each set bit of plane k adds 2^k cells to its column.
+        for(int plane = 0; plane < m_planeCount; ++plane)
+        {
+            double weight = static_cast<double>(1LL << plane);
+            for(std::uint64_t bits = planes[plane]; bits != 0; bits &= bits - 1)
+            {
+                int col = word * 64 + __builtin_ctzll(bits);
+                m_colSum += static_cast<long long>(col) << plane;
+                m_colCos += tables.colCos[col] * weight;
+                m_colSin += tables.colSin[col] * weight;
+            }
+        }
+    }
+
+    m_columnPlanes.clear();
+    m_rowPlanes.clear();
+}
+
+void BoardStatistics::merge(const BoardStatistics &other)
+{
+    m_population += other.m_population;
+    m_rowSum += other.m_rowSum;
+    m_colSum += other.m_colSum;
+    m_minRow = std::min(m_minRow, other.m_minRow);
+    m_maxRow = std::max(m_maxRow, other.m_maxRow);
+    m_minCol = std::min(m_minCol, other.m_minCol);
+    m_maxCol = std::max(m_maxCol, other.m_maxCol);
+    m_rowCos += other.m_rowCos;
+    m_rowSin += other.m_rowSin;
+    m_colCos += other.m_colCos;
+    m_colSin += other.m_colSin;
+}
+
+long long BoardStatistics::getPopulation() const
+{
+    return m_population;
+}
+
+int BoardStatistics::getMinRow() const
+{
+    return m_minRow;
+}
+
+int BoardStatistics::getMaxRow() const
+{
+    return m_maxRow;
+}
+
+int BoardStatistics::getMinCol() const
+{
+    return m_minCol;
+}
+
+int BoardStatistics::getMaxCol() const
+{
+    return m_maxCol;
+}
+
+std::pair<double,double> BoardStatistics::mean() const
+{
+    double population = static_cast<double>(m_population);
+    return std::pair<double,double>(m_rowSum / population, m_colSum / population);
+}
+
+std::pair<double,double> BoardStatistics::circularMean() const
+{
+    if(m_population == 0)
+    {
+        double notANumber = std::numeric_limits<double>::quiet_NaN();
+        return std::pair<double,double>(notANumber, notANumber);
+    }
+
+    return std::pair<double,double>(circularPosition(m_rowCos, m_rowSin, m_rowCount), circularPosition(m_colCos, m_colSin, m_colCount));
+}
@@ -0,0 +1,145 @@
+#ifndef BoardStatistics_hpp
+#define BoardStatistics_hpp
+
+#include <cstdint> // For the packed words of a row.
+#include <utility> // For std::pair.
+#include <vector> // For the column counters.
+
+/**
+ * \file
+ * \brief Class to model running statistics of the live cells of a board.
+ *
+ * The statistics are built a packed row at a time, so they can be gathered while a generation is 
+ * being written, with rows still in cache, and the results of separate bands of rows merged. 
+ * Alongside the population, coordinate sums and bounding box they hold the sums of the cosine 
+ * and sine of each coordinate taken as an angle round the board, which give the circular mean 
+ * used for the centre of mass on a periodic board.
+ *
+ * Rows only need their population, which is one popcount per word. Columns are counted with 
+ * bit sliced counters: each row goes into small 4 bit counters with a fixed chain of half adders, 
+ * those are added into the full counters every 15 rows, and finish() turns the counts into the 
+ * column statistics once every row has been added.
+ */
+class BoardStatistics
+{
+private:
+    /// Member variable that holds number of rows on the board.
+    int m_rowCount;
+
+    /// Member variable that holds number of columns on the board.
+    int m_colCount;
+
+    /// Member variable that holds the number of live cells.
+    long long m_population;
+
+    /// Member variable that holds the sum of the rows of the live cells.
+    long long m_rowSum;
+
+    /// Member variable that holds the sum of the columns of the live cells.
+    long long m_colSum;
+
+    /// Member variables that hold the bounding box of the live cells, empty when min > max.
+    int m_minRow;
+    int m_maxRow;
+    int m_minCol;
+    int m_maxCol;
+
+    /// Member variables that hold the sums of the cosines and sines of the row angles of the live cells.
+    double m_rowCos;
+    double m_rowSin;
+
+    /// Member variables that hold the sums of the cosines and sines of the column angles of the live cells.
+    double m_colCos;
+    double m_colSin;
+
+    /// Member variable that holds the number of bit planes in the column counters.
+    int m_planeCount;
+
+    /// Member variable that holds the live cells of each column added so far, bit k of the count of 
+    /// column c is bit c % 64 of word (c / 64) * m_planeCount + k. Empty once finished.
+    std::vector<std::uint64_t> m_columnPlanes;
+
+    /// Member variable that holds the small counters of the rows added since the last flush, laid out as above with 4 planes.
+    std::vector<std::uint64_t> m_rowPlanes;
+
+    /// Member variable that holds the number of rows in the small counters.
+    int m_pendingRows;
+
+    /**
+     *\brief Adds the small column counters into the full ones and clears them.
+     */
+    void flushRows();
+
+public:
+    /**
+     *\brief Constructor that sets up empty statistics for a board.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     */
+    BoardStatistics(int rows, int cols);
+
+    /**
+     *\brief Empties the statistics for a board, keeping the buffers so they can be reused without allocating.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     */
+    void reset(int rows, int cols);
+
+    /**
+     *\brief Adds the live cells of a row.
+     *\param row index of the row.
+     *\param words pointer to the packed words of the row, with dead padding bits.
+     *\param wordCount number of words in the row.
+     */
+    void addRow(int row, const std::uint64_t *words, int wordCount);
+
+    /**
+     *\brief Works out the column statistics from the rows added so far.
+     *
+     * Must be called after the last row is added and before merging or reading the statistics.
+     */
+    void finish();
+
+    /**
+     *\brief Adds the statistics of another set of rows of the same board.
+     *\param other BoardStatistics reference to add, the rows must not overlap and both must be finished.
+     */
+    void merge(const BoardStatistics &other);
+
+    /**
+     *\brief Getter for the number of live cells.
+     *\return Long integer value representing the population.
+     */
+    long long getPopulation() const;
+
+    /**
+     *\brief Getter for the bounding box of the live cells.
+     *
+     * Values are only meaningful if the population is not 0.
+     *
+     *\return Integer value representing the smallest row, largest row, smallest column or largest column with a live cell.
+     */
+    int getMinRow() const;
+    int getMaxRow() const;
+    int getMinCol() const;
+    int getMaxCol() const;
+
+    /**
+     *\brief Calculates the mean row and column of the live cells.
+     *\return std::pair holding the mean row and mean column, not a number if there are no live cells.
+     */
+    std::pair<double,double> mean() const;
+
+    /**
+     *\brief Calculates the circular mean row and column of the live cells.
+     *
+     * Each coordinate is treated as an angle round its periodic dimension, so a structure 
+     * straddling an edge has its mean on the edge rather than in the middle of the board. The 
+     * results lie in [0, rows) and [0, cols).
+     *
+     *\return std::pair holding the circular mean row and column, not a number if there are no live cells.
+     */
+    std::pair<double,double> circularMean() const;
+};
+
+#endif /* BoardStatistics_hpp */
@@ -0,0 +1,93 @@
+#ifndef BoundaryPolicy_hpp
+#define BoundaryPolicy_hpp
+
+/**
+ * \file
+ * \brief Compile-time policies for what lies beyond the edges of a board.
+ *
+ * Each policy provides resolve(), which maps a possibly out of range index onto the board and 
+ * reports whether the cell there can be alive, along with flags the update kernels use to pick 
+ * their edge handling at compile time. Indices inside the board are returned untouched so 
+ * interior cells never pay for the boundary.
+ */
+
+/**
+ * \struct Toroidal
+ * \brief Periodic boundary conditions, the board wraps round at every edge.
+ */
+struct Toroidal
+{
+    /// Whether the board wraps round at its edges.
+    static constexpr bool periodic = true;
+
+    /// Whether the board grows to keep its edges dead.
+    static constexpr bool grows = false;
+
+    /**
+     *\brief Maps an index onto the board by wrapping it round.
+     *\param index index to map, updated in place.
+     *\param count number of rows or columns on the board.
+     *\return true since every index maps to a cell.
+     */
+    static bool resolve(int &index, int count)
+    {
+        if(static_cast<unsigned>(index) >= static_cast<unsigned>(count))
+        {
+            index = (index % count + count) % count;
+        }
+        return true;
+    }
+};
+
+/**
+ * \struct DeadEdge
+ * \brief Fixed boundary conditions, every cell beyond the edges is permanently dead.
+ */
+struct DeadEdge
+{
+    /// Whether the board wraps round at its edges.
+    static constexpr bool periodic = false;
+
+    /// Whether the board grows to keep its edges dead.
+    static constexpr bool grows = false;
+
+    /**
+     *\brief Checks whether an index lies on the board.
+     *\param index index to check.
+     *\param count number of rows or columns on the board.
+     *\return boolean value representing whether the index lies on the board.
+     */
+    static bool resolve(int &index, int count)
+    {
+        return static_cast<unsigned>(index) < static_cast<unsigned>(count);
+    }
+};
+
+/**
+ * \struct Unbounded
+ * \brief An infinite plane, the board grows whenever a live cell reaches one of its edges.
+ *
+ * Since the edges are always dead before a step nothing can be born beyond them, so the board 
+ * is stepped with dead edge conditions and evolves exactly as it would on an infinite plane.
+ */
+struct Unbounded
+{
+    /// Whether the board wraps round at its edges.
+    static constexpr bool periodic = false;
+
+    /// Whether the board grows to keep its edges dead.
+    static constexpr bool grows = true;
+
+    /**
+     *\brief Checks whether an index lies on the board.
+     *\param index index to check.
+     *\param count number of rows or columns on the board.
+     *\return boolean value representing whether the index lies on the board.
+     */
+    static bool resolve(int &index, int count)
+    {
+        return DeadEdge::resolve(index, count);
+    }
+};
+
+#endif /* BoundaryPolicy_hpp */
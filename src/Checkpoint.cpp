@@ -0,0 +1,339 @@
+#include "Checkpoint.hpp"
+#include "Metrics.hpp"
+#include <stdexcept> // For std::runtime_error.
+#include <cstring> // For std::memcpy, std::memcmp and std::strerror.
+#include <cerrno> // For errno.
+#include <cstdio> // For std::rename.
+#include <fcntl.h> // For open.
+#include <unistd.h> // For close, ftruncate and fsync.
+#include <sys/mman.h> // For mmap, madvise, msync and munmap.
+#include <sys/stat.h> // For fstat.
+
+namespace
+{
+    /// Identifies a file as a checkpoint.
+    const char checkpointMagic[8] = {'G', 'O', 'L', 'C', 'K', 'P', 'T', '\0'};
+
+    /// Version of the layout below, to be bumped whenever it changes.
+    constexpr std::uint32_t checkpointVersion = 1;
+
+    /// Offset of the packed words from the start of the file, a page so the payload is page aligned.
+    constexpr std::uint32_t payloadOffset = 4096;
+
+    /**
+     * \struct CheckpointHeader
+     * \brief Layout of the start of a checkpoint file.
+     */
+    struct CheckpointHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t payloadOffset;
+        std::int32_t  rows;
+        std::int32_t  cols;
+        std::int32_t  wordsPerRow;
+        std::int32_t  rowOrigin;
+        std::int32_t  colOrigin;
+        std::uint32_t birthMask;
+        std::uint32_t survivalMask;
+        std::uint32_t seed;
+        std::uint64_t generation;
+        std::uint64_t payloadBytes;
+    };
+
+    /**
+     *\brief Builds the exception thrown when a system call on a checkpoint fails.
+     *\param what std::string describing what was being done.
+     *\param fileName std::string holding the name of the file.
+     *\return std::runtime_error holding the message and the reason for the failure.
+     */
+    std::runtime_error checkpointError(const std::string &what, const std::string &fileName)
+    {
+        return std::runtime_error("Could not " + what + " checkpoint " + fileName + ": " + std::strerror(errno));
+    }
+
+    /**
+     * \class MappedFile
+     * \brief Owns a file descriptor and a mapping of the whole file, releasing both when destroyed.
+     */
+    class MappedFile
+    {
+    private:
+        /// File descriptor of the open file.
+        int m_descriptor;
+
+        /// Start of the mapping or MAP_FAILED if the file is not mapped.
+        void *m_data;
+
+        /// Length of the mapping in bytes.
+        std::size_t m_size;
+
+    public:
+        MappedFile() : m_descriptor{-1}, m_data{MAP_FAILED}, m_size{0} {}
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile()
+        {
+            if(m_data != MAP_FAILED)
+            {
+                munmap(m_data, m_size);
+            }
+            if(m_descriptor >= 0)
+            {
+                close(m_descriptor);
+            }
+        }
+
+        /**
+         *\brief Opens a file.
+         *\param fileName name of the file.
+         *\param flags flags passed on to open.
+         *\return true if the file was opened.
+         */
+        bool open(const std::string &fileName, int flags)
+        {
+            m_descriptor = ::open(fileName.c_str(), flags, 0644);
+            return m_descriptor >= 0;
+        }
+
+        /**
+         *\brief Maps the open file into memory.
+         *\param size number of bytes to map.
+         *\param protection protection of the mapping, PROT_READ or PROT_READ | PROT_WRITE.
+         *\return true if the file was mapped.
+         */
+        bool map(std::size_t size, int protection)
+        {
+            m_size = size;
+            m_data = mmap(nullptr, size, protection, MAP_SHARED, m_descriptor, 0);
+            if(m_data != MAP_FAILED)
+            {
+                // Checkpoints are always copied from start to end.
+                madvise(m_data, size, MADV_SEQUENTIAL);
+            }
+            return m_data != MAP_FAILED;
+        }
+
+        /**
+         *\brief Flushes the mapping and the file to the disk.
+         *\return true if both were flushed.
+         */
+        bool sync()
+        {
+            return msync(m_data, m_size, MS_SYNC) == 0 && fsync(m_descriptor) == 0;
+        }
+
+        int descriptor() const { return m_descriptor; }
+
+        char* data() const { return static_cast<char*>(m_data); }
+    };
+
+    /**
+     *\brief Flushes the directory holding a file to the disk, so a rename into it survives a crash.
+     *\param fileName std::string holding the name of the file.
+     *\return true if the directory was flushed.
+     */
+    bool syncDirectory(const std::string &fileName)
+    {
+        std::string::size_type slash = fileName.find_last_of('/');
+        std::string directory = (slash == std::string::npos) ? "." : (slash == 0) ? "/" : fileName.substr(0, slash);
+        int descriptor = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if(descriptor < 0)
+        {
+            return false;
+        }
+        bool synced = fsync(descriptor) == 0;
+        close(descriptor);
+        return synced;
+    }
+
+    /**
+     *\brief Reads and checks the header at the start of a mapped checkpoint.
+     *\param fileName std::string holding the name of the checkpoint file, for the messages.
+     *\param data pointer to the start of the mapped file.
+     *\param fileSize size of the file in bytes, at least the size of a header.
+     *\return CheckpointHeader describing a board laid out exactly as LifeBoard would hold it.
+     *\throws std::runtime_error if the header is not that of a valid checkpoint of this version.
+     */
+    CheckpointHeader readHeader(const std::string &fileName, const char *data, std::size_t fileSize)
+    {
+        CheckpointHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if(std::memcmp(header.magic, checkpointMagic, sizeof(checkpointMagic)) != 0)
+        {
+            throw std::runtime_error(fileName + " is not a checkpoint.");
+        }
+        if(header.version != checkpointVersion)
+        {
+            throw std::runtime_error(fileName + " is a version " + std::to_string(header.version) + " checkpoint, only version " + std::to_string(checkpointVersion) + " is supported.");
+        }
+
+        // The sizes are compared without adding them, so huge values cannot overflow past the check.
+        std::uint64_t expectedWords = (static_cast<std::uint64_t>(header.cols) + LifeBoard::cellsPerWord - 1) / LifeBoard::cellsPerWord;
+        std::uint64_t expectedBytes = static_cast<std::uint64_t>(header.rows) * expectedWords * sizeof(LifeBoard::Word);
+        if(header.rows <= 0 || header.cols <= 0 || static_cast<std::uint64_t>(header.wordsPerRow) != expectedWords || 
+           header.payloadBytes != expectedBytes || header.payloadOffset < sizeof(CheckpointHeader) || 
+           header.payloadOffset % sizeof(LifeBoard::Word) != 0 || header.payloadOffset > fileSize || 
+           header.payloadBytes > fileSize - header.payloadOffset)
+        {
+            throw std::runtime_error(fileName + " has an inconsistent checkpoint header.");
+        }
+
+        // The rule is held to the same limits as one given in B/S notation.
+        if((header.birthMask & ~0x1FFu) != 0 || (header.survivalMask & ~0x1FFu) != 0)
+        {
+            throw std::runtime_error(fileName + " has an invalid rule in its checkpoint header.");
+        }
+        if(header.birthMask & 1)
+        {
+            throw std::runtime_error("Rule " + Rule(header.birthMask, header.survivalMask).toString() + " gives birth with 0 neighbours which is not supported.");
+        }
+
+        return header;
+    }
+}
+
+void writeCheckpoint(const std::string &fileName, const LifeBoard &board, const CheckpointInfo &info)
+{
+    CheckpointHeader header{};
+    std::memcpy(header.magic, checkpointMagic, sizeof(checkpointMagic));
+    header.version       = checkpointVersion;
+    header.payloadOffset = payloadOffset;
+    header.rows          = board.getRows();
+    header.cols          = board.getCols();
+    header.wordsPerRow   = board.getWordsPerRow();
+    header.rowOrigin     = board.getRowOrigin();
+    header.colOrigin     = board.getColOrigin();
+    header.birthMask     = info.rule.getBirthMask();
+    header.survivalMask  = info.rule.getSurvivalMask();
+    header.seed          = info.seed;
+    header.generation    = info.generation;
+    header.payloadBytes  = static_cast<std::uint64_t>(header.rows) * header.wordsPerRow * sizeof(LifeBoard::Word);
+
+    std::size_t fileSize = payloadOffset + header.payloadBytes;
+    std::string temporaryName = fileName + ".tmp";
+
+    // The file is mapped in its own scope so it is closed before being renamed.
+    {
+        MappedFile file;
+        if(!file.open(temporaryName, O_RDWR | O_CREAT | O_TRUNC))
+        {
+            throw checkpointError("create", temporaryName);
+        }
+        if(ftruncate(file.descriptor(), static_cast<off_t>(fileSize)) != 0 || !file.map(fileSize, PROT_READ | PROT_WRITE))
+        {
+            throw checkpointError("size", temporaryName);
+        }
+
+        // Rows are stored back to back in the board so the whole payload is one copy.
+        std::memcpy(file.data(), &header, sizeof(header));
+        if(header.payloadBytes > 0)
+        {
+            std::memcpy(file.data() + payloadOffset, board.rowData(0), header.payloadBytes);
+        }
+
+        // The new checkpoint must be on the disk before it replaces the old one.
+        if(!file.sync())
+        {
+            throw checkpointError("flush", temporaryName);
+        }
+    }
+
+    if(std::rename(temporaryName.c_str(), fileName.c_str()) != 0)
+    {
+        throw checkpointError("replace", fileName);
+    }
+    if(!syncDirectory(fileName))
+    {
+        throw checkpointError("flush the directory of", fileName);
+    }
+    METRICS_COUNT(Counter::BytesWritten, fileSize);
+}
+
+CheckpointMapping::CheckpointMapping(const std::string &fileName) :
+m_data{MAP_FAILED},
+m_size{0}
+{
+    // The descriptor is only needed until the file is mapped.
+    MappedFile file;
+    struct stat status;
+    if(!file.open(fileName, O_RDONLY) || fstat(file.descriptor(), &status) != 0)
+    {
+        throw checkpointError("open", fileName);
+    }
+
+    m_size = static_cast<std::size_t>(status.st_size);
+    if(m_size < sizeof(CheckpointHeader))
+    {
+        throw std::runtime_error(fileName + " is too short to be a checkpoint.");
+    }
+    m_data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file.descriptor(), 0);
+    if(m_data == MAP_FAILED)
+    {
+        throw checkpointError("map", fileName);
+    }
+    madvise(m_data, m_size, MADV_SEQUENTIAL);
+
+    CheckpointHeader header;
+    try
+    {
+        header = readHeader(fileName, static_cast<const char*>(m_data), m_size);
+    }
+    catch(...)
+    {
+        munmap(m_data, m_size);
+        throw;
+    }
+    m_info          = CheckpointInfo{header.generation, header.seed, Rule(header.birthMask, header.survivalMask)};
+    m_rows          = header.rows;
+    m_cols          = header.cols;
+    m_rowOrigin     = header.rowOrigin;
+    m_colOrigin     = header.colOrigin;
+    m_payloadOffset = header.payloadOffset;
+
+    // Padding bits must be dead whatever the file held, only the pages of a damaged file are copied to clear them.
+    LifeBoard board = view();
+    for(int row = 0; row < m_rows; ++row)
+    {
+        LifeBoard::Word &last = board.rowData(row)[board.getWordsPerRow() - 1];
+        if((last & ~board.lastWordMask()) != 0)
+        {
+            last &= board.lastWordMask();
+        }
+    }
+}
+
+CheckpointMapping::~CheckpointMapping()
+{
+    munmap(m_data, m_size);
+}
+
+const CheckpointInfo& CheckpointMapping::getInfo() const
+{
+    return m_info;
+}
+
+LifeBoard CheckpointMapping::view() const
+{
+    LifeBoard board(m_rows, m_cols, reinterpret_cast<LifeBoard::Word*>(static_cast<char*>(m_data) + m_payloadOffset));
+    board.setOrigin(m_rowOrigin, m_colOrigin);
+    return board;
+}
+
+CheckpointInfo readCheckpoint(const std::string &fileName, LifeBoard &board)
+{
+    CheckpointMapping checkpoint(fileName);
+    LifeBoard stored = checkpoint.view();
+
+    // Only reallocate the board if it does not already have the right shape.
+    if(board.getRows() != stored.getRows() || board.getCols() != stored.getCols())
+    {
+        board = LifeBoard(stored.getRows(), stored.getCols(), LifeBoard::Dead);
+    }
+    std::memcpy(board.rowData(0), stored.rowData(0), static_cast<std::size_t>(stored.getRows()) * stored.getWordsPerRow() * sizeof(LifeBoard::Word));
+    board.setOrigin(stored.getRowOrigin(), stored.getColOrigin());
+
+    return checkpoint.getInfo();
+}
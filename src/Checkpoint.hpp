@@ -0,0 +1,130 @@
+#ifndef Checkpoint_hpp
+#define Checkpoint_hpp
+
+#include <string> // For file names.
+#include <cstdint> // For fixed width integers.
+#include <cstddef> // For std::size_t.
+#include "LifeBoard.hpp"
+#include "Rule.hpp"
+
+/**
+ * \file
+ * \brief Functions to save and restore a LifeBoard as a binary checkpoint.
+ *
+ * A checkpoint is a versioned header holding the dimensions of the board, its origin on the 
+ * plane, the generation, the rule and the seed of the run, followed by the packed words of the 
+ * board exactly as LifeBoard holds them. The payload starts on a page boundary and both directions 
+ * go through mmap, so saving or restoring is a single copy between the board and the page cache 
+ * with no conversion, which runs at close to memory bandwidth even for boards of many gigabytes.
+ * A CheckpointMapping goes further and hands out a board that is a view straight onto the mapped 
+ * payload, so nothing is copied until the cells are copied to wherever they are stepped.
+ */
+
+/**
+ * \struct CheckpointInfo
+ * \brief Details of a run stored alongside the board in a checkpoint.
+ */
+struct CheckpointInfo
+{
+    /// Generation the board is at.
+    std::uint64_t generation;
+
+    /// Seed the run was started with.
+    unsigned int seed;
+
+    /// Rule the board is evolving under.
+    Rule rule;
+};
+
+/**
+ * \class CheckpointMapping
+ * \brief A checkpoint file mapped into memory, whose board can be used without copying it.
+ *
+ * The file is mapped privately, so a board viewing the payload reads the page cache directly and
+ * writing to it only copies the pages written, the file itself is never changed.
+ */
+class CheckpointMapping
+{
+private:
+    /// Member variable that holds the start of the mapping.
+    void *m_data;
+
+    /// Member variable that holds the length of the mapping in bytes.
+    std::size_t m_size;
+
+    /// Member variable that holds the details of the run stored with the board.
+    CheckpointInfo m_info;
+
+    /// Member variable that holds the number of rows on the board.
+    int m_rows;
+
+    /// Member variable that holds the number of columns on the board.
+    int m_cols;
+
+    /// Member variable that holds the row of the plane the top of the board is at.
+    int m_rowOrigin;
+
+    /// Member variable that holds the column of the plane the left of the board is at.
+    int m_colOrigin;
+
+    /// Member variable that holds the offset of the packed words from the start of the mapping.
+    std::size_t m_payloadOffset;
+
+public:
+    /**
+     *\brief Constructor that maps and checks a checkpoint file.
+     *\param fileName std::string holding the name of the checkpoint file.
+     *\throws std::runtime_error if the file cannot be read or is not a checkpoint of this version.
+     */
+    explicit CheckpointMapping(const std::string &fileName);
+
+    /**
+     *\brief Destructor that unmaps the file, any views of the board must be gone by then.
+     */
+    ~CheckpointMapping();
+
+    CheckpointMapping(const CheckpointMapping&) = delete;
+    CheckpointMapping& operator=(const CheckpointMapping&) = delete;
+
+    /**
+     *\brief Getter for the details of the run stored with the board.
+     *\return reference to the CheckpointInfo.
+     */
+    const CheckpointInfo& getInfo() const;
+
+    /**
+     *\brief Makes a board that views the payload of the mapping without copying it.
+     *\return LifeBoard view with the dimensions and origin of the checkpoint, valid while the mapping lives.
+     */
+    LifeBoard view() const;
+};
+
+/**
+ *\brief Saves a board to a checkpoint file.
+ *
+ * The checkpoint is written to a temporary file, flushed to the disk and then renamed over the 
+ * named file, whose directory is flushed too, so neither an interrupted save nor a crash straight
+ * after one leaves a damaged checkpoint behind.
+ *
+ *\param fileName std::string holding the name of the checkpoint file.
+ *\param board LifeBoard reference to save.
+ *\param info CheckpointInfo to store with the board.
+ *\throws std::runtime_error if the file cannot be written.
+ */
+void writeCheckpoint(const std::string &fileName, const LifeBoard &board, const CheckpointInfo &info);
+
+/**
+ *\brief Restores a board from a checkpoint file.
+ *
+ * If the board already has the dimensions of the checkpoint the packed words are copied straight 
+ * from the mapped file into its existing storage, otherwise the board is replaced by one of the 
+ * right size first. Use a CheckpointMapping instead to avoid the copy.
+ *
+ *\param fileName std::string holding the name of the checkpoint file.
+ *\param board LifeBoard reference to restore into.
+ *\return CheckpointInfo stored with the board.
+ *\throws std::runtime_error if the file cannot be read or is not a checkpoint of this version.
+ */
+CheckpointInfo readCheckpoint(const std::string &fileName, LifeBoard &board);
+
+#endif /* Checkpoint_hpp */
@@ -0,0 +1,96 @@
+#include "CycleDetector.hpp"
+#include <algorithm> // For std::equal.
+
+CycleDetector::CycleDetector(int maxPeriod) :
+m_maxPeriod{maxPeriod},
+m_window(maxPeriod, 0),
+m_recorded{0},
+m_period{0},
+m_cycleStart{0},
+m_lastGeneration{0},
+m_lastHash{0},
+m_collisions{0},
+m_confirmCurrent(0, 0, LifeBoard::Dead),
+m_confirmUpdated(0, 0, LifeBoard::Dead)
+{
+    m_generations.reserve(2 * maxPeriod);
+}
+
+void CycleDetector::remember(std::uint64_t generation, std::uint64_t hash)
+{
+    // Drop the generation falling out of the window, unless its hash has been seen again since.
+    std::uint64_t &slot = m_window[generation % m_maxPeriod];
+    if(m_recorded >= static_cast<std::uint64_t>(m_maxPeriod))
+    {
+        std::unordered_map<std::uint64_t, std::uint64_t>::iterator oldest = m_generations.find(slot);
+        if(oldest != m_generations.end() && oldest->second + m_maxPeriod == generation)
+        {
+            m_generations.erase(oldest);
+        }
+    }
+
+    slot = hash;
+    m_generations[hash] = generation;
+    ++m_recorded;
+}
+
+bool CycleDetector::record(std::uint64_t generation, std::uint64_t hash)
+{
+    m_lastGeneration = generation;
+    m_lastHash = hash;
+    std::unordered_map<std::uint64_t, std::uint64_t>::const_iterator seen = m_generations.find(hash);
+    if(seen != m_generations.end())
+    {
+        m_period = static_cast<int>(generation - seen->second);
+        m_cycleStart = seen->second;
+        return true;
+    }
+
+    remember(generation, hash);
+    return false;
+}
+
+void CycleDetector::reset()
+{
+    m_generations.clear();
+    m_recorded = 0;
+    m_period = 0;
+    m_cycleStart = 0;
+}
+
+bool CycleDetector::sameBoards(const LifeBoard &first, const LifeBoard &second)
+{
+    if(first.getRows() != second.getRows() || first.getCols() != second.getCols() || 
+       first.getRowOrigin() != second.getRowOrigin() || first.getColOrigin() != second.getColOrigin())
+    {
+        return false;
+    }
+
+    return first.getRows() == 0 || 
+           std::equal(first.rowData(0), first.rowData(0) + static_cast<std::size_t>(first.getRows()) * first.getWordsPerRow(), second.rowData(0));
+}
+
+void CycleDetector::rejectCycle()
+{
+    // The board recorded last goes in the window as if its hash had not been seen, replacing the
+    // earlier generation that only shared its hash.
+    remember(m_lastGeneration, m_lastHash);
+    m_period = 0;
+    m_cycleStart = 0;
+    ++m_collisions;
+}
+
+int CycleDetector::getCollisions() const
+{
+    return m_collisions;
+}
+
+int CycleDetector::getPeriod() const
+{
+    return m_period;
+}
+
+std::uint64_t CycleDetector::getCycleStart() const
+{
+    return m_cycleStart;
+}
@@ -0,0 +1,149 @@
+#ifndef CycleDetector_hpp
+#define CycleDetector_hpp
+
+#include <vector> // For the window of recent hashes.
+#include <unordered_map> // For looking up hashes in the window.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+
+/**
+ * \file
+ * \brief Class to model a detector of boards that have settled into a cycle.
+ *
+ * The hash of the board is recorded every generation and kept for a window of the most recent 
+ * generations, in a ring for their order and a hash table to find them in constant time. As soon 
+ * as a hash repeats within the window the board has entered a cycle, a still life being a cycle 
+ * of period 1, and since every generation is checked the earlier occurrence is the generation 
+ * the cycle began. Cycles longer than the window are not seen. Boards are first compared by their
+ * 64-bit hash, and since a collision would report a cycle that is not there a repeated hash is 
+ * only a candidate: confirm() steps a copy of the board through the period and compares the cells,
+ * so a run only stops on a cycle that is really there and collisions are counted instead.
+ */
+class CycleDetector
+{
+private:
+    /// Member variable that holds the longest period that can be detected.
+    int m_maxPeriod;
+
+    /// Member variable that holds the hashes of the last m_maxPeriod generations, indexed by generation modulo its size.
+    std::vector<std::uint64_t> m_window;
+
+    /// Member variable that holds the generation each hash in the window was recorded at.
+    std::unordered_map<std::uint64_t, std::uint64_t> m_generations;
+
+    /// Member variable that holds the number of generations recorded since the last reset.
+    std::uint64_t m_recorded;
+
+    /// Member variable that holds the period of the cycle found, 0 if none has been.
+    int m_period;
+
+    /// Member variable that holds the generation the cycle found began at.
+    std::uint64_t m_cycleStart;
+
+    /// Member variable that holds the generation last recorded.
+    std::uint64_t m_lastGeneration;
+
+    /// Member variable that holds the hash last recorded.
+    std::uint64_t m_lastHash;
+
+    /// Member variable that holds the number of repeated hashes that turned out not to be cycles.
+    int m_collisions;
+
+    /// Member variable that holds the copy of the board stepped to confirm a cycle.
+    LifeBoard m_confirmCurrent;
+
+    /// Member variable that holds the board the copy is stepped into.
+    LifeBoard m_confirmUpdated;
+
+    /**
+     *\brief Adds a generation to the window, dropping the one falling out of it.
+     *\param generation generation of the board.
+     *\param hash 64-bit hash of the board.
+     */
+    void remember(std::uint64_t generation, std::uint64_t hash);
+
+    /**
+     *\brief Checks whether two boards have the same dimensions, origin and cells.
+     *\param first LifeBoard to compare.
+     *\param second LifeBoard to compare.
+     *\return true if the boards are the same.
+     */
+    static bool sameBoards(const LifeBoard &first, const LifeBoard &second);
+
+    /**
+     *\brief Drops the cycle found, remembering the last generation recorded under its hash instead.
+     */
+    void rejectCycle();
+
+public:
+    /**
+     *\brief Constructor that sets up an empty window.
+     *\param maxPeriod longest period to detect, must be at least 1.
+     */
+    explicit CycleDetector(int maxPeriod);
+
+    /**
+     *\brief Records the hash of the board at a generation and checks whether it has been seen recently.
+     *\param generation generation of the board, one more than the last one recorded.
+     *\param hash 64-bit hash of the board.
+     *\return true if the hash repeats one from the last maxPeriod generations, a candidate cycle to confirm().
+     */
+    bool record(std::uint64_t generation, std::uint64_t hash);
+
+    /**
+     *\brief Confirms the candidate cycle found by the last record() by stepping a copy of the board through its period.
+     *\param board LifeBoard that was recorded.
+     *\param step callable taking the updated and the current board that advances the current one a generation.
+     *\return true if the board really repeats after the period, otherwise the cycle is dropped and counted as a collision.
+     */
+    template<typename Step>
+    bool confirm(const LifeBoard &board, const Step &step);
+
+    /**
+     *\brief Getter for the number of repeated hashes that confirm() found were not cycles.
+     *\return Integer value holding the number of hash collisions seen.
+     */
+    int getCollisions() const;
+
+    /**
+     *\brief Forgets every generation recorded so far.
+     */
+    void reset();
+
+    /**
+     *\brief Getter for the period of the cycle found.
+     *\return Integer value holding the period, 0 if no cycle has been found.
+     */
+    int getPeriod() const;
+
+    /**
+     *\brief Getter for the generation the cycle found began at.
+     *\return generation of the first board in the cycle.
+     */
+    std::uint64_t getCycleStart() const;
+};
+
+template<typename Step>
+bool CycleDetector::confirm(const LifeBoard &board, const Step &step)
+{
+    // The copies are only made when a hash repeats, so confirming costs nothing the rest of the time.
+    // The updated board is given the same dimensions since the updates write into the board they are given.
+    m_confirmCurrent = board;
+    m_confirmCurrent.setStatisticsTracking(false);
+    m_confirmCurrent.setHashTracking(false);
+    m_confirmUpdated = m_confirmCurrent;
+    for(int generation = 0; generation < m_period; ++generation)
+    {
+        step(m_confirmUpdated, m_confirmCurrent);
+        std::swap(m_confirmUpdated, m_confirmCurrent);
+    }
+
+    if(sameBoards(m_confirmCurrent, board))
+    {
+        return true;
+    }
+    rejectCycle();
+    return false;
+}
+
+#endif /* CycleDetector_hpp */
@@ -0,0 +1,87 @@
+#include "Ensemble.hpp"
+#include "LifeBoard.hpp"
+#include "CycleDetector.hpp"
+#include "ThreadPool.hpp"
+#include <random> // For seeding the trials.
+#include <atomic> // For handing out the trials.
+#include <algorithm> // For std::swap.
+
+TrialResult runTrial(const EnsembleSettings &settings, int trial)
+{
+    TrialResult result;
+    result.trial   = trial;
+    result.density = settings.densities[trial / settings.trialsPerDensity];
+
+    // Mix the ensemble seed and the trial number so neighbouring trials get unrelated seeds.
+    std::seed_seq sequence{settings.seed, static_cast<unsigned int>(trial)};
+    sequence.generate(&result.seed, &result.seed + 1);
+
+    LifeBoard current(settings.rows, settings.cols, LifeBoard::Dead);
+    current.randomise(result.seed, result.density);
+    current.setHashTracking(true);
+    LifeBoard updated = current;
+    result.initialPopulation = current.getPopulation();
+
+    CycleDetector detector(settings.maxPeriod);
+    std::uint64_t generation = 0;
+    result.outcome = TrialOutcome::Limit;
+    result.period  = 0;
+    while(true)
+    {
+        if(current.hash() == 0 && current.getPopulation() == 0)
+        {
+            result.outcome = TrialOutcome::Extinct;
+            break;
+        }
+        if(detector.record(generation, current.hash()) && detector.confirm(current, [](LifeBoard &next, LifeBoard &board) { update(next, board); }))
+        {
+            result.outcome = TrialOutcome::Cycle;
+            result.period  = detector.getPeriod();
+            break;
+        }
+        if(generation >= settings.maxGenerations)
+        {
+            break;
+        }
+
+        update(updated, current);
+        std::swap(updated, current);
+        ++generation;
+    }
+
+    result.lifetime = (result.outcome == TrialOutcome::Cycle) ? detector.getCycleStart() : generation;
+    result.finalPopulation = current.getPopulation();
+    return result;
+}
+
+std::vector<TrialResult> runEnsemble(const EnsembleSettings &settings, ThreadPool &pool)
+{
+    int trials = static_cast<int>(settings.densities.size()) * settings.trialsPerDensity;
+    std::vector<TrialResult> results(trials);
+
+    // Workers take the next trial as soon as they finish one, so the load balances itself
+    // however long each trial runs.
+    std::atomic<int> nextTrial(0);
+    pool.run([&](int)
+    {
+        for(int trial = nextTrial++; trial < trials; trial = nextTrial++)
+        {
+            results[trial] = runTrial(settings, trial);
+        }
+    });
+
+    return results;
+}
+
+void writeEnsembleCsv(std::ostream &out, const std::vector<TrialResult> &results)
+{
+    static const char *outcomeNames[] = {"extinct", "cycle", "limit"};
+
+    out << "trial,seed,density,initial_population,final_population,lifetime,period,outcome\n";
+    for(const TrialResult &result : results)
+    {
+        out << result.trial << ',' << result.seed << ',' << result.density << ','
+            << result.initialPopulation << ',' << result.finalPopulation << ','
+            << result.lifetime << ',' << result.period << ',' << outcomeNames[static_cast<int>(result.outcome)] << '\n';
+    }
+}
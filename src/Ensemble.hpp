@@ -0,0 +1,116 @@
+#ifndef Ensemble_hpp
+#define Ensemble_hpp
+
+#include <vector> // For the densities and the results.
+#include <iostream> // For the stream the results are written to.
+#include <cstdint> // For fixed width integers.
+
+class ThreadPool;
+
+/**
+ * \file
+ * \brief Functions to run many independent random soups and gather statistics on how they end.
+ *
+ * Each trial randomises a small toroidal board at one of the requested densities and steps it
+ * until it dies out, settles into a cycle found by a CycleDetector or reaches the generation
+ * limit. Trials are handed out one at a time to the workers of a ThreadPool as they become free,
+ * so trials that settle early do not leave a worker idle while others run to the limit.
+ *
+ * The seed of each trial is derived from the ensemble seed and the trial number alone, so the
+ * results do not depend on the number of threads or the order the trials finish in.
+ */
+
+/**
+ * \enum TrialOutcome
+ * \brief Enumeration type to identify why a trial stopped.
+ */
+enum class TrialOutcome
+{
+    Extinct,
+    Cycle,
+    Limit,
+};
+
+/**
+ * \struct EnsembleSettings
+ * \brief Description of the trials an ensemble runs.
+ */
+struct EnsembleSettings
+{
+    /// Number of rows of each board.
+    int rows;
+
+    /// Number of columns of each board.
+    int cols;
+
+    /// Probabilities of each cell starting alive, every density gets trialsPerDensity trials.
+    std::vector<double> densities;
+
+    /// Number of trials run at each density.
+    int trialsPerDensity;
+
+    /// Seed the seed of every trial is derived from.
+    unsigned int seed;
+
+    /// Generation at which a trial that has not settled is stopped.
+    std::uint64_t maxGenerations;
+
+    /// Longest period of cycle that is recognised.
+    int maxPeriod;
+};
+
+/**
+ * \struct TrialResult
+ * \brief How one trial of an ensemble ended.
+ */
+struct TrialResult
+{
+    /// Number of the trial, trials at the first density come first.
+    int trial;
+
+    /// Seed the board of the trial was randomised with, gol --seed with it and the density starts from the same board.
+    unsigned int seed;
+
+    /// Probability of each cell starting alive.
+    double density;
+
+    /// Number of live cells the trial started with.
+    long long initialPopulation;
+
+    /// Number of live cells when the trial stopped.
+    long long finalPopulation;
+
+    /// Generation the trial settled at, the start of its cycle or when it died out, or the limit.
+    std::uint64_t lifetime;
+
+    /// Period of the cycle the trial settled into, 0 unless the outcome is TrialOutcome::Cycle.
+    int period;
+
+    /// Why the trial stopped.
+    TrialOutcome outcome;
+};
+
+/**
+ *\brief Runs every trial of an ensemble under the active rule.
+ *\param settings EnsembleSettings describing the trials.
+ *\param pool ThreadPool reference whose workers run the trials.
+ *\return std::vector of TrialResult, ordered by trial number.
+ */
+std::vector<TrialResult> runEnsemble(const EnsembleSettings &settings, ThreadPool &pool);
+
+/**
+ *\brief Runs a single trial of an ensemble under the active rule.
+ *\param settings EnsembleSettings describing the trials.
+ *\param trial number of the trial to run.
+ *\return TrialResult of the trial.
+ */
+TrialResult runTrial(const EnsembleSettings &settings, int trial);
+
+/**
+ *\brief Writes the results of an ensemble as CSV with a header line.
+ *\param out std::ostream reference to write to.
+ *\param results std::vector of TrialResult to write.
+ */
+void writeEnsembleCsv(std::ostream &out, const std::vector<TrialResult> &results);
+
+#endif /* Ensemble_hpp */
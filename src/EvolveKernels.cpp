@@ -0,0 +1,774 @@
+#include "EvolveKernels.hpp"
+#include "BoundaryPolicy.hpp"
+#include "Rule.hpp"
+#include <immintrin.h> // For the AVX2 and AVX-512 intrinsics.
+#include <cstring> // For std::memcpy.
+
+namespace
+{
+    typedef std::uint64_t Word;
+
+    /**
+     *\brief Adds three words bitwise so each bit position holds its own two bit sum.
+     *\param a first word to add.
+     *\param b second word to add.
+     *\param c third word to add.
+     *\param sum word that will hold the ones bit of each sum.
+     *\param carry word that will hold the twos bit of each sum.
+     */
+    inline void fullAdd(Word a, Word b, Word c, Word &sum, Word &carry)
+    {
+        Word partial = a ^ b;
+        sum   = partial ^ c;
+        carry = (a & b) | (partial & c);
+    }
+
+    /**
+     * \struct RuleMasks
+     * \brief Gives the kernels the birth and survival masks of the rule they are instantiated for.
+     *
+     * For a StaticRule the masks are compile-time constants so the rule evaluation below folds 
+     * down to the handful of bitwise operations that rule needs.
+     */
+    template<class RuleType>
+    struct RuleMasks
+    {
+        static unsigned birth()    { return RuleType::birth; }
+        static unsigned survival() { return RuleType::survival; }
+    };
+
+    /**
+     * \struct RuleMasks<Rule>
+     * \brief The runtime rule reads its masks from the active rule once per call of the kernel.
+     */
+    template<>
+    struct RuleMasks<Rule>
+    {
+        static unsigned birth()    { return activeRule().getBirthMask(); }
+        static unsigned survival() { return activeRule().getSurvivalMask(); }
+    };
+
+    /**
+     *\brief Applies a Life-like rule to a word of cells given the bit planes of their neighbour counts.
+     *\param centre word holding the current state of the cells.
+     *\param ones ones bit of the neighbour counts.
+     *\param twos twos bit of the neighbour counts.
+     *\param fours fours bit of the neighbour counts.
+     *\param eights eights bit of the neighbour counts.
+     *\param birth mask of the neighbour counts at which a dead cell is born.
+     *\param survival mask of the neighbour counts at which a live cell survives.
+     *\return Word holding the next state of each of the cells in centre.
+     */
+    inline Word applyRule(Word centre, Word ones, Word twos, Word fours, Word eights, unsigned birth, unsigned survival)
+    {
+        // Alive next time if there are exactly 3 neighbours or the cell is alive with exactly 2.
+        if(birth == ConwayRule::birth && survival == ConwayRule::survival)
+        {
+            return twos & ~fours & (ones | centre);
+        }
+
+        // Otherwise match each count in the rule against the bit planes.
+        Word next = 0;
+        for(int count = 0; count <= 8; ++count)
+        {
+            bool born     = (birth >> count) & 1;
+            bool survives = (survival >> count) & 1;
+            if(born || survives)
+            {
+                Word matches = ((count & 1) ? ones : ~ones) & ((count & 2) ? twos : ~twos) 
+                             & ((count & 4) ? fours : ~fours) & ((count & 8) ? eights : ~eights);
+                next |= matches & ((born ? ~centre : 0) | (survives ? centre : 0));
+            }
+        }
+
+        return next;
+    }
+
+    /**
+     *\brief Applies a Life-like rule to a word of cells given the words of their eight neighbours.
+     *\param birth mask of the neighbour counts at which a dead cell is born.
+     *\param survival mask of the neighbour counts at which a live cell survives.
+     *\return Word holding the next state of each of the cells in centre.
+     *
+     * The neighbours are summed into the bit planes ones, twos, fours and eights with full adders.
+     */
+    inline Word evolveWord(Word nw, Word n, Word ne, Word w, Word centre, Word e, Word sw, Word s, Word se, 
+                           unsigned birth, unsigned survival)
+    {
+        Word sumA, carryA, sumB, carryB, sumC, carryC;
+        fullAdd(nw, n, ne, sumA, carryA);
+        fullAdd(w, e, sw, sumB, carryB);
+        sumC   = s ^ se;
+        carryC = s & se;
+
+        Word ones, carryD;
+        fullAdd(sumA, sumB, sumC, ones, carryD);
+
+        Word twosPartial, carryE;
+        fullAdd(carryA, carryB, carryC, twosPartial, carryE);
+        Word twos   = twosPartial ^ carryD;
+        Word fours  = carryE ^ (twosPartial & carryD);
+        Word eights = carryE & twosPartial & carryD;
+
+        return applyRule(centre, ones, twos, fours, eights, birth, survival);
+    }
+
+    /**
+     *\brief Evolves a single word of a row taking the periodic boundary into account.
+     *\param above words of the row above.
+     *\param row words of the row being evolved.
+     *\param below words of the row below.
+     *\param i index of the word to evolve.
+     *\param words number of words in each row.
+     *\param lastBit bit position of the last column in the final word.
+     *\param birth mask of the neighbour counts at which a dead cell is born.
+     *\param survival mask of the neighbour counts at which a live cell survives.
+     *\return Word holding the evolved cells, padding bits are not masked.
+     *
+     * Bit j of a word is column j so shifting a word left moves every cell's west neighbour into 
+     * its position and shifting right moves the east neighbour in. The bits shifted in at the 
+     * ends of the row come from the opposite end with periodic boundary conditions and are dead 
+     * otherwise.
+     */
+    template<class Boundary>
+    inline Word evolveWordAt(const Word *above, const Word *row, const Word *below, int i, int words, int lastBit, 
+                             unsigned birth, unsigned survival)
+    {
+        // Bits carried in from the neighbouring words.
+        Word aboveWest = 0, rowWest = 0, belowWest = 0;
+        if(i > 0)
+        {
+            aboveWest = above[i-1] >> 63;
+            rowWest   = row[i-1]   >> 63;
+            belowWest = below[i-1] >> 63;
+        }
+        else if(Boundary::periodic)
+        {
+            aboveWest = (above[words-1] >> lastBit) & 1;
+            rowWest   = (row[words-1]   >> lastBit) & 1;
+            belowWest = (below[words-1] >> lastBit) & 1;
+        }
+
+        Word aboveEast = 0, rowEast = 0, belowEast = 0;
+        if(i + 1 < words)
+        {
+            aboveEast = above[i+1] << 63;
+            rowEast   = row[i+1]   << 63;
+            belowEast = below[i+1] << 63;
+        }
+        else if(Boundary::periodic)
+        {
+            aboveEast = (above[0] & 1) << lastBit;
+            rowEast   = (row[0]   & 1) << lastBit;
+            belowEast = (below[0] & 1) << lastBit;
+        }
+
+        return evolveWord(
+            (above[i] << 1) | aboveWest, above[i], (above[i] >> 1) | aboveEast,
+            (row[i]   << 1) | rowWest,   row[i],   (row[i]   >> 1) | rowEast,
+            (below[i] << 1) | belowWest, below[i], (below[i] >> 1) | belowEast, 
+            birth, survival);
+    }
+
+    /**
+     *\brief Evolves the words of a range that a vector loop did not cover.
+     *\param vectorBegin index of the first word the vector loop evolved.
+     *\param vectorEnd index one past the last word the vector loop evolved.
+     *\param birth mask of the neighbour counts at which a dead cell is born.
+     *\param survival mask of the neighbour counts at which a live cell survives.
+     *
+     * See RowKernel for a description of the remaining parameters.
+     */
+    template<class Boundary>
+    inline void evolveRowEdges(const Word *above, const Word *row, const Word *below, Word *out, int words, int cols, 
+                               Word lastMask, int beginWord, int endWord, int vectorBegin, int vectorEnd, 
+                               unsigned birth, unsigned survival)
+    {
+        const int lastBit = (cols - 1) % 64;
+
+        for(int i = beginWord; i < vectorBegin; ++i)
+        {
+            out[i] = evolveWordAt<Boundary>(above, row, below, i, words, lastBit, birth, survival);
+        }
+        for(int i = vectorEnd; i < endWord; ++i)
+        {
+            out[i] = evolveWordAt<Boundary>(above, row, below, i, words, lastBit, birth, survival);
+        }
+
+        // Make sure no cells are born in the padding beyond the last column.
+        if(endWord == words)
+        {
+            out[words-1] &= lastMask;
+        }
+    }
+
+    /**
+     *\brief Finds the part of a range of words that can be evolved without boundary handling.
+     *\param words number of words in each row.
+     *\param beginWord first word of the range.
+     *\param endWord word one past the last word of the range.
+     *\param interiorBegin will hold the first interior word of the range.
+     *\param interiorEnd will hold the word one past the last interior word of the range.
+     *
+     * Interior words have both neighbouring words so bits can be shifted in without wrapping, 
+     * only word 0 and the last word of the row need the periodic boundary handling.
+     */
+    inline void interiorRange(int words, int beginWord, int endWord, int &interiorBegin, int &interiorEnd)
+    {
+        interiorBegin = (beginWord > 1) ? beginWord : 1;
+        interiorEnd   = (endWord < words - 1) ? endWord : words - 1;
+        if(interiorEnd < interiorBegin)
+        {
+            interiorEnd = interiorBegin;
+        }
+        if(interiorBegin > endWord)
+        {
+            interiorBegin = interiorEnd = endWord;
+        }
+    }
+
+    template<class Boundary, class RuleType>
+    void evolveRowScalar(const Word *above, const Word *row, const Word *below, Word *out, int words, int cols, 
+                         Word lastMask, int beginWord, int endWord)
+    {
+        const unsigned birth    = RuleMasks<RuleType>::birth();
+        const unsigned survival = RuleMasks<RuleType>::survival();
+
+        int begin, end;
+        interiorRange(words, beginWord, endWord, begin, end);
+        for(int i = begin; i < end; ++i)
+        {
+            out[i] = evolveWord(
+                (above[i] << 1) | (above[i-1] >> 63), above[i], (above[i] >> 1) | (above[i+1] << 63),
+                (row[i]   << 1) | (row[i-1]   >> 63), row[i],   (row[i]   >> 1) | (row[i+1]   << 63),
+                (below[i] << 1) | (below[i-1] >> 63), below[i], (below[i] >> 1) | (below[i+1] << 63), 
+                birth, survival);
+        }
+
+        evolveRowEdges<Boundary>(above, row, below, out, words, cols, lastMask, beginWord, endWord, begin, end, birth, survival);
+    }
+
+    __attribute__((target("avx2")))
+    inline void fullAdd256(__m256i a, __m256i b, __m256i c, __m256i &sum, __m256i &carry)
+    {
+        __m256i partial = _mm256_xor_si256(a, b);
+        sum   = _mm256_xor_si256(partial, c);
+        carry = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(partial, c));
+    }
+
+    __attribute__((target("avx2")))
+    inline void loadNeighbours256(const Word *data, int i, __m256i &west, __m256i &centre, __m256i &east)
+    {
+        // Load the words and the same words shifted one word each way so bits can cross words.
+        __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i - 1));
+        __m256i next     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        centre = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        west   = _mm256_or_si256(_mm256_slli_epi64(centre, 1), _mm256_srli_epi64(previous, 63));
+        east   = _mm256_or_si256(_mm256_srli_epi64(centre, 1), _mm256_slli_epi64(next, 63));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i applyRule256(__m256i centre, __m256i ones, __m256i twos, __m256i fours, __m256i eights, 
+                                unsigned birth, unsigned survival)
+    {
+        if(birth == ConwayRule::birth && survival == ConwayRule::survival)
+        {
+            return _mm256_andnot_si256(fours, _mm256_and_si256(twos, _mm256_or_si256(ones, centre)));
+        }
+
+        // See applyRule, the complemented planes are formed once up front.
+        const __m256i allSet = _mm256_set1_epi64x(-1);
+        const __m256i planes[4][2] = {
+            {_mm256_xor_si256(ones, allSet), ones}, {_mm256_xor_si256(twos, allSet), twos},
+            {_mm256_xor_si256(fours, allSet), fours}, {_mm256_xor_si256(eights, allSet), eights}};
+        const __m256i deadCells = _mm256_xor_si256(centre, allSet);
+
+        __m256i next = _mm256_setzero_si256();
+        for(int count = 0; count <= 8; ++count)
+        {
+            bool born     = (birth >> count) & 1;
+            bool survives = (survival >> count) & 1;
+            if(born || survives)
+            {
+                __m256i matches = _mm256_and_si256(
+                    _mm256_and_si256(planes[0][count & 1], planes[1][(count >> 1) & 1]),
+                    _mm256_and_si256(planes[2][(count >> 2) & 1], planes[3][(count >> 3) & 1]));
+                __m256i cells = born ? (survives ? allSet : deadCells) : centre;
+                next = _mm256_or_si256(next, _mm256_and_si256(matches, cells));
+            }
+        }
+
+        return next;
+    }
+
+    template<class Boundary, class RuleType>
+    __attribute__((target("avx2")))
+    void evolveRowAvx2(const Word *above, const Word *row, const Word *below, Word *out, int words, int cols, 
+                       Word lastMask, int beginWord, int endWord)
+    {
+        const unsigned birth    = RuleMasks<RuleType>::birth();
+        const unsigned survival = RuleMasks<RuleType>::survival();
+
+        // Process 4 interior words per iteration, word 0 and the last word need the boundary handling.
+        int begin, end;
+        interiorRange(words, beginWord, endWord, begin, end);
+        int i = begin;
+        for(; i + 4 <= end; i += 4)
+        {
+            __m256i nw, n, ne, w, centre, e, sw, s, se;
+            loadNeighbours256(above, i, nw, n, ne);
+            loadNeighbours256(row,   i, w, centre, e);
+            loadNeighbours256(below, i, sw, s, se);
+
+            __m256i sumA, carryA, sumB, carryB, ones, carryD, twosPartial, carryE;
+            fullAdd256(nw, n, ne, sumA, carryA);
+            fullAdd256(w, e, sw, sumB, carryB);
+            __m256i sumC   = _mm256_xor_si256(s, se);
+            __m256i carryC = _mm256_and_si256(s, se);
+            fullAdd256(sumA, sumB, sumC, ones, carryD);
+            fullAdd256(carryA, carryB, carryC, twosPartial, carryE);
+            __m256i twos  = _mm256_xor_si256(twosPartial, carryD);
+            __m256i fours  = _mm256_xor_si256(carryE, _mm256_and_si256(twosPartial, carryD));
+            __m256i eights = _mm256_and_si256(carryE, _mm256_and_si256(twosPartial, carryD));
+
+            __m256i next = applyRule256(centre, ones, twos, fours, eights, birth, survival);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), next);
+        }
+
+        evolveRowEdges<Boundary>(above, row, below, out, words, cols, lastMask, beginWord, endWord, begin, i, birth, survival);
+    }
+
+    __attribute__((target("avx512f")))
+    inline void loadNeighbours512(const Word *data, int i, __m512i &west, __m512i &centre, __m512i &east)
+    {
+        __m512i previous = _mm512_loadu_si512(data + i - 1);
+        __m512i next     = _mm512_loadu_si512(data + i + 1);
+        centre = _mm512_loadu_si512(data + i);
+        west   = _mm512_or_si512(_mm512_slli_epi64(centre, 1), _mm512_srli_epi64(previous, 63));
+        east   = _mm512_or_si512(_mm512_srli_epi64(centre, 1), _mm512_slli_epi64(next, 63));
+    }
+
+    __attribute__((target("avx512f")))
+    inline void fullAdd512(__m512i a, __m512i b, __m512i c, __m512i &sum, __m512i &carry)
+    {
+        // The ternary logic immediates are the truth tables of a ^ b ^ c and majority(a, b, c).
+        sum   = _mm512_ternarylogic_epi64(a, b, c, 0x96);
+        carry = _mm512_ternarylogic_epi64(a, b, c, 0xE8);
+    }
+
+    __attribute__((target("avx512f")))
+    inline __m512i applyRule512(__m512i centre, __m512i ones, __m512i twos, __m512i fours, __m512i eights, 
+                                unsigned birth, unsigned survival)
+    {
+        // twos & ~fours & (ones | centre) in a single instruction.
+        if(birth == ConwayRule::birth && survival == ConwayRule::survival)
+        {
+            return _mm512_ternarylogic_epi64(twos, fours, _mm512_or_si512(ones, centre), 0x20);
+        }
+
+        // See applyRule, the complemented planes are formed once up front.
+        const __m512i allSet = _mm512_set1_epi64(-1);
+        const __m512i planes[4][2] = {
+            {_mm512_xor_si512(ones, allSet), ones}, {_mm512_xor_si512(twos, allSet), twos},
+            {_mm512_xor_si512(fours, allSet), fours}, {_mm512_xor_si512(eights, allSet), eights}};
+        const __m512i deadCells = _mm512_xor_si512(centre, allSet);
+
+        __m512i next = _mm512_setzero_si512();
+        for(int count = 0; count <= 8; ++count)
+        {
+            bool born     = (birth >> count) & 1;
+            bool survives = (survival >> count) & 1;
+            if(born || survives)
+            {
+                __m512i matches = _mm512_and_si512(
+                    _mm512_and_si512(planes[0][count & 1], planes[1][(count >> 1) & 1]),
+                    _mm512_and_si512(planes[2][(count >> 2) & 1], planes[3][(count >> 3) & 1]));
+                __m512i cells = born ? (survives ? allSet : deadCells) : centre;
+                next = _mm512_or_si512(next, _mm512_and_si512(matches, cells));
+            }
+        }
+
+        return next;
+    }
+
+    template<class Boundary, class RuleType>
+    __attribute__((target("avx512f")))
+    void evolveRowAvx512(const Word *above, const Word *row, const Word *below, Word *out, int words, int cols, 
+                       Word lastMask, int beginWord, int endWord)
+    {
+        const unsigned birth    = RuleMasks<RuleType>::birth();
+        const unsigned survival = RuleMasks<RuleType>::survival();
+
+        // Process 8 interior words per iteration, word 0 and the last word need the boundary handling.
+        int begin, end;
+        interiorRange(words, beginWord, endWord, begin, end);
+        int i = begin;
+        for(; i + 8 <= end; i += 8)
+        {
+            __m512i nw, n, ne, w, centre, e, sw, s, se;
+            loadNeighbours512(above, i, nw, n, ne);
+            loadNeighbours512(row,   i, w, centre, e);
+            loadNeighbours512(below, i, sw, s, se);
+
+            __m512i sumA, carryA, sumB, carryB, ones, carryD, twosPartial, carryE;
+            fullAdd512(nw, n, ne, sumA, carryA);
+            fullAdd512(w, e, sw, sumB, carryB);
+            __m512i sumC   = _mm512_xor_si512(s, se);
+            __m512i carryC = _mm512_and_si512(s, se);
+            fullAdd512(sumA, sumB, sumC, ones, carryD);
+            fullAdd512(carryA, carryB, carryC, twosPartial, carryE);
+            __m512i twos  = _mm512_xor_si512(twosPartial, carryD);
+            __m512i fours  = _mm512_xor_si512(carryE, _mm512_and_si512(twosPartial, carryD));
+            __m512i eights = _mm512_ternarylogic_epi64(carryE, twosPartial, carryD, 0x80);
+
+            __m512i next = applyRule512(centre, ones, twos, fours, eights, birth, survival);
+            _mm512_storeu_si512(out + i, next);
+        }
+
+        evolveRowEdges<Boundary>(above, row, below, out, words, cols, lastMask, beginWord, endWord, begin, i, birth, survival);
+    }
+
+    /// Vectors of 4 and 8 words, GCC lowers the operators on them to AVX2 and AVX-512 instructions
+    /// in the functions that target those instruction sets.
+    typedef Word Word4 __attribute__((vector_size(32)));
+    typedef Word Word8 __attribute__((vector_size(64)));
+
+    /**
+     *\brief Loads a Word or a vector of words from memory that need not be aligned.
+     *\param data words to load.
+     *\param value will hold the words.
+     */
+    template<class Vector>
+    inline __attribute__((always_inline)) void loadWords(const Word *data, Vector &value)
+    {
+        std::memcpy(&value, data, sizeof(Vector));
+    }
+
+    /**
+     *\brief Stores a Word or a vector of words to memory that need not be aligned.
+     *\param data words to store to.
+     *\param value words to store.
+     */
+    template<class Vector>
+    inline __attribute__((always_inline)) void storeWords(Word *data, const Vector &value)
+    {
+        std::memcpy(data, &value, sizeof(Vector));
+    }
+
+    /**
+     *\brief Version of fullAdd() for a Word or a vector of words.
+     */
+    template<class Vector>
+    inline __attribute__((always_inline)) void fullAddWords(const Vector &a, const Vector &b, const Vector &c, Vector &sum, Vector &carry)
+    {
+        Vector partial = a ^ b;
+        sum   = partial ^ c;
+        carry = (a & b) | (partial & c);
+    }
+
+    /**
+     *\brief Applies a Life-like rule given the bit planes of the number of live cells in each 3x3 block.
+     *\param centre the current state of the cells.
+     *\param ones ones bit of the counts, which include the cell itself.
+     *\param twos twos bit of the counts.
+     *\param fours fours bit of the counts.
+     *\param eights eights bit of the counts.
+     *\param birth mask of the neighbour counts at which a dead cell is born.
+     *\param survival mask of the neighbour counts at which a live cell survives.
+     *\param next will hold the next state of the cells.
+     *
+     * A live cell counts itself so it survives with a count one higher than its neighbour count.
+     */
+    template<class Vector>
+    inline __attribute__((always_inline)) void applyBlockRule(const Vector &centre, const Vector &ones, const Vector &twos, const Vector &fours, 
+                                                              const Vector &eights, unsigned birth, unsigned survival, Vector &next)
+    {
+        // Alive next time if the block holds 3 cells, or 4 and the cell itself is one of them.
+        if(birth == ConwayRule::birth && survival == ConwayRule::survival)
+        {
+            next = (ones & twos & ~fours) | (centre & fours & ~(ones | twos));
+            return;
+        }
+
+        // Otherwise match each count in the rule against the bit planes as applyRule() does.
+        next = Vector();
+        for(int count = 0; count <= 9; ++count)
+        {
+            bool born     = (birth >> count) & 1;
+            bool survives = count > 0 && ((survival >> (count - 1)) & 1);
+            if(born || survives)
+            {
+                Vector matches = ((count & 1) ? ones : ~ones) & ((count & 2) ? twos : ~twos) 
+                               & ((count & 4) ? fours : ~fours) & ((count & 8) ? eights : ~eights);
+                next |= matches & (born ? (survives ? ~Vector() : ~centre) : centre);
+            }
+        }
+    }
+
+    /**
+     *\brief Evolves one row of a vector of words from the column sums about it.
+     *\param sumOnes ones bit of the sum of each column of three cells about the row.
+     *\param sumTwos twos bit of the sum of each column of three cells about the row.
+     *\param row words of the row being evolved.
+     *\param out words the evolved row is written to.
+     *\param birth mask of the neighbour counts at which a dead cell is born.
+     *\param survival mask of the neighbour counts at which a live cell survives.
+     *
+     * Each column sum is shifted one cell each way and added to itself, so it is worked out once
+     * and shared by the three cells whose blocks it is part of.
+     */
+    template<class Vector>
+    inline __attribute__((always_inline)) void evolveFromColumnSums(const Word *sumOnes, const Word *sumTwos, const Word *row, Word *out, 
+                                                                    unsigned birth, unsigned survival)
+    {
+        Vector onesWest, onesCentre, onesEast, twosWest, twosCentre, twosEast;
+        loadWords(sumOnes - 1, onesWest);
+        loadWords(sumOnes,     onesCentre);
+        loadWords(sumOnes + 1, onesEast);
+        loadWords(sumTwos - 1, twosWest);
+        loadWords(sumTwos,     twosCentre);
+        loadWords(sumTwos + 1, twosEast);
+        onesWest = (onesCentre << 1) | (onesWest >> 63);
+        onesEast = (onesCentre >> 1) | (onesEast << 63);
+        twosWest = (twosCentre << 1) | (twosWest >> 63);
+        twosEast = (twosCentre >> 1) | (twosEast << 63);
+
+        // The block count is low + 2 * (lowCarry + high) + 4 * highCarry.
+        Vector low, lowCarry, high, highCarry;
+        fullAddWords(onesWest, onesCentre, onesEast, low, lowCarry);
+        fullAddWords(twosWest, twosCentre, twosEast, high, highCarry);
+        Vector carry  = lowCarry & high;
+        Vector twos   = lowCarry ^ high;
+        Vector fours  = highCarry ^ carry;
+        Vector eights = highCarry & carry;
+
+        Vector centre, next;
+        loadWords(row, centre);
+        applyBlockRule(centre, low, twos, fours, eights, birth, survival, next);
+        storeWords(out, next);
+    }
+
+    /**
+     *\brief Evolves two neighbouring rows of a halo padded board a vector of words at a time.
+     *\tparam Vector Word or vector of words to work in.
+     *\tparam RuleType StaticRule the kernel is specialised for, or Rule for the active rule.
+     *
+     * See PaddedKernel for a description of the parameters. The first pass adds up each column
+     * of three cells about both rows, sharing the sum of the two middle rows between them, and
+     * the second pass combines neighbouring column sums. Neither pass has any branches.
+     */
+    template<class Vector, class RuleType>
+    inline __attribute__((always_inline)) void evolvePaddedRows(const Word *above, const Word *first, const Word *second, const Word *below, 
+                                                                Word *firstOut, Word *secondOut, Word *scratch, int beginWord, int endWord)
+    {
+        const unsigned birth    = RuleMasks<RuleType>::birth();
+        const unsigned survival = RuleMasks<RuleType>::survival();
+
+        // The column sums cover a vector either side of the range so the shifts can read them.
+        const int lanes  = static_cast<int>(sizeof(Vector) / sizeof(Word));
+        const int span   = (endWord - beginWord + lanes - 1) / lanes * lanes;
+        const int stride = span + 2 * lanes;
+        Word *firstOnes  = scratch + lanes;
+        Word *firstTwos  = firstOnes + stride;
+        Word *secondOnes = firstTwos + stride;
+        Word *secondTwos = secondOnes + stride;
+
+        for(int i = -lanes; i < span + lanes; i += lanes)
+        {
+            Vector a, b, c, d;
+            loadWords(above  + beginWord + i, a);
+            loadWords(first  + beginWord + i, b);
+            loadWords(second + beginWord + i, c);
+            loadWords(below  + beginWord + i, d);
+
+            Vector pairOnes = b ^ c;
+            Vector pairTwos = b & c;
+            storeWords(firstOnes  + i, a ^ pairOnes);
+            storeWords(firstTwos  + i, pairTwos | (a & pairOnes));
+            storeWords(secondOnes + i, d ^ pairOnes);
+            storeWords(secondTwos + i, pairTwos | (d & pairOnes));
+        }
+
+        for(int i = 0; i < span; i += lanes)
+        {
+            evolveFromColumnSums<Vector>(firstOnes + i, firstTwos + i, first + beginWord + i, firstOut + beginWord + i, birth, survival);
+            evolveFromColumnSums<Vector>(secondOnes + i, secondTwos + i, second + beginWord + i, secondOut + beginWord + i, birth, survival);
+        }
+    }
+
+    template<class RuleType>
+    void evolvePaddedScalar(const Word *above, const Word *first, const Word *second, const Word *below, 
+                            Word *firstOut, Word *secondOut, Word *scratch, int beginWord, int endWord)
+    {
+        evolvePaddedRows<Word, RuleType>(above, first, second, below, firstOut, secondOut, scratch, beginWord, endWord);
+    }
+
+    template<class RuleType>
+    __attribute__((target("avx2")))
+    void evolvePaddedAvx2(const Word *above, const Word *first, const Word *second, const Word *below, 
+                          Word *firstOut, Word *secondOut, Word *scratch, int beginWord, int endWord)
+    {
+        evolvePaddedRows<Word4, RuleType>(above, first, second, below, firstOut, secondOut, scratch, beginWord, endWord);
+    }
+
+    template<class RuleType>
+    __attribute__((target("avx512f")))
+    void evolvePaddedAvx512(const Word *above, const Word *first, const Word *second, const Word *below, 
+                            Word *firstOut, Word *secondOut, Word *scratch, int beginWord, int endWord)
+    {
+        evolvePaddedRows<Word8, RuleType>(above, first, second, below, firstOut, secondOut, scratch, beginWord, endWord);
+    }
+
+    /// Kernel used by update(), chosen the first time it is needed.
+    KernelType& activeKernelStorage()
+    {
+        static KernelType type = bestKernel();
+        return type;
+    }
+}
+
+bool isKernelSupported(KernelType type)
+{
+    switch(type)
+    {
+        case KernelType::Avx512:
+            return __builtin_cpu_supports("avx512f");
+        case KernelType::Avx2:
+            return __builtin_cpu_supports("avx2");
+        default:
+            return true;
+    }
+}
+
+KernelType bestKernel()
+{
+    if(isKernelSupported(KernelType::Avx512))
+    {
+        return KernelType::Avx512;
+    }
+    if(isKernelSupported(KernelType::Avx2))
+    {
+        return KernelType::Avx2;
+    }
+    return KernelType::Scalar;
+}
+
+namespace
+{
+    /**
+     *\brief Gets the function implementing a kernel for a given rule.
+     *\tparam Boundary BoundaryPolicy deciding what lies beyond the ends of the row.
+     *\tparam RuleType StaticRule the kernel is specialised for, or Rule for the active rule.
+     *\param type KernelType of the kernel.
+     *\return RowKernel function pointer.
+     */
+    template<class Boundary, class RuleType>
+    RowKernel getRuleKernel(KernelType type)
+    {
+        switch(type)
+        {
+            case KernelType::Avx512:
+                return evolveRowAvx512<Boundary, RuleType>;
+            case KernelType::Avx2:
+                return evolveRowAvx2<Boundary, RuleType>;
+            default:
+                return evolveRowScalar<Boundary, RuleType>;
+        }
+    }
+}
+
+template<class Boundary>
+RowKernel getRowKernel(KernelType type)
+{
+    // Use a kernel specialised for the active rule where there is one.
+    const Rule &rule = activeRule();
+    if(rule.is<ConwayRule>())
+    {
+        return getRuleKernel<Boundary, ConwayRule>(type);
+    }
+    if(rule.is<HighLifeRule>())
+    {
+        return getRuleKernel<Boundary, HighLifeRule>(type);
+    }
+    if(rule.is<DayAndNightRule>())
+    {
+        return getRuleKernel<Boundary, DayAndNightRule>(type);
+    }
+    if(rule.is<SeedsRule>())
+    {
+        return getRuleKernel<Boundary, SeedsRule>(type);
+    }
+    return getRuleKernel<Boundary, Rule>(type);
+}
+
+namespace
+{
+    /**
+     *\brief Gets the function implementing a padded kernel for a given rule.
+     *\tparam RuleType StaticRule the kernel is specialised for, or Rule for the active rule.
+     *\param type KernelType of the kernel.
+     *\return PaddedKernel function pointer.
+     */
+    template<class RuleType>
+    PaddedKernel getPaddedRuleKernel(KernelType type)
+    {
+        switch(type)
+        {
+            case KernelType::Avx512:
+                return evolvePaddedAvx512<RuleType>;
+            case KernelType::Avx2:
+                return evolvePaddedAvx2<RuleType>;
+            default:
+                return evolvePaddedScalar<RuleType>;
+        }
+    }
+}
+
+PaddedKernel getPaddedKernel(KernelType type)
+{
+    const Rule &rule = activeRule();
+    if(rule.is<ConwayRule>())
+    {
+        return getPaddedRuleKernel<ConwayRule>(type);
+    }
+    if(rule.is<HighLifeRule>())
+    {
+        return getPaddedRuleKernel<HighLifeRule>(type);
+    }
+    if(rule.is<DayAndNightRule>())
+    {
+        return getPaddedRuleKernel<DayAndNightRule>(type);
+    }
+    if(rule.is<SeedsRule>())
+    {
+        return getPaddedRuleKernel<SeedsRule>(type);
+    }
+    return getPaddedRuleKernel<Rule>(type);
+}
+
+template RowKernel getRowKernel<Toroidal>(KernelType type);
+template RowKernel getRowKernel<DeadEdge>(KernelType type);
+template RowKernel getRowKernel<Unbounded>(KernelType type);
+
+KernelType activeKernel()
+{
+    return activeKernelStorage();
+}
+
+void setActiveKernel(KernelType type)
+{
+    activeKernelStorage() = type;
+}
+
+const char* kernelName(KernelType type)
+{
+    switch(type)
+    {
+        case KernelType::Avx512:
+            return "avx512";
+        case KernelType::Avx2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef EvolveKernels_hpp
+#define EvolveKernels_hpp
+
+#include <cstdint> // For fixed width words holding packed cells.
+#include "BoundaryPolicy.hpp"
+
+/**
+ * \file
+ * \brief Row kernels that evolve packed rows of cells by one generation.
+ *
+ * Each kernel evolves a range of words of one row given the packed words of the rows above and 
+ * below it, with the boundary conditions along the row chosen by a BoundaryPolicy. Several implementations are provided that use 
+ * different instruction sets, they all produce bit-identical results and the fastest one the 
+ * CPU supports is selected at runtime.
+ */
+
+/**
+ * \enum KernelType
+ * \brief Enumeration type to identify the instruction set a row kernel uses.
+ */
+enum class KernelType
+{
+    Scalar,
+    Avx2,
+    Avx512,
+};
+
+/**
+ *\brief Signature shared by all the row kernels.
+ *\param above words of the row above.
+ *\param row words of the row being evolved.
+ *\param below words of the row below.
+ *\param out words the evolved row is written to, must not alias the input rows.
+ *\param words number of words in each row.
+ *\param cols number of columns in each row.
+ *\param lastMask mask of the used bits of the final word of the row.
+ *\param beginWord first word of the row to evolve.
+ *\param endWord word one past the last word of the row to evolve, words outside of the range are not written.
+ */
+typedef void (*RowKernel)(const std::uint64_t *above, const std::uint64_t *row, const std::uint64_t *below, 
+                          std::uint64_t *out, int words, int cols, std::uint64_t lastMask, int beginWord, int endWord);
+
+/// Number of words either side of the range of a PaddedKernel that must be readable, the kernels also write up to this many words past the end of the range.
+constexpr int paddedKernelSlack = 16;
+
+/**
+ *\brief Signature shared by the kernels that evolve two neighbouring rows of a halo padded board.
+ *\param above words of the row above the first row.
+ *\param first words of the first row being evolved.
+ *\param second words of the second row being evolved, the row below first.
+ *\param below words of the row below the second row.
+ *\param firstOut words the evolved first row is written to.
+ *\param secondOut words the evolved second row is written to.
+ *\param scratch buffer of at least 4 * (endWord - beginWord + 2 * paddedKernelSlack) words the column sums are kept in.
+ *\param beginWord first word of the rows to evolve.
+ *\param endWord word one past the last word of the rows to evolve.
+ *
+ * The rows must be padded so that the words around the range hold the neighbouring cells, the
+ * kernel never wraps or masks anything. The range is evolved a whole vector at a time so the
+ * words up to paddedKernelSlack past endWord may be overwritten with meaningless values.
+ */
+typedef void (*PaddedKernel)(const std::uint64_t *above, const std::uint64_t *first, const std::uint64_t *second, const std::uint64_t *below, 
+                             std::uint64_t *firstOut, std::uint64_t *secondOut, std::uint64_t *scratch, int beginWord, int endWord);
+
+/**
+ *\brief Checks whether the CPU running the program can execute a kernel.
+ *\param type KernelType to check.
+ *\return boolean value representing whether the kernel can be used.
+ */
+bool isKernelSupported(KernelType type);
+
+/**
+ *\brief Finds the fastest kernel supported by the CPU running the program.
+ *\return KernelType of the fastest supported kernel.
+ */
+KernelType bestKernel();
+
+/**
+ *\brief Gets the function implementing a kernel.
+ *\tparam Boundary BoundaryPolicy deciding what lies beyond the ends of the row.
+ *\param type KernelType of the kernel, it must be supported by the CPU.
+ *\return RowKernel function pointer.
+ */
+template<class Boundary = Toroidal>
+RowKernel getRowKernel(KernelType type);
+
+/**
+ *\brief Gets the function implementing a kernel for halo padded rows.
+ *\param type KernelType of the kernel, it must be supported by the CPU.
+ *\return PaddedKernel function pointer.
+ */
+PaddedKernel getPaddedKernel(KernelType type);
+
+/**
+ *\brief Gets the kernel used by update(), this is the best supported kernel unless overridden.
+ *\return KernelType of the active kernel.
+ */
+KernelType activeKernel();
+
+/**
+ *\brief Overrides the kernel used by update().
+ *\param type KernelType to use, it must be supported by the CPU.
+ */
+void setActiveKernel(KernelType type);
+
+/**
+ *\brief Gets a human readable name for a kernel.
+ *\param type KernelType to name.
+ *\return C-string holding the name.
+ */
+const char* kernelName(KernelType type);
+
+#endif /* EvolveKernels_hpp */
@@ -0,0 +1,244 @@
+#include "FrameRenderer.hpp"
+#include "Metrics.hpp"
+#include <algorithm> // For std::min, std::fill_n and std::mismatch.
+#include <utility> // For std::swap.
+#include <cerrno> // For errno.
+#include <unistd.h> // For write.
+
+namespace
+{
+    /**
+     *\brief Reads one cell from a packed row.
+     *\param row pointer to the packed words of the row, or nullptr for a row beyond the board.
+     *\param col column of the cell.
+     *\return 1 if the cell is alive and 0 otherwise.
+     */
+    inline unsigned cellAt(const LifeBoard::Word *row, int col)
+    {
+        return row ? static_cast<unsigned>((row[col / LifeBoard::cellsPerWord] >> (col % LifeBoard::cellsPerWord)) & 1) : 0;
+    }
+
+    /**
+     *\brief Reads a word from a packed row.
+     *\param row pointer to the packed words of the row, or nullptr for a row beyond the board.
+     *\param word index of the word.
+     *\return the word, 0 for a row beyond the board.
+     */
+    inline LifeBoard::Word wordAt(const LifeBoard::Word *row, int word)
+    {
+        return row ? row[word] : 0;
+    }
+}
+
+FrameRenderer::FrameRenderer(int descriptor, RenderMode mode, bool diff) :
+m_descriptor{descriptor},
+m_mode{mode},
+m_diff{diff},
+m_lineCount{0},
+m_glyphCount{0},
+m_linesDrawn{0}
+{}
+
+void FrameRenderer::reset()
+{
+    m_linesDrawn = 0;
+}
+
+bool FrameRenderer::buildGlyphs(const LifeBoard &board)
+{
+    int rows = board.getRows();
+    int cols = board.getCols();
+    int words = board.getWordsPerRow();
+
+    // Each mode packs a different block of cells into a glyph.
+    int rowsPerGlyph = (m_mode == RenderMode::Cells) ? 1 : (m_mode == RenderMode::HalfBlock) ? 2 : 4;
+    int colsPerGlyph = (m_mode == RenderMode::Braille) ? 2 : 1;
+    int lineCount  = (rows + rowsPerGlyph - 1) / rowsPerGlyph;
+    int glyphCount = (cols + colsPerGlyph - 1) / colsPerGlyph;
+
+    bool sameShape = (lineCount == m_lineCount && glyphCount == m_glyphCount);
+    if(!sameShape)
+    {
+        m_lineCount  = lineCount;
+        m_glyphCount = glyphCount;
+        m_glyphs.assign(static_cast<std::size_t>(lineCount) * glyphCount, 0);
+        m_previousGlyphs.assign(m_glyphs.size(), 0);
+
+        // Enough for every glyph at its longest plus the cursor movements, so frames never reallocate.
+        m_buffer.reserve(static_cast<std::size_t>(lineCount) * (3 * glyphCount + 24) + 24);
+    }
+
+    int glyphsPerWord = LifeBoard::cellsPerWord / colsPerGlyph;
+    for(int line = 0; line < lineCount; ++line)
+    {
+        const LifeBoard::Word *cells[4] = {nullptr, nullptr, nullptr, nullptr};
+        for(int i = 0; i < rowsPerGlyph && line * rowsPerGlyph + i < rows; ++i)
+        {
+            cells[i] = board.rowData(line * rowsPerGlyph + i);
+        }
+
+        std::uint8_t *glyphs = &m_glyphs[static_cast<std::size_t>(line) * glyphCount];
+        for(int word = 0; word < words; ++word)
+        {
+            int begin = word * glyphsPerWord;
+            int end = std::min(glyphCount, begin + glyphsPerWord);
+
+            // Dead words are common so they are cleared in one go.
+            if((wordAt(cells[0], word) | wordAt(cells[1], word) | wordAt(cells[2], word) | wordAt(cells[3], word)) == 0)
+            {
+                std::fill_n(glyphs + begin, end - begin, 0);
+                continue;
+            }
+
+            for(int glyph = begin; glyph < end; ++glyph)
+            {
+                int col = glyph * colsPerGlyph;
+                switch(m_mode)
+                {
+                    case RenderMode::Cells:
+                        glyphs[glyph] = static_cast<std::uint8_t>(cellAt(cells[0], col));
+                        break;
+                    case RenderMode::HalfBlock:
+                        glyphs[glyph] = static_cast<std::uint8_t>(cellAt(cells[0], col) | cellAt(cells[1], col) << 1);
+                        break;
+                    case RenderMode::Braille:
+                        // Dots 1-3 and 7 run down the left column, dots 4-6 and 8 down the right.
+                        glyphs[glyph] = static_cast<std::uint8_t>(
+                            cellAt(cells[0], col)          | cellAt(cells[1], col) << 1     | cellAt(cells[2], col) << 2     |
+                            cellAt(cells[0], col + 1) << 3 | cellAt(cells[1], col + 1) << 4 | cellAt(cells[2], col + 1) << 5 |
+                            cellAt(cells[3], col) << 6     | cellAt(cells[3], col + 1) << 7);
+                        break;
+                }
+            }
+        }
+    }
+
+    return sameShape;
+}
+
+void FrameRenderer::appendGlyphs(const std::uint8_t *glyphs, int count)
+{
+    // Make room for the longest encoding then write the bytes directly, trimming any room left over.
+    std::size_t start = m_buffer.size();
+    m_buffer.resize(start + 3 * static_cast<std::size_t>(count));
+    char *out = &m_buffer[start];
+
+    for(int i = 0; i < count; ++i)
+    {
+        switch(m_mode)
+        {
+            case RenderMode::Cells:
+                *out++ = LifeBoard::stateSymbols[glyphs[i]];
+                *out++ = ' ';
+                break;
+            case RenderMode::HalfBlock:
+                // The blank is a plain space, the blocks are U+2580, U+2584 and U+2588.
+                if(glyphs[i] == 0)
+                {
+                    *out++ = ' ';
+                }
+                else
+                {
+                    *out++ = '\xE2';
+                    *out++ = '\x96';
+                    *out++ = static_cast<char>(0x80 + 4 * (glyphs[i] - 1));
+                }
+                break;
+            case RenderMode::Braille:
+                // UTF-8 encoding of U+2800 plus the dot pattern.
+                *out++ = '\xE2';
+                *out++ = static_cast<char>(0xA0 | (glyphs[i] >> 6));
+                *out++ = static_cast<char>(0x80 | (glyphs[i] & 0x3F));
+                break;
+        }
+    }
+
+    m_buffer.resize(static_cast<std::size_t>(out - m_buffer.data()));
+}
+
+void FrameRenderer::appendCursorMove(int lines)
+{
+    if(lines != 0)
+    {
+        m_buffer += "\e[";
+        m_buffer += std::to_string(lines < 0 ? -lines : lines);
+        m_buffer += (lines < 0) ? 'A' : 'B';
+    }
+}
+
+const std::string& FrameRenderer::buildFrame(const LifeBoard &board)
+{
+    bool sameShape = buildGlyphs(board);
+    m_buffer.clear();
+
+    if(m_diff && sameShape && m_linesDrawn == m_lineCount)
+    {
+        // The cursor sits below the last frame, visit each line that changed and redraw the changed span.
+        int cursorLine = m_lineCount;
+        int columnsPerGlyph = (m_mode == RenderMode::Cells) ? 2 : 1;
+        for(int line = 0; line < m_lineCount; ++line)
+        {
+            const std::uint8_t *glyphs = &m_glyphs[static_cast<std::size_t>(line) * m_glyphCount];
+            const std::uint8_t *previous = &m_previousGlyphs[static_cast<std::size_t>(line) * m_glyphCount];
+
+            int first = static_cast<int>(std::mismatch(glyphs, glyphs + m_glyphCount, previous).first - glyphs);
+            if(first == m_glyphCount)
+            {
+                continue;
+            }
+            int last = m_glyphCount;
+            while(glyphs[last - 1] == previous[last - 1])
+            {
+                --last;
+            }
+
+            appendCursorMove(line - cursorLine);
+            m_buffer += "\e[";
+            m_buffer += std::to_string(first * columnsPerGlyph + 1);
+            m_buffer += 'G';
+            appendGlyphs(glyphs + first, last - first);
+            cursorLine = line;
+        }
+        appendCursorMove(m_lineCount - cursorLine);
+        m_buffer += '\r';
+    }
+    else
+    {
+        // Go back to the top of the last frame and draw every line.
+        appendCursorMove(-m_linesDrawn);
+        m_buffer += '\r';
+        for(int line = 0; line < m_lineCount; ++line)
+        {
+            appendGlyphs(&m_glyphs[static_cast<std::size_t>(line) * m_glyphCount], m_glyphCount);
+            m_buffer += '\n';
+        }
+        m_linesDrawn = m_lineCount;
+    }
+
+    std::swap(m_glyphs, m_previousGlyphs);
+    return m_buffer;
+}
+
+bool FrameRenderer::render(const LifeBoard &board)
+{
+    const std::string &frame = buildFrame(board);
+
+    // A terminal normally takes the whole frame at once, only carry on after a partial write.
+    std::size_t sent = 0;
+    while(sent < frame.size())
+    {
+        ssize_t written = write(m_descriptor, frame.data() + sent, frame.size() - sent);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        sent += static_cast<std::size_t>(written);
+    }
+    METRICS_COUNT(Counter::BytesWritten, sent);
+
+    return true;
+}
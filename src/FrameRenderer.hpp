@@ -0,0 +1,121 @@
+#ifndef FrameRenderer_hpp
+#define FrameRenderer_hpp
+
+#include <vector> // For holding the glyphs of the frames.
+#include <string> // For holding the bytes of a frame.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+
+/**
+ * \file
+ * \brief Class to model a renderer that draws boards on a terminal a frame at a time.
+ *
+ * Each frame is first reduced to a grid of glyph codes straight from the packed words of the 
+ * board, skipping dead words, then encoded into a single byte buffer that is reused between 
+ * frames and sent to the terminal with one write() call. The glyph grid of the previous frame is 
+ * kept, so in diff mode only the span of each line that changed is sent. The downsampled modes 
+ * draw several cells per glyph so boards larger than the terminal can still be watched.
+ *
+ * The frame is drawn from the cursor position the first frame started at, so nothing else should 
+ * be written to the terminal between frames.
+ */
+
+/**
+ * \enum RenderMode
+ * \brief Enumeration type to identify how cells are drawn on the terminal.
+ */
+enum class RenderMode
+{
+    Cells,     ///< One cell per glyph, drawn as LifeBoard::stateSymbols followed by a space like operator<<.
+    HalfBlock, ///< Two rows of cells per glyph using the Unicode half block characters.
+    Braille,   ///< Four rows and two columns of cells per glyph using the Unicode braille patterns.
+};
+
+/**
+ * \class FrameRenderer
+ * \brief Draws boards on a terminal in the chosen RenderMode, see the file description.
+ */
+class FrameRenderer
+{
+private:
+    /// Member variable that holds the file descriptor frames are written to.
+    int m_descriptor;
+
+    /// Member variable that holds how the cells are drawn.
+    RenderMode m_mode;
+
+    /// Member variable that holds whether only the changes since the last frame are sent.
+    bool m_diff;
+
+    /// Member variable that holds the number of lines of glyphs in the frame.
+    int m_lineCount;
+
+    /// Member variable that holds the number of glyphs in each line of the frame.
+    int m_glyphCount;
+
+    /// Member variable that holds the number of lines drawn so far, 0 before the first frame.
+    int m_linesDrawn;
+
+    /// Member variable that holds the glyph codes of the frame being drawn.
+    std::vector<std::uint8_t> m_glyphs;
+
+    /// Member variable that holds the glyph codes of the last frame drawn.
+    std::vector<std::uint8_t> m_previousGlyphs;
+
+    /// Member variable that holds the bytes of the frame being sent.
+    std::string m_buffer;
+
+    /**
+     *\brief Fills the glyph grid from a board, resizing it if the board has changed size.
+     *\param board LifeBoard object to draw.
+     *\return true if the grid kept the size of the last frame.
+     */
+    bool buildGlyphs(const LifeBoard &board);
+
+    /**
+     *\brief Adds the bytes for a run of glyphs to the buffer.
+     *\param glyphs pointer to the first glyph code.
+     *\param count number of glyphs.
+     */
+    void appendGlyphs(const std::uint8_t *glyphs, int count);
+
+    /**
+     *\brief Adds the escape sequence to move the cursor a number of lines up or down.
+     *\param lines number of lines to move, negative to move up.
+     */
+    void appendCursorMove(int lines);
+
+public:
+    /**
+     *\brief Constructor that sets up a renderer with an empty frame.
+     *\param descriptor file descriptor to write frames to, usually standard output.
+     *\param mode RenderMode used to draw cells.
+     *\param diff whether to only send the changes since the last frame.
+     */
+    explicit FrameRenderer(int descriptor, RenderMode mode = RenderMode::Cells, bool diff = false);
+
+    /**
+     *\brief Builds the bytes that draw a board without sending them.
+     *
+     * The bytes move the cursor back to the top of the last frame first, so the renderer 
+     * considers them drawn and the next frame is built relative to this one.
+     *
+     *\param board LifeBoard object to draw.
+     *\return constant reference to the buffer holding the bytes of the frame.
+     */
+    const std::string& buildFrame(const LifeBoard &board);
+
+    /**
+     *\brief Draws a board on the terminal with a single write.
+     *\param board LifeBoard object to draw.
+     *\return true if the whole frame was written.
+     */
+    bool render(const LifeBoard &board);
+
+    /**
+     *\brief Forgets the last frame so the next one is drawn in full from the cursor position.
+     */
+    void reset();
+};
+
+#endif /* FrameRenderer_hpp */
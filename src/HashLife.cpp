@@ -0,0 +1,478 @@
+#include "HashLife.hpp"
+#include <algorithm> // For std::max and std::min.
+#include <limits> // For std::numeric_limits.
+
+constexpr std::size_t HashLife::defaultMaxNodes;
+
+namespace
+{
+    /// Marker for entries of the empty node table that have not been created yet.
+    constexpr HashLife::NodeIndex noNode = std::numeric_limits<HashLife::NodeIndex>::max();
+
+    /**
+     *\brief Checks whether a square region of a board holds any live cells.
+     *\param board LifeBoard to check.
+     *\param row first row of the region.
+     *\param col first column of the region, must be a multiple of LifeBoard::cellsPerWord.
+     *\param size width and height of the region, must be a multiple of LifeBoard::cellsPerWord.
+     *\return boolean value representing the result of the query.
+     */
+    bool regionHasLife(const LifeBoard &board, std::int64_t row, std::int64_t col, std::int64_t size)
+    {
+        std::int64_t endRow  = std::min<std::int64_t>(row + size, board.getRows());
+        std::int64_t endWord = std::min<std::int64_t>((col + size) / LifeBoard::cellsPerWord, board.getWordsPerRow());
+
+        for(std::int64_t i = row; i < endRow; ++i)
+        {
+            const LifeBoard::Word *words = board.rowData(static_cast<int>(i));
+            for(std::int64_t word = col / LifeBoard::cellsPerWord; word < endWord; ++word)
+            {
+                if(words[word])
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+}
+
+bool HashLife::NodeKey::operator==(const NodeKey &other) const
+{
+    return nw == other.nw && ne == other.ne && sw == other.sw && se == other.se;
+}
+
+std::size_t HashLife::NodeKeyHash::operator()(const NodeKey &key) const
+{
+    // Mix each child in with a different odd multiplier so the order of the children matters.
+    std::uint64_t hash = key.nw * 0x9E3779B97F4A7C15ull;
+    hash ^= key.ne * 0xC2B2AE3D27D4EB4Full + (hash >> 29);
+    hash ^= key.sw * 0x165667B19E3779F9ull + (hash >> 32);
+    hash ^= key.se * 0xD6E8FEB86659FD93ull + (hash >> 29);
+    return static_cast<std::size_t>(hash);
+}
+
+HashLife::HashLife(std::size_t maxNodes) :
+m_root{0},
+m_originRow{0},
+m_originCol{0},
+m_generation{0},
+m_maxNodes{maxNodes},
+m_rule(activeRule())
+{
+    // The two level 0 nodes are the dead and alive cells.
+    m_nodes.push_back(Node{0, 0, 0, 0, 0, 0});
+    m_nodes.push_back(Node{0, 0, 0, 0, 1, 0});
+
+    m_root = emptyNode(1);
+}
+
+HashLife::HashLife(const LifeBoard &board, std::size_t maxNodes) : 
+HashLife(maxNodes)
+{
+    setBoard(board);
+}
+
+HashLife::NodeIndex HashLife::join(NodeIndex nw, NodeIndex ne, NodeIndex sw, NodeIndex se)
+{
+    NodeKey key{nw, ne, sw, se};
+    auto found = m_canonical.find(key);
+    if(found != m_canonical.end())
+    {
+        return found->second;
+    }
+
+    std::uint64_t population = m_nodes[nw].population + m_nodes[ne].population 
+                             + m_nodes[sw].population + m_nodes[se].population;
+    NodeIndex index = static_cast<NodeIndex>(m_nodes.size());
+    m_nodes.push_back(Node{nw, ne, sw, se, population, m_nodes[nw].level + 1});
+    m_canonical.emplace(key, index);
+
+    return index;
+}
+
+HashLife::NodeIndex HashLife::emptyNode(int level)
+{
+    if(level == 0)
+    {
+        return 0;
+    }
+
+    if(static_cast<int>(m_emptyNodes.size()) <= level)
+    {
+        m_emptyNodes.resize(level + 1, noNode);
+    }
+
+    if(m_emptyNodes[level] == noNode)
+    {
+        NodeIndex child = emptyNode(level - 1);
+        m_emptyNodes[level] = join(child, child, child, child);
+    }
+
+    return m_emptyNodes[level];
+}
+
+HashLife::NodeIndex HashLife::expand(NodeIndex node)
+{
+    // Copy the node since joining may reallocate the node storage.
+    Node n = m_nodes[node];
+    NodeIndex empty = emptyNode(n.level - 1);
+
+    return join(join(empty, empty, empty, n.nw),
+                join(empty, empty, n.ne, empty),
+                join(empty, n.sw, empty, empty),
+                join(n.se, empty, empty, empty));
+}
+
+HashLife::NodeIndex HashLife::centre(NodeIndex node)
+{
+    Node n = m_nodes[node];
+
+    return join(m_nodes[n.nw].se, m_nodes[n.ne].sw, m_nodes[n.sw].ne, m_nodes[n.se].nw);
+}
+
+HashLife::NodeIndex HashLife::evolveLeaf(NodeIndex node)
+{
+    // Unpack the 4x4 cells of the node into a grid.
+    Node n = m_nodes[node];
+    const NodeIndex quadrants[2][2] = {{n.nw, n.ne}, {n.sw, n.se}};
+    int cells[4][4];
+    for(int row = 0; row < 4; ++row)
+    {
+        for(int col = 0; col < 4; ++col)
+        {
+            const Node &quadrant = m_nodes[quadrants[row/2][col/2]];
+            const NodeIndex children[2][2] = {{quadrant.nw, quadrant.ne}, {quadrant.sw, quadrant.se}};
+            cells[row][col] = static_cast<int>(children[row%2][col%2]);
+        }
+    }
+
+    // Apply the rule to the centre 2x2 cells.
+    NodeIndex next[2][2];
+    for(int row = 1; row <= 2; ++row)
+    {
+        for(int col = 1; col <= 2; ++col)
+        {
+            int liveNeighbours = cells[row-1][col-1] + cells[row-1][col] + cells[row-1][col+1]
+                               + cells[row][col-1]                       + cells[row][col+1]
+                               + cells[row+1][col-1] + cells[row+1][col] + cells[row+1][col+1];
+            next[row-1][col-1] = m_rule.isBorn(cells[row][col] != 0, liveNeighbours) ? 1 : 0;
+        }
+    }
+
+    return join(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+HashLife::NodeIndex HashLife::successor(NodeIndex node, int stepLog)
+{
+    Node n = m_nodes[node];
+
+    // Nothing is ever born in an empty region.
+    if(n.population == 0)
+    {
+        return emptyNode(n.level - 1);
+    }
+
+    std::uint64_t key = (static_cast<std::uint64_t>(node) << 6) | static_cast<std::uint64_t>(stepLog);
+    auto found = m_results.find(key);
+    if(found != m_results.end())
+    {
+        return found->second;
+    }
+
+    NodeIndex result;
+    if(n.level == 2)
+    {
+        result = evolveLeaf(node);
+    }
+    else
+    {
+        Node a = m_nodes[n.nw];
+        Node b = m_nodes[n.ne];
+        Node c = m_nodes[n.sw];
+        Node d = m_nodes[n.se];
+
+        // The nine overlapping sub-squares of the level below that tile the node.
+        NodeIndex squares[3][3] = {
+            {n.nw,                             join(a.ne, b.nw, a.se, b.sw), n.ne},
+            {join(a.sw, a.se, c.nw, c.ne),     join(a.se, b.sw, c.ne, d.nw), join(b.sw, b.se, d.nw, d.ne)},
+            {n.sw,                             join(c.ne, d.nw, c.se, d.sw), n.se}};
+
+        // At full speed the sub-squares are advanced by half the step here and half below, 
+        // otherwise they are only cropped and the whole step is taken below.
+        bool fullSpeed = (stepLog == n.level - 2);
+        int innerStep  = fullSpeed ? stepLog - 1 : stepLog;
+        NodeIndex inner[3][3];
+        for(int i = 0; i < 3; ++i)
+        {
+            for(int j = 0; j < 3; ++j)
+            {
+                inner[i][j] = fullSpeed ? successor(squares[i][j], stepLog - 1) : centre(squares[i][j]);
+            }
+        }
+
+        NodeIndex nw = successor(join(inner[0][0], inner[0][1], inner[1][0], inner[1][1]), innerStep);
+        NodeIndex ne = successor(join(inner[0][1], inner[0][2], inner[1][1], inner[1][2]), innerStep);
+        NodeIndex sw = successor(join(inner[1][0], inner[1][1], inner[2][0], inner[2][1]), innerStep);
+        NodeIndex se = successor(join(inner[1][1], inner[1][2], inner[2][1], inner[2][2]), innerStep);
+        result = join(nw, ne, sw, se);
+    }
+
+    m_results.emplace(key, result);
+
+    return result;
+}
+
+bool HashLife::isRootCentred() const
+{
+    const Node &root = m_nodes[m_root];
+    if(root.level < 2)
+    {
+        return root.population == 0;
+    }
+
+    const Node &a = m_nodes[root.nw];
+    const Node &b = m_nodes[root.ne];
+    const Node &c = m_nodes[root.sw];
+    const Node &d = m_nodes[root.se];
+
+    // Population outside of the centre quarter.
+    std::uint64_t outer = m_nodes[a.nw].population + m_nodes[a.ne].population + m_nodes[a.sw].population
+                        + m_nodes[b.nw].population + m_nodes[b.ne].population + m_nodes[b.se].population
+                        + m_nodes[c.nw].population + m_nodes[c.sw].population + m_nodes[c.se].population
+                        + m_nodes[d.ne].population + m_nodes[d.sw].population + m_nodes[d.se].population;
+
+    return outer == 0;
+}
+
+HashLife::NodeIndex HashLife::build(const LifeBoard &board, int level, std::int64_t row, std::int64_t col)
+{
+    // Regions beyond the board are dead.
+    if(row >= board.getRows() || col >= board.getCols())
+    {
+        return emptyNode(level);
+    }
+
+    if(level == 0)
+    {
+        return board.isAlive(static_cast<int>(row), static_cast<int>(col)) ? 1 : 0;
+    }
+
+    // Skip over large dead regions a word at a time.
+    std::int64_t size = std::int64_t(1) << level;
+    if(size >= LifeBoard::cellsPerWord && !regionHasLife(board, row, col, size))
+    {
+        return emptyNode(level);
+    }
+
+    std::int64_t half = size / 2;
+    NodeIndex nw = build(board, level - 1, row, col);
+    NodeIndex ne = build(board, level - 1, row, col + half);
+    NodeIndex sw = build(board, level - 1, row + half, col);
+    NodeIndex se = build(board, level - 1, row + half, col + half);
+
+    return join(nw, ne, sw, se);
+}
+
+void HashLife::write(LifeBoard &board, NodeIndex node, std::int64_t row, std::int64_t col) const
+{
+    const Node &n = m_nodes[node];
+    std::int64_t size = std::int64_t(1) << n.level;
+
+    // Skip dead nodes and nodes that are entirely outside of the board.
+    if(n.population == 0 || row >= board.getRows() || col >= board.getCols() || row + size <= 0 || col + size <= 0)
+    {
+        return;
+    }
+
+    if(n.level == 0)
+    {
+        board(static_cast<int>(row), static_cast<int>(col)) = LifeBoard::Alive;
+        return;
+    }
+
+    std::int64_t half = size / 2;
+    write(board, n.nw, row, col);
+    write(board, n.ne, row, col + half);
+    write(board, n.sw, row + half, col);
+    write(board, n.se, row + half, col + half);
+}
+
+void HashLife::setBoard(const LifeBoard &board)
+{
+    // Find the smallest square node the board fits in.
+    int level = 1;
+    while((std::int64_t(1) << level) < std::max(board.getRows(), board.getCols()))
+    {
+        ++level;
+    }
+
+    m_root       = build(board, level, 0, 0);
+    m_originRow  = 0;
+    m_originCol  = 0;
+    m_generation = 0;
+}
+
+void HashLife::copyToBoard(LifeBoard &board) const
+{
+    board.clear();
+    write(board, m_root, m_originRow, m_originCol);
+}
+
+void HashLife::stepPow2(int stepLog)
+{
+    // Only collect between steps since node indices held during a step must stay valid.
+    if(m_nodes.size() > m_maxNodes)
+    {
+        collectGarbage();
+    }
+
+    // Grow the universe around the pattern until the result of the root is guaranteed to 
+    // contain every cell that can be alive after the step, since nothing travels faster than 
+    // one cell per generation a border of 2^stepLog dead cells around the pattern suffices.
+    while(m_nodes[m_root].level < stepLog + 3 || !isRootCentred())
+    {
+        std::int64_t half = std::int64_t(1) << (m_nodes[m_root].level - 1);
+        m_root = expand(m_root);
+        m_originRow -= half;
+        m_originCol -= half;
+    }
+    std::int64_t half = std::int64_t(1) << (m_nodes[m_root].level - 1);
+    m_root = expand(m_root);
+    m_originRow -= half;
+    m_originCol -= half;
+
+    // The result is the centre quarter of the root.
+    std::int64_t quarter = std::int64_t(1) << (m_nodes[m_root].level - 2);
+    m_root = successor(m_root, stepLog);
+    m_originRow += quarter;
+    m_originCol += quarter;
+
+    m_generation += std::uint64_t(1) << stepLog;
+}
+
+void HashLife::advance(std::uint64_t generations)
+{
+    for(int stepLog = 0; generations != 0; ++stepLog, generations >>= 1)
+    {
+        if(generations & 1)
+        {
+            stepPow2(stepLog);
+        }
+    }
+}
+
+bool HashLife::isAlive(std::int64_t row, std::int64_t col) const
+{
+    // Work relative to the top left of the root.
+    row -= m_originRow;
+    col -= m_originCol;
+
+    NodeIndex node = m_root;
+    std::int64_t size = std::int64_t(1) << m_nodes[node].level;
+    if(row < 0 || col < 0 || row >= size || col >= size)
+    {
+        return false;
+    }
+
+    // Walk down the tree towards the cell stopping early in dead regions.
+    while(m_nodes[node].level > 0 && m_nodes[node].population != 0)
+    {
+        const Node &n = m_nodes[node];
+        size /= 2;
+        bool south = row >= size;
+        bool east  = col >= size;
+        node = south ? (east ? n.se : n.sw) : (east ? n.ne : n.nw);
+        row -= south ? size : 0;
+        col -= east ? size : 0;
+    }
+
+    return m_nodes[node].population != 0;
+}
+
+std::uint64_t HashLife::getGeneration() const
+{
+    return m_generation;
+}
+
+std::uint64_t HashLife::getPopulation() const
+{
+    return m_nodes[m_root].population;
+}
+
+std::size_t HashLife::getNodeCount() const
+{
+    return m_nodes.size();
+}
+
+void HashLife::collectGarbage()
+{
+    // Mark every node reachable from the root, the two cells are always kept.
+    std::vector<bool> reachable(m_nodes.size(), false);
+    reachable[0] = reachable[1] = true;
+    std::vector<NodeIndex> pending(1, m_root);
+    while(!pending.empty())
+    {
+        NodeIndex node = pending.back();
+        pending.pop_back();
+        if(reachable[node])
+        {
+            continue;
+        }
+        reachable[node] = true;
+
+        const Node &n = m_nodes[node];
+        pending.push_back(n.nw);
+        pending.push_back(n.ne);
+        pending.push_back(n.sw);
+        pending.push_back(n.se);
+    }
+
+    // Compact the surviving nodes, since children come before their parents they can be 
+    // renumbered in a single pass.
+    std::vector<NodeIndex> renumbered(m_nodes.size(), noNode);
+    std::vector<Node> nodes;
+    m_canonical.clear();
+    for(std::size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        if(!reachable[i])
+        {
+            continue;
+        }
+
+        Node n = m_nodes[i];
+        NodeIndex index = static_cast<NodeIndex>(nodes.size());
+        renumbered[i] = index;
+        if(n.level > 0)
+        {
+            n.nw = renumbered[n.nw];
+            n.ne = renumbered[n.ne];
+            n.sw = renumbered[n.sw];
+            n.se = renumbered[n.se];
+            m_canonical.emplace(NodeKey{n.nw, n.ne, n.sw, n.se}, index);
+        }
+        nodes.push_back(n);
+    }
+    m_nodes.swap(nodes);
+
+    // Keep the cached results whose node and result both survived.
+    std::unordered_map<std::uint64_t, NodeIndex> results;
+    for(const auto &entry : m_results)
+    {
+        NodeIndex node   = renumbered[entry.first >> 6];
+        NodeIndex result = renumbered[entry.second];
+        if(node != noNode && result != noNode)
+        {
+            results.emplace((static_cast<std::uint64_t>(node) << 6) | (entry.first & 63), result);
+        }
+    }
+    m_results.swap(results);
+
+    for(auto &empty : m_emptyNodes)
+    {
+        empty = (empty == noNode) ? noNode : renumbered[empty];
+    }
+
+    m_root = renumbered[m_root];
+}
@@ -0,0 +1,238 @@
+#ifndef HashLife_hpp
+#define HashLife_hpp
+
+#include <vector> // For holding the nodes.
+#include <unordered_map> // For the canonical node table and the result cache.
+#include <cstdint> // For fixed width integers.
+#include <cstddef> // For std::size_t.
+#include "LifeBoard.hpp"
+#include "Rule.hpp"
+
+/**
+ * \file
+ * \brief Class to model an unbounded GOL universe using Gosper's HashLife algorithm.
+ *
+ * The universe is stored as a quadtree in which every node is canonical, so identical regions of 
+ * the universe are stored once and shared. The result of advancing each node is memoised so 
+ * repeated regions in space and in time are only ever evolved once, which lets very large 
+ * numbers of generations be computed for regular patterns.
+ *
+ * Unlike LifeBoard the universe has no periodic boundary conditions, a board converted to a 
+ * HashLife universe evolves on an infinite plane so the two only agree while the pattern does 
+ * not reach the edges of the board.
+ */
+class HashLife
+{
+public:
+    /// Type used for indexing nodes.
+    typedef std::uint32_t NodeIndex;
+
+    /// Default maximum number of nodes kept before garbage is collected.
+    static constexpr std::size_t defaultMaxNodes = 1 << 24;
+
+private:
+    /**
+     * \struct Node
+     * \brief Square of 2^level by 2^level cells made up of four child nodes.
+     *
+     * Nodes of level 0 are single cells, index 0 is the dead cell and index 1 is the alive cell.
+     */
+    struct Node
+    {
+        NodeIndex nw, ne, sw, se;
+        std::uint64_t population;
+        int level;
+    };
+
+    /**
+     * \struct NodeKey
+     * \brief The four children of a node, which uniquely identify it.
+     */
+    struct NodeKey
+    {
+        NodeIndex nw, ne, sw, se;
+        bool operator==(const NodeKey &other) const;
+    };
+
+    /**
+     * \struct NodeKeyHash
+     * \brief Hash function for NodeKey instances.
+     */
+    struct NodeKeyHash
+    {
+        std::size_t operator()(const NodeKey &key) const;
+    };
+
+    /// Member variable that holds every node, children always have lower indices than parents.
+    std::vector<Node> m_nodes;
+
+    /// Member variable that maps the children of each node to the node so nodes are canonical.
+    std::unordered_map<NodeKey, NodeIndex, NodeKeyHash> m_canonical;
+
+    /// Member variable that memoises results keyed on the node index and log2 of the step.
+    std::unordered_map<std::uint64_t, NodeIndex> m_results;
+
+    /// Member variable that holds the empty node of each level once it has been created.
+    std::vector<NodeIndex> m_emptyNodes;
+
+    /// Member variable that holds the node the universe is made of.
+    NodeIndex m_root;
+
+    /// Member variable that holds the row of the top left cell of the root.
+    std::int64_t m_originRow;
+
+    /// Member variable that holds the column of the top left cell of the root.
+    std::int64_t m_originCol;
+
+    /// Member variable that holds the number of generations that have been computed.
+    std::uint64_t m_generation;
+
+    /// Member variable that holds the number of nodes above which garbage is collected.
+    std::size_t m_maxNodes;
+
+    /// Member variable that holds the rule the universe evolves under, fixed since results are memoised.
+    Rule m_rule;
+
+    /**
+     *\brief Finds or creates the canonical node with the given children.
+     *\return NodeIndex of the canonical node.
+     */
+    NodeIndex join(NodeIndex nw, NodeIndex ne, NodeIndex sw, NodeIndex se);
+
+    /**
+     *\brief Finds or creates the node of a given level with no live cells.
+     *\param level level of the node.
+     *\return NodeIndex of the empty node.
+     */
+    NodeIndex emptyNode(int level);
+
+    /**
+     *\brief Creates a node of the level above with the given node at its centre.
+     *\param node NodeIndex of a node with level at least 1.
+     *\return NodeIndex of the expanded node.
+     */
+    NodeIndex expand(NodeIndex node);
+
+    /**
+     *\brief Gets the centre quarter of a node.
+     *\param node NodeIndex of a node with level at least 2.
+     *\return NodeIndex of the centre node of the level below.
+     */
+    NodeIndex centre(NodeIndex node);
+
+    /**
+     *\brief Advances the centre quarter of a node.
+     *\param node NodeIndex of a node with level at least 2.
+     *\param stepLog log2 of the number of generations, at most the level of the node minus 2.
+     *\return NodeIndex of the evolved centre quarter.
+     */
+    NodeIndex successor(NodeIndex node, int stepLog);
+
+    /**
+     *\brief Directly evolves the centre 2x2 cells of a level 2 node by one generation using the rule lookup table.
+     *\param node NodeIndex of a node of level 2.
+     *\return NodeIndex of the evolved level 1 node.
+     */
+    NodeIndex evolveLeaf(NodeIndex node);
+
+    /**
+     *\brief Checks whether the live cells of the root lie within its centre quarter.
+     *\return boolean value representing the result of the query.
+     */
+    bool isRootCentred() const;
+
+    /**
+     *\brief Builds a node from the cells of a board.
+     *\param board LifeBoard to read from.
+     *\param level level of the node to build.
+     *\param row row of the board the top left of the node corresponds to.
+     *\param col column of the board the top left of the node corresponds to.
+     *\return NodeIndex of the built node.
+     */
+    NodeIndex build(const LifeBoard &board, int level, std::int64_t row, std::int64_t col);
+
+    /**
+     *\brief Writes the live cells of a node to a board.
+     *\param board LifeBoard to write to, cells outside of it are ignored.
+     *\param node NodeIndex of the node to write.
+     *\param row row of the board the top left of the node corresponds to.
+     *\param col column of the board the top left of the node corresponds to.
+     */
+    void write(LifeBoard &board, NodeIndex node, std::int64_t row, std::int64_t col) const;
+
+public:
+    /**
+     *\brief Constructor that creates an empty universe evolving under the active rule.
+     *\param maxNodes number of nodes above which garbage is collected between steps.
+     */
+    explicit HashLife(std::size_t maxNodes = defaultMaxNodes);
+
+    /**
+     *\brief Constructor that creates a universe holding the live cells of a board evolving under the active rule.
+     *\param board LifeBoard to copy, cell (i,j) of the board becomes cell (i,j) of the universe.
+     *\param maxNodes number of nodes above which garbage is collected between steps.
+     */
+    HashLife(const LifeBoard &board, std::size_t maxNodes = defaultMaxNodes);
+
+    /**
+     *\brief Replaces the universe with the live cells of a board and resets the generation.
+     *\param board LifeBoard to copy, cell (i,j) of the board becomes cell (i,j) of the universe.
+     */
+    void setBoard(const LifeBoard &board);
+
+    /**
+     *\brief Copies the cells of the universe in the window covered by a board into the board.
+     *\param board LifeBoard to write to, cell (i,j) of the board is set to cell (i,j) of the universe.
+     */
+    void copyToBoard(LifeBoard &board) const;
+
+    /**
+     *\brief Advances the universe by 2^stepLog generations in a single step.
+     *\param stepLog log2 of the number of generations, at most 56.
+     */
+    void stepPow2(int stepLog);
+
+    /**
+     *\brief Advances the universe by an arbitrary number of generations.
+     *\param generations number of generations to advance by.
+     *
+     * The number of generations is split into powers of two which are each done in one step.
+     */
+    void advance(std::uint64_t generations);
+
+    /**
+     *\brief Calculates whether given cell is alive or dead.
+     *\param row row of cell in question.
+     *\param col column of cell in question.
+     *\return boolean value representing result of query.
+     */
+    bool isAlive(std::int64_t row, std::int64_t col) const;
+
+    /**
+     *\brief Getter for the number of generations computed since the universe was set.
+     *\return Integer value representing the generation.
+     */
+    std::uint64_t getGeneration() const;
+
+    /**
+     *\brief Getter for the number of live cells.
+     *\return Integer value representing the population.
+     */
+    std::uint64_t getPopulation() const;
+
+    /**
+     *\brief Getter for the number of nodes currently stored.
+     *\return Integer value representing the number of nodes.
+     */
+    std::size_t getNodeCount() const;
+
+    /**
+     *\brief Removes every node that is not part of the current universe.
+     *
+     * Cached results are kept as long as both the node and its result survive. This is done 
+     * automatically between steps when the number of nodes exceeds the cap.
+     */
+    void collectGarbage();
+};
+
+#endif /* HashLife_hpp */
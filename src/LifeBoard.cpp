@@ -1,60 +1,268 @@
 #include "LifeBoard.hpp"
+#include "EvolveKernels.hpp"
+#include "ThreadPool.hpp"
+#include "Rule.hpp"
+#include "BoardHash.hpp"
+#include "Metrics.hpp"
+#include <algorithm> // For std::copy, std::fill and std::max.
 
 constexpr char LifeBoard::stateSymbols[];
+constexpr int LifeBoard::cellsPerWord;
 
-LifeBoard::State& LifeBoard::operator()(int row, int col)
+LifeBoard::CellReference::CellReference(Word &word, Word mask) :
+m_word(word),
+m_mask{mask}
+{}
+
+LifeBoard::CellReference::operator LifeBoard::State() const
 {
-    // Take into account periodic boundary conditions.
-    row = (row + m_rowCount) % m_rowCount;
-    col = (col + m_colCount) % m_colCount;
+    return (m_word & m_mask) ? LifeBoard::Alive : LifeBoard::Dead;
+}
 
-    // Return 1D index of 1D array corresponding to the 2D index.
-    return m_boardData[col + row * m_colCount];
+LifeBoard::CellReference& LifeBoard::CellReference::operator=(LifeBoard::State state)
+{
+    if(state == LifeBoard::Alive)
+    {
+        m_word |= m_mask;
+    }
+    else
+    {
+        m_word &= ~m_mask;
+    }
+
+    return *this;
 }
 
-const LifeBoard::State& LifeBoard::operator()(int row, int col) const
+LifeBoard::CellReference& LifeBoard::CellReference::operator=(const CellReference &other)
 {
-    // Take into account periodic boundary conditions we add extra m_rowCount and m_colCount
-    // terms here to take into account the fact that the caller may be indexing with -1.
-    row = (row + m_rowCount) % m_rowCount;
-    col = (col + m_colCount) % m_colCount;
+    return (*this) = static_cast<LifeBoard::State>(other);
+}
 
-    // Return 1D index of 1D array corresponding to the 2D index.
-    return m_boardData[col + row * m_colCount];
+LifeBoard::CellReference LifeBoard::operator()(int row, int col)
+{
+    invalidateStatistics();
+
+    // Take into account periodic boundary conditions, indices on the board are left alone.
+    Toroidal::resolve(row, m_rowCount);
+    Toroidal::resolve(col, m_colCount);
+
+    // Return the bit of the packed row corresponding to the 2D index.
+    return CellReference(m_cells[row * m_wordsPerRow + col / cellsPerWord], Word(1) << (col % cellsPerWord));
+}
+
+LifeBoard::State LifeBoard::operator()(int row, int col) const
+{
+    // Take into account periodic boundary conditions, only indices that fall off the board 
+    // such as -1 need wrapping so interior cells skip the modulo altogether.
+    Toroidal::resolve(row, m_rowCount);
+    Toroidal::resolve(col, m_colCount);
+
+    // Return the bit of the packed row corresponding to the 2D index.
+    Word word = m_cells[row * m_wordsPerRow + col / cellsPerWord];
+    return ((word >> (col % cellsPerWord)) & 1) ? LifeBoard::Alive : LifeBoard::Dead;
 }
 
 
 LifeBoard::LifeBoard(int rows, int cols, LifeBoard::State state) : 
 m_rowCount{rows},
 m_colCount{cols},
-m_boardData(rows*cols, state)
-{}
+m_wordsPerRow{(cols + cellsPerWord - 1) / cellsPerWord},
+m_boardData(static_cast<std::size_t>(rows) * m_wordsPerRow, state == LifeBoard::Alive ? ~Word(0) : Word(0)),
+m_cells{m_boardData.data()},
+m_rowOrigin{0},
+m_colOrigin{0},
+m_trackStatistics{false},
+m_statistics(rows, cols),
+m_statisticsValid{false},
+m_trackHash{false},
+m_hash{0},
+m_hashValid{false}
+{
+    // Clear the padding bits at the end of each row.
+    for(int row = 0; row < m_rowCount; ++row)
+    {
+        rowData(row)[m_wordsPerRow-1] &= lastWordMask();
+    }
+}
 
-LifeBoard::LifeBoard(int rows, int cols, std::default_random_engine &generator) : 
+LifeBoard::LifeBoard(int rows, int cols, Word *storage) :
 m_rowCount{rows},
-m_colCount{cols}
+m_colCount{cols},
+m_wordsPerRow{(cols + cellsPerWord - 1) / cellsPerWord},
+m_cells{storage},
+m_rowOrigin{0},
+m_colOrigin{0},
+m_trackStatistics{false},
+m_statistics(rows, cols),
+m_statisticsValid{false},
+m_trackHash{false},
+m_hash{0},
+m_hashValid{false}
+{}
+
+LifeBoard::LifeBoard(const LifeBoard &other) :
+LifeBoard(0, 0, LifeBoard::Dead)
+{
+    *this = other;
+}
+
+LifeBoard::LifeBoard(LifeBoard &&other) :
+LifeBoard(0, 0, LifeBoard::Dead)
 {
-    //TODO: This can probably be made more efficient.
+    *this = std::move(other);
+}
+
+LifeBoard& LifeBoard::operator=(const LifeBoard &other)
+{
+    if(this == &other)
+    {
+        return *this;
+    }
 
-    // Reserve the correct amount of space in the board data.
-    m_boardData.reserve(rows * cols);
-    static std::uniform_int_distribution<int> distribution(0,static_cast<int>(LifeBoard::MAXSTATE)-1);
-    for(int i = 0; i < rows*cols; ++i)
+    // Boards are assigned every generation with the same dimensions, so the cells are copied into 
+    // the storage already held, which keeps a view pointing at its storage and never allocates.
+    if(m_rowCount != other.m_rowCount || m_wordsPerRow != other.m_wordsPerRow)
+    {
+        m_boardData.assign(other.m_cells, other.m_cells + other.wordCount());
+        m_cells = m_boardData.data();
+    }
+    else
     {
-        m_boardData.push_back(static_cast<LifeBoard::State>(distribution(generator)));
+        std::copy(other.m_cells, other.m_cells + other.wordCount(), m_cells);
     }
+    copyState(other);
+    return *this;
+}
+
+LifeBoard& LifeBoard::operator=(LifeBoard &&other)
+{
+    if(this == &other)
+    {
+        return *this;
+    }
+
+    // Moving a vector keeps its data where it is, so the pointer to the cells stays valid.
+    m_boardData = std::move(other.m_boardData);
+    m_cells = other.m_cells;
+    copyState(other);
+
+    other.m_boardData.clear();
+    other.m_cells       = nullptr;
+    other.m_rowCount    = 0;
+    other.m_colCount    = 0;
+    other.m_wordsPerRow = 0;
+    return *this;
+}
+
+void LifeBoard::copyState(const LifeBoard &other)
+{
+    m_rowCount        = other.m_rowCount;
+    m_colCount        = other.m_colCount;
+    m_wordsPerRow     = other.m_wordsPerRow;
+    m_rowOrigin       = other.m_rowOrigin;
+    m_colOrigin       = other.m_colOrigin;
+    m_trackStatistics = other.m_trackStatistics;
+    m_statistics      = other.m_statistics;
+    m_statisticsValid = other.m_statisticsValid;
+    m_trackHash       = other.m_trackHash;
+    m_hash            = other.m_hash;
+    m_hashValid       = other.m_hashValid;
+}
+
+std::size_t LifeBoard::wordCount() const
+{
+    return static_cast<std::size_t>(m_rowCount) * m_wordsPerRow;
+}
+
+LifeBoard::LifeBoard(int rows, int cols, std::default_random_engine &generator) : 
+LifeBoard(rows, cols, LifeBoard::Dead)
+{
+    randomise(generator);
+}
+
+void LifeBoard::clear()
+{
+    invalidateStatistics();
+    std::fill(m_cells, m_cells + wordCount(), Word(0));
 }
 
 void LifeBoard::randomise(std::default_random_engine &generator)
 {
-    // Create a uniform distribution for the states on the board.
-    static std::uniform_int_distribution<int> distribution(0,static_cast<int>(LifeBoard::MAXSTATE)-1);
+    randomise(generator, 0.5);
+}
 
-    for(auto &cell : m_boardData)
+void LifeBoard::randomise(std::default_random_engine &generator, double density)
+{
+    // Draw a 64-bit seed so every seed of the engine gives a different board.
+    std::uint64_t seed = (static_cast<std::uint64_t>(generator()) << 32) ^ generator();
+    randomise(seed, density);
+}
+
+LifeBoard::Word LifeBoard::randomWord(std::uint64_t seed, std::uint64_t index, double density)
+{
+    // Each word has 16 counters, one for each bit of the random numbers it may need.
+    auto draw = [seed, index](int bit)
+    {
+        std::uint64_t mixed = seed + (index * 16 + bit + 1) * 0x9E3779B97F4A7C15ull;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+        return mixed ^ (mixed >> 31);
+    };
+
+    double scaled = density * 65536.0 + 0.5;
+    std::uint32_t threshold = (scaled <= 0.0) ? 0 : (scaled >= 65536.0) ? 65536 : static_cast<std::uint32_t>(scaled);
+    if(threshold == 0 || threshold == 65536)
     {
-        cell = static_cast<LifeBoard::State>(distribution(generator));
+        return (threshold == 0) ? 0 : ~Word(0);
     }
 
+    // A cell is alive if its random number is below the threshold. Working from the lowest set 
+    // bit of the threshold upwards, a 1 bit makes the cell alive if its random bit is set or it 
+    // was already below, a 0 bit needs both, so the lower zero bits never need a draw.
+    Word cells = 0;
+    for(int bit = __builtin_ctz(threshold); bit < 16; ++bit)
+    {
+        Word random = draw(bit);
+        cells = ((threshold >> bit) & 1) ? (cells | random) : (cells & random);
+    }
+
+    return cells;
+}
+
+void LifeBoard::randomise(std::uint64_t seed, double density)
+{
+    invalidateStatistics();
+    for(std::size_t word = 0; word < wordCount(); ++word)
+    {
+        m_cells[word] = randomWord(seed, word, density);
+    }
+
+    // Clear the padding bits at the end of each row.
+    for(int row = 0; row < m_rowCount; ++row)
+    {
+        m_cells[static_cast<std::size_t>(row) * m_wordsPerRow + m_wordsPerRow - 1] &= lastWordMask();
+    }
+}
+
+void LifeBoard::randomise(std::uint64_t seed, double density, ThreadPool &pool)
+{
+    invalidateStatistics();
+    int bands = pool.getThreadCount();
+    pool.run([&](int worker)
+    {
+        std::size_t begin = wordCount() * worker / bands;
+        std::size_t end   = wordCount() * (worker + 1) / bands;
+        for(std::size_t word = begin; word < end; ++word)
+        {
+            m_cells[word] = randomWord(seed, word, density);
+        }
+
+        // Clear the padding bits at the end of each row ending in this worker's range.
+        for(std::size_t word = begin - begin % m_wordsPerRow + m_wordsPerRow - 1; word < end; word += m_wordsPerRow)
+        {
+            m_cells[word] &= lastWordMask();
+        }
+    });
 }
 
 
@@ -73,6 +281,162 @@ int LifeBoard::getSize() const
     return m_colCount * m_rowCount;
 }
 
+long long LifeBoard::getPopulation() const
+{
+    if(m_statisticsValid)
+    {
+        return m_statistics.getPopulation();
+    }
+
+    // Padding bits are always dead so every word can simply be counted.
+    long long population = 0;
+    for(std::size_t word = 0; word < wordCount(); ++word)
+    {
+        population += __builtin_popcountll(m_cells[word]);
+    }
+
+    return population;
+}
+
+int LifeBoard::getWordsPerRow() const
+{
+    return m_wordsPerRow;
+}
+
+LifeBoard::Word* LifeBoard::rowData(int row)
+{
+    invalidateStatistics();
+    return &m_cells[static_cast<std::size_t>(row) * m_wordsPerRow];
+}
+
+const LifeBoard::Word* LifeBoard::rowData(int row) const
+{
+    return &m_cells[static_cast<std::size_t>(row) * m_wordsPerRow];
+}
+
+LifeBoard::Word LifeBoard::lastWordMask() const
+{
+    // Number of columns held in the final word of each row.
+    int usedBits = m_colCount - (m_wordsPerRow - 1) * cellsPerWord;
+
+    return (usedBits == cellsPerWord) ? ~Word(0) : (Word(1) << usedBits) - 1;
+}
+
+int LifeBoard::getRowOrigin() const
+{
+    return m_rowOrigin;
+}
+
+int LifeBoard::getColOrigin() const
+{
+    return m_colOrigin;
+}
+
+void LifeBoard::setStatisticsTracking(bool track)
+{
+    m_trackStatistics = track;
+}
+
+bool LifeBoard::isTrackingStatistics() const
+{
+    return m_trackStatistics;
+}
+
+const BoardStatistics& LifeBoard::statistics() const
+{
+    if(!m_statisticsValid)
+    {
+        m_statistics.reset(m_rowCount, m_colCount);
+        for(int row = 0; row < m_rowCount; ++row)
+        {
+            m_statistics.addRow(row, rowData(row), m_wordsPerRow);
+        }
+        m_statistics.finish();
+        m_statisticsValid = true;
+    }
+
+    return m_statistics;
+}
+
+void LifeBoard::setStatistics(const BoardStatistics &statistics)
+{
+    m_statistics = statistics;
+    m_statisticsValid = true;
+}
+
+void LifeBoard::invalidateStatistics()
+{
+    // Only write the flag when it changes so threads writing different rows do not share a write.
+    if(m_statisticsValid)
+    {
+        m_statisticsValid = false;
+    }
+    if(m_hashValid)
+    {
+        m_hashValid = false;
+    }
+}
+
+void LifeBoard::setHashTracking(bool track)
+{
+    m_trackHash = track;
+}
+
+bool LifeBoard::isTrackingHash() const
+{
+    return m_trackHash;
+}
+
+std::uint64_t LifeBoard::hash() const
+{
+    if(!m_hashValid)
+    {
+        m_hash = hashWords(0, m_cells, static_cast<int>(wordCount()));
+        m_hashValid = true;
+    }
+
+    return m_hash;
+}
+
+void LifeBoard::setHash(std::uint64_t hash)
+{
+    m_hash = hash;
+    m_hashValid = true;
+}
+
+void LifeBoard::setOrigin(int row, int col)
+{
+    m_rowOrigin = row;
+    m_colOrigin = col;
+}
+
+void LifeBoard::grow(int top, int bottom, int left, int right)
+{
+    invalidateStatistics();
+
+    int rows  = m_rowCount + top + bottom;
+    int cols  = m_colCount + left + right;
+    int words = (cols + cellsPerWord - 1) / cellsPerWord;
+    int leftWords = left / cellsPerWord;
+
+    // Since whole words are added on the left each row can be copied word by word, the padding 
+    // of the old rows is dead so the new columns on the right start off dead too.
+    std::vector<Word> data(static_cast<std::size_t>(rows) * words, 0);
+    for(int row = 0; row < m_rowCount; ++row)
+    {
+        const Word *source = rowData(row);
+        std::copy(source, source + m_wordsPerRow, &data[static_cast<std::size_t>(row + top) * words + leftWords]);
+    }
+
+    m_rowCount    = rows;
+    m_colCount    = cols;
+    m_wordsPerRow = words;
+    m_boardData.swap(data);
+    m_cells       = m_boardData.data();
+    m_rowOrigin  -= top;
+    m_colOrigin  -= left;
+}
+
 bool LifeBoard::isAlive(int row, int col) const
 {
     return (*this)(row,col) == LifeBoard::Alive;
@@ -111,90 +475,242 @@ LifeBoard::State LifeBoard::nextState(int row, int col) const
     // Calculate number of live neighbours, quicker to do it once.
     int liveNeighbours = getAliveNeighbours(row,col);
 
-    // Get the state of the cell currently
-    LifeBoard::State currentState = (*this)(row,col);
+    // Look up the future state in the active rule's table rather than branching on the count.
+    return activeRule().isBorn(isAlive(row,col), liveNeighbours) ? LifeBoard::Alive : LifeBoard::Dead;
+}
+
+std::pair<double,double> LifeBoard::centreOfMass() const
+{
+    // The sums of the coordinates of the live cells are kept with the statistics, so this is 
+    // just the average of the x and y coordinates of those cells.
+    std::pair<double,double> mean = statistics().mean();
+
+    // Move the components of the centre of mass vector onto the plane.
+    return std::pair<double,double>(mean.first + m_rowOrigin, mean.second + m_colOrigin);
+}
+
+std::pair<double,double> LifeBoard::periodicCentreOfMass() const
+{
+    std::pair<double,double> mean = statistics().circularMean();
+    return std::pair<double,double>(mean.first + m_rowOrigin, mean.second + m_colOrigin);
+}
 
-    // Check whether the state is alive since the update rules are different.
-    if(currentState == LifeBoard::Alive)
+namespace
+{
+    /**
+     *\brief Updates a band of rows of the board under a boundary policy.
+     *\param updatedBoard LifeBoard object that will be the updated board.
+     *\param currentBoard LifeBoard object that is the board the update is based on.
+     *\param beginRow first row to update.
+     *\param endRow row one past the last row to update.
+     *\param statistics BoardStatistics pointer the updated rows are added to, nullptr to skip them.
+     *\param hash pointer to the hash the updated rows are added to, nullptr to skip them.
+     */
+    template<class Boundary>
+    void evolveRows(LifeBoard &updatedBoard, const LifeBoard &currentBoard, int beginRow, int endRow, BoardStatistics *statistics, std::uint64_t *hash)
     {
-        // 1. Any live cell with fewer than two live neighbours dies, as if caused by under population.
-        if(liveNeighbours < 2) 
+        int maxRows = currentBoard.getRows();
+        int maxCols = currentBoard.getCols();
+        int words   = currentBoard.getWordsPerRow();
+        LifeBoard::Word lastMask = currentBoard.lastWordMask();
+        RowKernel evolveRow = getRowKernel<Boundary>(activeKernel());
+
+        // Row that stands in for the rows beyond the top and bottom without periodic boundaries, 
+        // kept between generations so stepping does not allocate.
+        static thread_local std::vector<LifeBoard::Word> deadRow;
+        if(!Boundary::periodic)
         {
-            return LifeBoard::Dead;
+            deadRow.resize(std::max(deadRow.size(), static_cast<std::size_t>(words)), 0);
         }
 
-        // 2. Any live cell with two or three live neighbours lives on to the next generation.
-        if(liveNeighbours == 2 || liveNeighbours == 3) 
+        for(int row = beginRow; row < endRow; ++row)
         {
-            return LifeBoard::Alive;
-        }
+            const LifeBoard::Word *above;
+            const LifeBoard::Word *below;
+            if(row > 0 && row < maxRows - 1)
+            {
+                above = currentBoard.rowData(row - 1);
+                below = currentBoard.rowData(row + 1);
+            }
+            else
+            {
+                // Neighbouring rows taking into account the boundary conditions.
+                int aboveRow = row - 1;
+                int belowRow = row + 1;
+                above = Boundary::resolve(aboveRow, maxRows) ? currentBoard.rowData(aboveRow) : deadRow.data();
+                below = Boundary::resolve(belowRow, maxRows) ? currentBoard.rowData(belowRow) : deadRow.data();
+            }
 
-        // 3. Any live cell with more than three live neighbours dies, as if by overpopulation.
-        if(liveNeighbours > 3)
-        {
-            return LifeBoard::Dead;
+            LifeBoard::Word *updated = updatedBoard.rowData(row);
+            evolveRow(above, currentBoard.rowData(row), below, updated, words, maxCols, lastMask, 0, words);
+
+            // Gather the statistics while the new row is still in cache.
+            if(statistics)
+            {
+                statistics->addRow(row, updated, words);
+            }
+            if(hash)
+            {
+                *hash += hashWords(static_cast<std::size_t>(row) * words, updated, words);
+            }
         }
     }
-    if(liveNeighbours == 3)
-    // 4. Any dead cell with exactly three live neighbours becomes a live cell, as if by reproduction.
+
+    /**
+     *\brief Updates the whole board under a boundary policy, gathering statistics if the board tracks them.
+     *\param updatedBoard LifeBoard object that will be the updated board.
+     *\param currentBoard LifeBoard object that is the board the update is based on.
+     */
+    template<class Boundary>
+    void evolveBoard(LifeBoard &updatedBoard, const LifeBoard &currentBoard)
     {
-        return LifeBoard::Alive;
+        bool trackStatistics = currentBoard.isTrackingStatistics();
+        bool trackHash = currentBoard.isTrackingHash();
+        updatedBoard.setStatisticsTracking(trackStatistics);
+        updatedBoard.setHashTracking(trackHash);
+
+        // The buffers of the statistics are kept between generations so stepping does not allocate.
+        static thread_local BoardStatistics statistics(0, 0);
+        statistics.reset(currentBoard.getRows(), currentBoard.getCols());
+        std::uint64_t hash = 0;
+        METRICS_COUNT(Counter::CellsEvaluated, static_cast<std::uint64_t>(currentBoard.getRows()) * currentBoard.getCols());
+        evolveRows<Boundary>(updatedBoard, currentBoard, 0, currentBoard.getRows(), trackStatistics ? &statistics : nullptr, trackHash ? &hash : nullptr);
+
+        if(trackStatistics)
+        {
+            statistics.finish();
+            updatedBoard.setStatistics(statistics);
+        }
+        if(trackHash)
+        {
+            updatedBoard.setHash(hash);
+        }
     }
-    else
-    // Otherwise cell just stays dead.
+
+    /**
+     *\brief Grows a board so that all of its edges are dead.
+     *\param board LifeBoard to grow.
+     *\return boolean value representing whether the board grew.
+     *
+     * Only the edges with live cells are moved out, by a margin of a word of cells in each case.
+     */
+    bool growToDeadEdges(LifeBoard &board)
     {
-        return LifeBoard::Dead;
+        // Only read through a constant reference so the statistics are kept unless the board grows.
+        const LifeBoard &cells = board;
+        const int margin = LifeBoard::cellsPerWord;
+        int rows  = board.getRows();
+        int cols  = board.getCols();
+        int words = board.getWordsPerRow();
+
+        bool top = false, bottom = false, left = false, right = false;
+        for(int word = 0; word < words; ++word)
+        {
+            top    = top    || cells.rowData(0)[word] != 0;
+            bottom = bottom || cells.rowData(rows - 1)[word] != 0;
+        }
+        const LifeBoard::Word lastBit = LifeBoard::Word(1) << ((cols - 1) % LifeBoard::cellsPerWord);
+        for(int row = 0; row < rows && !(left && right); ++row)
+        {
+            left  = left  || (cells.rowData(row)[0] & 1) != 0;
+            right = right || (cells.rowData(row)[words - 1] & lastBit) != 0;
+        }
+
+        if(!(top || bottom || left || right))
+        {
+            return false;
+        }
+
+        board.grow(top ? margin : 0, bottom ? margin : 0, left ? margin : 0, right ? margin : 0);
+        return true;
     }
 }
 
-std::pair<double,double> LifeBoard::centreOfMass() const
+void update(LifeBoard &updatedBoard, LifeBoard &currentBoard) 
 {
-	// X-coordinate of centre of mass.
-	double xCOM          = 0;
-
-	// Y-coordinate of centre of mass.
-    double yCOM          = 0;
+    evolveBoard<Toroidal>(updatedBoard, currentBoard);
+}
 
-    // Value that corresponds to N in the formula for the centre of mass.
-    double normalisation = 0;
+void updateRows(LifeBoard &updatedBoard, LifeBoard &currentBoard, int beginRow, int endRow)
+{
+    evolveRows<Toroidal>(updatedBoard, currentBoard, beginRow, endRow, nullptr, nullptr);
+}
 
-    // The most naive implementation of this is to just check which cells are alive and average over the 
-    // x and y coordinates of those cells.
-    for(int i = 0; i < m_rowCount; ++i)
+template<class Boundary>
+void update(LifeBoard &updatedBoard, LifeBoard &currentBoard)
+{
+    // Keep the edges dead so nothing can be born beyond them, the updated board is then 
+    // entirely overwritten so it only needs the same shape and origin.
+    if(Boundary::grows && growToDeadEdges(currentBoard))
     {
-        for(int j = 0; j < m_colCount; ++j)
-        {
-            if(LifeBoard::Alive == (*this)(i,j))
-            {
-                xCOM += i;
-                yCOM += j;
-                ++normalisation;
-                
-            }
-        }
+        updatedBoard = currentBoard;
     }
 
-    // Normalise the components of the centre of mass vector.
-    xCOM /= normalisation;
-    yCOM /= normalisation;
-
-    // Pack them into a pair so more than one value can be returned to the caller.
-    return std::pair<double,double>(xCOM,yCOM);
+    evolveBoard<Boundary>(updatedBoard, currentBoard);
 }
 
-void update(LifeBoard &updatedBoard, LifeBoard &currentBoard) 
+template void update<Toroidal>(LifeBoard &updatedBoard, LifeBoard &currentBoard);
+template void update<DeadEdge>(LifeBoard &updatedBoard, LifeBoard &currentBoard);
+template void update<Unbounded>(LifeBoard &updatedBoard, LifeBoard &currentBoard);
+
+void update(LifeBoard &updatedBoard, LifeBoard &currentBoard, ThreadPool &pool)
 {
-    int maxRows = updatedBoard.getRows();
-    int maxCols = updatedBoard.getCols();
-    
-    for(int row = 0; row < maxRows; ++row)
+    int maxRows = currentBoard.getRows();
+    int bands   = pool.getThreadCount();
+    bool trackStatistics = currentBoard.isTrackingStatistics();
+    bool trackHash = currentBoard.isTrackingHash();
+
+    // Each worker gathers the statistics and hash of its own band, which are merged afterwards. The 
+    // buffers belong to the calling thread and are kept between generations so stepping does not 
+    // allocate, the workers reach them through pointers taken here.
+    static thread_local std::vector<BoardStatistics> bandStatisticsBuffer;
+    static thread_local std::vector<std::uint64_t> bandHashesBuffer;
+    if(trackStatistics)
     {
-        for(int col = 0; col < maxCols; ++col)
+        bandStatisticsBuffer.resize(std::max(bandStatisticsBuffer.size(), static_cast<std::size_t>(bands)), BoardStatistics(0, 0));
+        for(int band = 0; band < bands; ++band)
         {
-            updatedBoard(row,col) = currentBoard.nextState(row,col);
+            bandStatisticsBuffer[band].reset(maxRows, currentBoard.getCols());
         }
     }
+    bandHashesBuffer.assign(bands, 0);
+    BoardStatistics *bandStatistics = bandStatisticsBuffer.data();
+    std::uint64_t *bandHashes = bandHashesBuffer.data();
+    updatedBoard.setStatisticsTracking(trackStatistics);
+    updatedBoard.setHashTracking(trackHash);
+    updatedBoard.invalidateStatistics();
+    METRICS_COUNT(Counter::CellsEvaluated, static_cast<std::uint64_t>(maxRows) * currentBoard.getCols());
+
+    pool.run([&](int worker)
+    {
+        // Split the rows as evenly as possible between the workers.
+        int beginRow = static_cast<int>(static_cast<long long>(maxRows) * worker / bands);
+        int endRow   = static_cast<int>(static_cast<long long>(maxRows) * (worker + 1) / bands);
+        evolveRows<Toroidal>(updatedBoard, currentBoard, beginRow, endRow, 
+                             trackStatistics ? &bandStatistics[worker] : nullptr, trackHash ? &bandHashes[worker] : nullptr);
+        if(trackStatistics)
+        {
+            bandStatistics[worker].finish();
+        }
+    });
 
+    if(trackStatistics)
+    {
+        for(int band = 1; band < bands; ++band)
+        {
+            bandStatistics[0].merge(bandStatistics[band]);
+        }
+        updatedBoard.setStatistics(bandStatistics[0]);
+    }
+    if(trackHash)
+    {
+        std::uint64_t hash = 0;
+        for(int band = 0; band < bands; ++band)
+        {
+            hash += bandHashes[band];
+        }
+        updatedBoard.setHash(hash);
+    }
 }
 
 
@@ -261,11 +777,19 @@ bool LifeBoard::isCrossBoundaryStructure() const
                 return true;
             }
     }
-    
+
+    return false;
 }
 
 bool LifeBoard::isBoundaryLive() const
 {
+    // With up to date statistics the bounding box answers this straight away.
+    if(m_statisticsValid)
+    {
+        return m_statistics.getPopulation() > 0 && (m_statistics.getMinRow() == 0 || m_statistics.getMaxRow() == m_rowCount - 1 ||
+                                                    m_statistics.getMinCol() == 0 || m_statistics.getMaxCol() == m_colCount - 1);
+    }
+
     // Check the outer boundary and see whether it has any live cells.
     // Check first row.
     for(int i = 0; i < m_colCount; ++i)
@@ -5,6 +5,11 @@
 #include <random> // For generating random numbers.
 #include <iostream> // For outputting board.
 #include <utility> // For std::pair.
+#include <cstdint> // For fixed width words holding packed cells.
+#include "BoundaryPolicy.hpp"
+#include "BoardStatistics.hpp"
+
+class ThreadPool;
 
 /**
  * \file
@@ -27,6 +32,58 @@ public:
     /// Look-up table for alive/dead cells symbols for printing.
     static constexpr char stateSymbols[MAXSTATE] = {' ','o'};
 
+    /// Type of the machine words the cells are packed into, one bit per cell.
+    typedef std::uint64_t Word;
+
+    /// Number of cells packed into a single word.
+    static constexpr int cellsPerWord = 64;
+
+    /**
+     * \class CellReference
+     * \brief Proxy that behaves like a reference to the state of a single packed cell.
+     *
+     * Since cells are stored as single bits there is no State object to hand out a reference to, 
+     * instead this proxy remembers the word and bit of the cell so it can be read from and assigned 
+     * to in the same way a State& could be.
+     */
+    class CellReference
+    {
+    private:
+        /// Word holding the cell.
+        Word &m_word;
+
+        /// Mask with only the bit of the cell set.
+        Word m_mask;
+
+    public:
+        /**
+         *\brief Constructor binding the proxy to a bit in a word.
+         *\param word reference to the word holding the cell.
+         *\param mask word with only the bit of the cell set.
+         */
+        CellReference(Word &word, Word mask);
+
+        /**
+         *\brief Conversion to the state of the cell.
+         *\return State of the referenced cell.
+         */
+        operator LifeBoard::State() const;
+
+        /**
+         *\brief Sets the state of the referenced cell.
+         *\param state State to set the cell to.
+         *\return reference to this proxy so assignments can be chained.
+         */
+        CellReference& operator=(LifeBoard::State state);
+
+        /**
+         *\brief Copies the state of another cell into the referenced cell.
+         *\param other proxy of the cell to copy the state from.
+         *\return reference to this proxy so assignments can be chained.
+         */
+        CellReference& operator=(const CellReference &other);
+    };
+
 private:
     /// Member variable that holds number of rows in lattice.
     int m_rowCount;
@@ -34,8 +91,50 @@ private:
     /// Member variable that holds number of columns in lattice.
     int m_colCount;
 
-    /// Member variable that holds the actual data in the lattice.
-    std::vector<State> m_boardData;
+    /// Member variable that holds the number of words used to store a single row.
+    int m_wordsPerRow;
+
+    /// Member variable that holds the actual data in the lattice, one bit per cell row by row, empty for views.
+    std::vector<Word> m_boardData;
+
+    /// Member variable that points to the cells, either into m_boardData or to storage owned by someone else.
+    Word *m_cells;
+
+    /// Member variable that holds the row of the plane that row 0 of the board corresponds to.
+    int m_rowOrigin;
+
+    /// Member variable that holds the column of the plane that column 0 of the board corresponds to.
+    int m_colOrigin;
+
+    /// Member variable that holds whether the update functions gather statistics while writing this board.
+    bool m_trackStatistics;
+
+    /// Member variable that holds the statistics of the live cells, only meaningful if m_statisticsValid.
+    mutable BoardStatistics m_statistics;
+
+    /// Member variable that holds whether m_statistics describes the current cells.
+    mutable bool m_statisticsValid;
+
+    /// Member variable that holds whether the update functions hash this board while writing it.
+    bool m_trackHash;
+
+    /// Member variable that holds the hash of the cells, only meaningful if m_hashValid.
+    mutable std::uint64_t m_hash;
+
+    /// Member variable that holds whether m_hash describes the current cells.
+    mutable bool m_hashValid;
+
+    /**
+     *\brief Copies everything but the cells from another board.
+     *\param other LifeBoard to copy from.
+     */
+    void copyState(const LifeBoard &other);
+
+    /**
+     *\brief Getter for the number of words holding the cells.
+     *\return number of words in all the rows.
+     */
+    std::size_t wordCount() const;
 
 public:
     /**
@@ -48,9 +147,9 @@ public:
      *
      *\param row row index of site.
      *\param col column index of site.
-     *\return reference to state stored at site so called can use it or set it.
+     *\return proxy reference to state stored at site so called can use it or set it.
      */
-    LifeBoard::State& operator()(int row, int col);
+    LifeBoard::CellReference operator()(int row, int col);
 
     /** 
      *\brief constant version of non-constant counterpart for use with constant LifeBoard object.
@@ -59,9 +158,9 @@ public:
      *
      *\param row row index of site.
      *\param col column index of site.
-     *\return constant reference to state stored at site so called can use it only.
+     *\return state stored at site so called can use it only.
      */
-    const LifeBoard::State& operator()(int row, int col) const;
+    LifeBoard::State operator()(int row, int col) const;
 
     /**
      *\brief Constructor that initializes all cells to the state that is its arguments.
@@ -71,6 +170,43 @@ public:
      */
     LifeBoard(int rows, int cols, LifeBoard::State state = LifeBoard::Alive);
 
+    /**
+     *\brief Constructor that makes a view of cells held in storage owned by someone else.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     *\param storage pointer to rows*getWordsPerRow() words holding the cells, with dead padding bits, which must outlive the board.
+     *
+     * Copies of a view own their cells, assigning a board of the same dimensions to a view copies the
+     * cells into its storage and growing a view moves it into storage of its own.
+     */
+    LifeBoard(int rows, int cols, Word *storage);
+
+    /**
+     *\brief Copy constructor that copies the cells into storage owned by the new board.
+     *\param other LifeBoard to copy.
+     */
+    LifeBoard(const LifeBoard &other);
+
+    /**
+     *\brief Copy assignment that reuses the storage of the board when the dimensions match.
+     *\param other LifeBoard to copy.
+     *\return reference to this board.
+     */
+    LifeBoard& operator=(const LifeBoard &other);
+
+    /**
+     *\brief Move constructor that takes over the cells of another board, leaving it empty.
+     *\param other LifeBoard to move from.
+     */
+    LifeBoard(LifeBoard &&other);
+
+    /**
+     *\brief Move assignment that takes over the cells of another board, leaving it empty.
+     *\param other LifeBoard to move from.
+     *\return reference to this board.
+     */
+    LifeBoard& operator=(LifeBoard &&other);
+
     /** 
      *\brief Constructor that randomises lattice to an even mix of states.
      *\param rows number of rows on the board.
@@ -79,12 +215,59 @@ public:
      */
     LifeBoard(int rows, int cols, std::default_random_engine &generator);
 
+    /**
+     *\brief Sets every cell dead in place, so a view keeps its storage.
+     */
+    void clear();
+
     /**
      *\brief Randomises the cells in the board with equal probability of being dead or alive.
-     *\param std::deafult_random_engine reference for random number generation.
+     *\param std::deafult_random_engine reference for random number generation, one seed is drawn from it.
      */
     void randomise(std::default_random_engine &generator);
 
+    /**
+     *\brief Randomises the cells in the board with each cell alive with a given probability.
+     *\param generator std::default_random_engine reference for random number generation, one seed is drawn from it.
+     *\param density probability of each cell being alive, between 0 and 1.
+     */
+    void randomise(std::default_random_engine &generator, double density);
+
+    /**
+     *\brief Randomises the cells in the board from a seed, see randomWord().
+     *\param seed seed the board is generated from.
+     *\param density probability of each cell being alive, between 0 and 1.
+     */
+    void randomise(std::uint64_t seed, double density = 0.5);
+
+    /**
+     *\brief Randomises the cells in the board from a seed using a pool of threads.
+     *
+     * Every word is generated from its own position, so the board is the same as the serial 
+     * randomise() with the same seed whatever the number of threads.
+     *
+     *\param seed seed the board is generated from.
+     *\param density probability of each cell being alive, between 0 and 1.
+     *\param pool ThreadPool reference, each worker fills one contiguous range of words.
+     */
+    void randomise(std::uint64_t seed, double density, ThreadPool &pool);
+
+    /**
+     *\brief Generates one word of a random board.
+     *
+     * The random bits come from a counter based generator, the SplitMix64 finaliser applied to 
+     * the seed and a counter, so any word can be generated without the ones before it. At a 
+     * density of a half each word takes a single draw, otherwise the density is rounded to a 
+     * multiple of 2^-16 and each cell compares a 16 bit random number against it, with the 
+     * comparison done for all 64 cells at once a bit of the random numbers at a time.
+     *
+     *\param seed seed the board is generated from.
+     *\param index position of the word in the board, row * words per row + word.
+     *\param density probability of each cell being alive, between 0 and 1.
+     *\return the word of 64 random cells, padding bits are not cleared.
+     */
+    static Word randomWord(std::uint64_t seed, std::uint64_t index, double density);
+
     /**
      *\brief Getter for the number of rows.
      *\return Integer value representing the number of rows.
@@ -103,6 +286,143 @@ public:
      */
     int getSize() const;
 
+    /**
+     *\brief Counts the number of live cells on the board.
+     *\return Integer value representing the population.
+     */
+    long long getPopulation() const;
+
+    /**
+     *\brief Getter for the number of words used to store each row.
+     *\return Integer value representing the number of words per row.
+     */
+    int getWordsPerRow() const;
+
+    /**
+     *\brief Gives access to the packed words of a row.
+     *
+     * Column j of the row is held in bit j % cellsPerWord of word j / cellsPerWord. Any bits in 
+     * the final word beyond the last column are padding and must always be kept dead.
+     *
+     *\param row row index, must be in the range [0, rows).
+     *\return pointer to the first word of the row.
+     */
+    Word* rowData(int row);
+
+    /**
+     *\brief constant version of non-constant counterpart for use with constant LifeBoard object.
+     *\param row row index, must be in the range [0, rows).
+     *\return constant pointer to the first word of the row.
+     */
+    const Word* rowData(int row) const;
+
+    /**
+     *\brief Mask of the bits in the final word of each row that hold real cells.
+     *\return Word with a bit set for every used bit in the last word of a row.
+     */
+    Word lastWordMask() const;
+
+    /**
+     *\brief Getter for the row of the plane that row 0 of the board corresponds to.
+     *
+     * This is 0 unless the board has grown, see grow().
+     *
+     *\return Integer value representing the row origin.
+     */
+    int getRowOrigin() const;
+
+    /**
+     *\brief Getter for the column of the plane that column 0 of the board corresponds to.
+     *\return Integer value representing the column origin.
+     */
+    int getColOrigin() const;
+
+    /**
+     *\brief Places the board on the plane, for example when restoring a board that had grown.
+     *\param row row of the plane that row 0 of the board corresponds to.
+     *\param col column of the plane that column 0 of the board corresponds to.
+     */
+    void setOrigin(int row, int col);
+
+    /**
+     *\brief Chooses whether the update functions gather statistics while writing this board.
+     *
+     * With tracking on, update() leaves the statistics of the updated board ready so the centre 
+     * of mass, population and bounding box cost O(1) afterwards. The setting is passed on from 
+     * the current board to the updated board. Boards updated in any other way, for example by 
+     * the TiledStepper, fall back to a scan the first time the statistics are needed.
+     *
+     *\param track true to gather statistics during updates.
+     */
+    void setStatisticsTracking(bool track);
+
+    /**
+     *\brief Getter for whether the update functions gather statistics while writing this board.
+     *\return Boolean value representing whether statistics are tracked.
+     */
+    bool isTrackingStatistics() const;
+
+    /**
+     *\brief Gets the statistics of the live cells, scanning the board if they are out of date.
+     *\return constant reference to the statistics, coordinates are relative to the board not the plane.
+     */
+    const BoardStatistics& statistics() const;
+
+    /**
+     *\brief Stores statistics gathered while the board was being written.
+     *\param statistics BoardStatistics describing the current cells of the board.
+     */
+    void setStatistics(const BoardStatistics &statistics);
+
+    /**
+     *\brief Marks the statistics and the hash as out of date.
+     *
+     * Every non-constant accessor does this, it only needs calling directly before several 
+     * threads write the board through rowData() so they do not all update the flags.
+     */
+    void invalidateStatistics();
+
+    /**
+     *\brief Chooses whether the update functions hash this board while writing it.
+     *
+     * Like the statistics the setting is passed on from the current board to the updated board, 
+     * and the TiledStepper keeps the hash up to date from the tiles it updates.
+     *
+     *\param track true to hash the board during updates.
+     */
+    void setHashTracking(bool track);
+
+    /**
+     *\brief Getter for whether the update functions hash this board while writing it.
+     *\return Boolean value representing whether the hash is tracked.
+     */
+    bool isTrackingHash() const;
+
+    /**
+     *\brief Gets the hash of the cells, see BoardHash.hpp, hashing the board if it is out of date.
+     *\return the 64-bit hash of the board.
+     */
+    std::uint64_t hash() const;
+
+    /**
+     *\brief Stores a hash worked out while the board was being written.
+     *\param hash the 64-bit hash of the current cells of the board.
+     */
+    void setHash(std::uint64_t hash);
+
+    /**
+     *\brief Adds dead rows and columns around the edges of the board.
+     *
+     * The existing cells keep their position on the plane so the origin is moved back by the 
+     * number of rows and columns added at the top and left.
+     *
+     *\param top number of rows to add above the board.
+     *\param bottom number of rows to add below the board.
+     *\param left number of columns to add left of the board, must be a multiple of cellsPerWord.
+     *\param right number of columns to add right of the board.
+     */
+    void grow(int top, int bottom, int left, int right);
+
     /**
      *\brief Calculates whether given cell is alive or dead.
      *\param row row of cell in question.
@@ -111,6 +431,16 @@ public:
      */
     bool isAlive(int row, int col) const;
 
+    /**
+     *\brief Calculates whether given cell is alive or dead under a boundary policy.
+     *\tparam Boundary BoundaryPolicy deciding what lies beyond the edges of the board.
+     *\param row row of cell in question.
+     *\param col column of cell in question.
+     *\return boolean value representing result of query.
+     */
+    template<class Boundary>
+    bool isAlive(int row, int col) const;
+
     /**
      *\brief Calculates the number of alive nearest neighbours.
      *\param row row of cell of interest.
@@ -129,7 +459,8 @@ public:
      *\return State representing the future state of the cell.
      *
      * This function DOES NOT actually update the cell it just tells the caller the state of the cell 
-     * on the next iteration. The rules for GOL are taken to be as follows:
+     * on the next iteration. The rules are those of the active rule, see Rule.hpp, which by default 
+     * are the rules for GOL taken to be as follows:
      * 1. Any live cell with fewer than two live neighbours dies, as if caused by under population.
      * 2. Any live cell with two or three live neighbours lives on to the next generation.
      * 3. Any live cell with more than three live neighbours dies, as if by overpopulation.
@@ -144,17 +475,54 @@ public:
      *
      * This function should only really be used with single objects such as gliders.
      * The centre of mass is calcuated according to r = \sum_{i}^{N} r_i/N, where r 
-     * is a 2-D vector.
+     * is a 2-D vector. Coordinates are on the plane so include the origin of the board.
      */
     std::pair<double,double> centreOfMass() const;
 
+    /**
+     *\brief Calculates the centre of mass of the board taking the periodic boundaries into account.
+     *\return std::pair instance containing the centre of mass of the board.
+     *
+     * Each coordinate is averaged as an angle round the torus, so unlike centreOfMass() a 
+     * structure that straddles an edge is placed on that edge instead of the middle of the board. 
+     * Coordinates are on the plane so include the origin of the board.
+     */
+    std::pair<double,double> periodicCentreOfMass() const;
+
     /**
      *\brief Updates the board based on the rules for the GOL.
      *\param updatedBoard LifeBoard object that will be the updated board.
      *\param currentBoard LifeBoard object that is the board the update is based on.
+     *
+     * The rules are evaluated for a whole word of cells at once, the eight neighbour words are 
+     * summed with bitwise adders so each bit position holds its own neighbour count. Rows are 
+     * evolved with the SIMD kernel selected in EvolveKernels.hpp under the active rule. Both boards must have the 
+     * same dimensions.
      */
     friend void update(LifeBoard &updatedBoard, LifeBoard &currentBoard);
 
+    /**
+     *\brief Updates a band of rows of the board based on the rules for the GOL.
+     *\param updatedBoard LifeBoard object that will be the updated board.
+     *\param currentBoard LifeBoard object that is the board the update is based on.
+     *\param beginRow first row to update.
+     *\param endRow row one past the last row to update.
+     *
+     * Since each row only depends on the current board, bands that do not overlap can be 
+     * updated concurrently.
+     */
+    friend void updateRows(LifeBoard &updatedBoard, LifeBoard &currentBoard, int beginRow, int endRow);
+
+    /**
+     *\brief Updates the board based on the rules for the GOL using a pool of threads.
+     *\param updatedBoard LifeBoard object that will be the updated board.
+     *\param currentBoard LifeBoard object that is the board the update is based on.
+     *\param pool ThreadPool reference, each worker updates one contiguous band of rows.
+     *
+     * Produces exactly the same board as the serial update and returns once every band is done.
+     */
+    friend void update(LifeBoard &updatedBoard, LifeBoard &currentBoard, ThreadPool &pool);
+
     /**
      *\brief streams the board to an output stream in a nicely formatted way
      *\param out std::ostream reference that is being streamed to 
@@ -178,4 +546,23 @@ public:
 
 };
 
+/**
+ *\brief Updates the board based on the rules for the GOL under a boundary policy.
+ *\tparam Boundary BoundaryPolicy deciding what lies beyond the edges of the board.
+ *\param updatedBoard LifeBoard object that will be the updated board.
+ *\param currentBoard LifeBoard object that is the board the update is based on.
+ *
+ * Only the words at the ends of each row and the first and last rows take the boundary into 
+ * account. With the Unbounded policy both boards grow first whenever a live cell is on an edge 
+ * of the current board, so they may no longer have their original dimensions afterwards.
+ */
+template<class Boundary>
+void update(LifeBoard &updatedBoard, LifeBoard &currentBoard);
+
+template<class Boundary>
+bool LifeBoard::isAlive(int row, int col) const
+{
+    return Boundary::resolve(row, m_rowCount) && Boundary::resolve(col, m_colCount) && (*this)(row,col) == LifeBoard::Alive;
+}
+
 #endif /* LifeBoard_hpp */
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "Metrics.hpp"
+#include <atomic> // For recording from several threads.
+#include <fstream> // For writing the metrics file.
+#include <cstdio> // For std::rename.
+
+namespace
+{
+    /// Number of buckets of each histogram, bucket i counts times below 2^(i+1) nanoseconds.
+    constexpr int bucketCount = 40;
+
+    /**
+     * \struct Histogram
+     * \brief Distribution of the times of one phase.
+     */
+    struct Histogram
+    {
+        std::atomic<std::uint64_t> buckets[bucketCount];
+        std::atomic<std::uint64_t> count;
+        std::atomic<std::uint64_t> totalNanoseconds;
+    };
+
+    /// Histograms of every phase, static storage so they start at zero.
+    Histogram histograms[static_cast<int>(Phase::Count)];
+
+    /// Values of every counter.
+    std::atomic<std::uint64_t> counters[static_cast<int>(Counter::Count)];
+
+    const char *phaseNames[] = {"step", "publish", "render", "analysis", "com_write", "checkpoint", "cycle_check", "census"};
+
+    const char *counterNames[] = {"generations", "cells_evaluated", "tiles_updated", "tiles_skipped", "bytes_written"};
+}
+
+void recordPhase(Phase phase, std::uint64_t nanoseconds)
+{
+    // The bucket is the position of the highest set bit, times over the last bucket go in it.
+    int bucket = 63 - __builtin_clzll(nanoseconds | 1);
+    bucket = (bucket < bucketCount) ? bucket : bucketCount - 1;
+
+    Histogram &histogram = histograms[static_cast<int>(phase)];
+    histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void addCount(Counter counter, std::uint64_t amount)
+{
+    counters[static_cast<int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void writeMetrics(std::ostream &out)
+{
+    out << "# HELP gol_phase_seconds Time spent in each phase of the simulation.\n";
+    out << "# TYPE gol_phase_seconds histogram\n";
+    for(int phase = 0; phase < static_cast<int>(Phase::Count); ++phase)
+    {
+        const Histogram &histogram = histograms[phase];
+        std::uint64_t cumulative = 0;
+        for(int bucket = 0; bucket < bucketCount - 1; ++bucket)
+        {
+            cumulative += histogram.buckets[bucket].load(std::memory_order_relaxed);
+            out << "gol_phase_seconds_bucket{phase=\"" << phaseNames[phase] << "\",le=\"" << static_cast<double>(std::uint64_t(2) << bucket) * 1e-9 << "\"} " << cumulative << '\n';
+        }
+        out << "gol_phase_seconds_bucket{phase=\"" << phaseNames[phase] << "\",le=\"+Inf\"} " << histogram.count.load(std::memory_order_relaxed) << '\n';
+        out << "gol_phase_seconds_sum{phase=\"" << phaseNames[phase] << "\"} " << histogram.totalNanoseconds.load(std::memory_order_relaxed) * 1e-9 << '\n';
+        out << "gol_phase_seconds_count{phase=\"" << phaseNames[phase] << "\"} " << histogram.count.load(std::memory_order_relaxed) << '\n';
+    }
+
+    for(int counter = 0; counter < static_cast<int>(Counter::Count); ++counter)
+    {
+        out << "# TYPE gol_" << counterNames[counter] << "_total counter\n";
+        out << "gol_" << counterNames[counter] << "_total " << counters[counter].load(std::memory_order_relaxed) << '\n';
+    }
+}
+
+bool metricsEnabled()
+{
+#ifdef GOL_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+MetricsExporter::MetricsExporter(const std::string &fileName, double intervalSeconds) :
+m_fileName{fileName},
+m_interval{std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(intervalSeconds))},
+m_nextExport{std::chrono::steady_clock::now() + m_interval}
+{}
+
+bool MetricsExporter::poll()
+{
+    if(m_fileName.empty() || std::chrono::steady_clock::now() < m_nextExport)
+    {
+        return true;
+    }
+
+    return write();
+}
+
+bool MetricsExporter::write()
+{
+    if(m_fileName.empty())
+    {
+        return true;
+    }
+    m_nextExport = std::chrono::steady_clock::now() + m_interval;
+
+    std::string temporaryName = m_fileName + ".tmp";
+    {
+        std::ofstream out(temporaryName);
+        writeMetrics(out);
+        if(!out)
+        {
+            return false;
+        }
+    }
+
+    return std::rename(temporaryName.c_str(), m_fileName.c_str()) == 0;
+}
@@ -0,0 +1,170 @@
+#ifndef Metrics_hpp
+#define Metrics_hpp
+
+#include <chrono> // For timing the phases.
+#include <cstdint> // For fixed width integers.
+#include <iostream> // For the stream the metrics are written to.
+#include <string> // For the name of the metrics file.
+
+/**
+ * \file
+ * \brief Timers and counters for the phases of a simulation, exported in the Prometheus text format.
+ *
+ * Each phase of the main loop records how long it took in a histogram with power of two buckets
+ * of nanoseconds, and the steppers count the work they do. Everything is held in relaxed atomics
+ * so the render and analysis threads can record alongside the simulation without locking.
+ *
+ * The METRICS_TIME and METRICS_COUNT macros are the only way the code records anything. They
+ * compile to nothing unless GOL_METRICS is defined, which the Makefile does unless it is run with
+ * METRICS=0, so a build without metrics has no overhead at all.
+ */
+
+/**
+ * \enum Phase
+ * \brief Enumeration type to identify the timed phases of a simulation.
+ */
+enum class Phase
+{
+    Step,
+    Publish,
+    Render,
+    Analysis,
+    ComWrite,
+    Checkpoint,
+    CycleCheck,
+    Census,
+    Count,
+};
+
+/**
+ * \enum Counter
+ * \brief Enumeration type to identify the counted quantities of a simulation.
+ */
+enum class Counter
+{
+    Generations,
+    CellsEvaluated,
+    TilesUpdated,
+    TilesSkipped,
+    BytesWritten,
+    Count,
+};
+
+/**
+ *\brief Records one run of a phase.
+ *\param phase Phase that ran.
+ *\param nanoseconds how long it took.
+ */
+void recordPhase(Phase phase, std::uint64_t nanoseconds);
+
+/**
+ *\brief Adds to a counter.
+ *\param counter Counter to add to.
+ *\param amount amount to add.
+ */
+void addCount(Counter counter, std::uint64_t amount);
+
+/**
+ *\brief Writes every histogram and counter in the Prometheus text exposition format.
+ *\param out std::ostream reference to write to.
+ */
+void writeMetrics(std::ostream &out);
+
+/**
+ *\brief Checks whether the program was built with metrics.
+ *\return boolean value representing whether GOL_METRICS was defined.
+ */
+bool metricsEnabled();
+
+/**
+ * \class ScopedTimer
+ * \brief Records the time from its construction to its destruction against a phase.
+ */
+class ScopedTimer
+{
+private:
+    /// Member variable that holds the phase being timed.
+    Phase m_phase;
+
+    /// Member variable that holds when the phase started.
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    /**
+     *\brief Constructor that starts timing.
+     *\param phase Phase being timed.
+     */
+    explicit ScopedTimer(Phase phase) :
+    m_phase{phase},
+    m_start{std::chrono::steady_clock::now()}
+    {}
+
+    /**
+     *\brief Destructor that records the time against the phase.
+     */
+    ~ScopedTimer()
+    {
+        recordPhase(m_phase, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+/**
+ * \class MetricsExporter
+ * \brief Periodically replaces a file with the current metrics.
+ *
+ * The file is written under a temporary name and renamed over the old one, so a scraper such as
+ * the node exporter textfile collector never reads a partial file.
+ */
+class MetricsExporter
+{
+private:
+    /// Member variable that holds the name of the file, empty to export nothing.
+    std::string m_fileName;
+
+    /// Member variable that holds the time between exports.
+    std::chrono::steady_clock::duration m_interval;
+
+    /// Member variable that holds when the next export is due.
+    std::chrono::steady_clock::time_point m_nextExport;
+
+public:
+    /**
+     *\brief Constructor that sets up the exporter, the first export is due after one interval.
+     *\param fileName std::string holding the name of the file, empty to export nothing.
+     *\param intervalSeconds number of seconds between exports.
+     */
+    MetricsExporter(const std::string &fileName, double intervalSeconds);
+
+    /**
+     *\brief Exports the metrics if an export is due, cheap enough to call every generation.
+     *\return false if the file could not be written.
+     */
+    bool poll();
+
+    /**
+     *\brief Exports the metrics now.
+     *\return false if the file could not be written.
+     */
+    bool write();
+};
+
+#ifdef GOL_METRICS
+#define METRICS_CONCATENATE_DETAIL(a, b) a##b
+#define METRICS_CONCATENATE(a, b) METRICS_CONCATENATE_DETAIL(a, b)
+
+/// Times the rest of the enclosing scope against a Phase.
+#define METRICS_TIME(phase) ScopedTimer METRICS_CONCATENATE(metricsTimer, __LINE__)(phase)
+
+/// Adds an amount to a Counter.
+#define METRICS_COUNT(counter, amount) addCount(counter, static_cast<std::uint64_t>(amount))
+#else
+#define METRICS_TIME(phase) static_cast<void>(0)
+
+// The amount only appears in sizeof so it is never evaluated, but variables kept for it still count as used.
+#define METRICS_COUNT(counter, amount) static_cast<void>(sizeof(amount))
+#endif
+
+#endif /* Metrics_hpp */
@@ -0,0 +1,156 @@
+#include "PaddedStepper.hpp"
+#include "EvolveKernels.hpp"
+#include "ThreadPool.hpp"
+#include "Metrics.hpp"
+#include <algorithm> // For std::max, std::min and std::swap.
+#include <cstring> // For std::memcpy.
+
+PaddedStepper::PaddedStepper(std::size_t cacheBytes) :
+m_rows{0},
+m_cols{0},
+m_words{0},
+m_stride{0},
+m_stripWords{0},
+m_cacheBytes{cacheBytes},
+m_generation{0}
+{}
+
+LifeBoard::Word* PaddedStepper::paddedRow(std::vector<LifeBoard::Word> &board, int row)
+{
+    return board.data() + static_cast<std::size_t>(row + 1) * m_stride + paddedKernelSlack;
+}
+
+const LifeBoard::Word* PaddedStepper::paddedRow(const std::vector<LifeBoard::Word> &board, int row) const
+{
+    return board.data() + static_cast<std::size_t>(row + 1) * m_stride + paddedKernelSlack;
+}
+
+void PaddedStepper::setBoard(const LifeBoard &board)
+{
+    m_rows  = board.getRows();
+    m_cols  = board.getCols();
+    m_words = board.getWordsPerRow();
+
+    // Leave the kernels their slack either side of every row, rounded to whole cache lines.
+    m_stride = (paddedKernelSlack + m_words + paddedKernelSlack + 7) / 8 * 8;
+
+    // A strip holds four rows read, two written and four rows of column sums.
+    int fit = static_cast<int>(m_cacheBytes / (10 * sizeof(LifeBoard::Word))) / 8 * 8;
+    m_stripWords = std::min(m_words, std::max(fit, 8));
+
+    std::size_t size = static_cast<std::size_t>(m_rows + 3) * m_stride;
+    m_current.assign(size, 0);
+    m_updated.assign(size, 0);
+    for(int row = 0; row < m_rows; ++row)
+    {
+        std::memcpy(paddedRow(m_current, row), board.rowData(row), m_words * sizeof(LifeBoard::Word));
+    }
+    refreshGhostWords(m_current, 0, m_rows);
+    refreshGhostRows(m_current);
+    m_generation = 0;
+}
+
+void PaddedStepper::copyToBoard(LifeBoard &board) const
+{
+    // The padding bits of the last word hold a ghost cell, which the board must not see.
+    LifeBoard::Word lastMask = board.lastWordMask();
+    for(int row = 0; row < m_rows; ++row)
+    {
+        LifeBoard::Word *data = board.rowData(row);
+        std::memcpy(data, paddedRow(m_current, row), m_words * sizeof(LifeBoard::Word));
+        data[m_words - 1] &= lastMask;
+    }
+    board.invalidateStatistics();
+}
+
+void PaddedStepper::refreshGhostWords(std::vector<LifeBoard::Word> &board, int firstRow, int endRow)
+{
+    const int lastBit = (m_cols - 1) % LifeBoard::cellsPerWord;
+    const LifeBoard::Word lastMask = ~LifeBoard::Word(0) >> (LifeBoard::cellsPerWord - 1 - lastBit);
+
+    for(int row = firstRow; row < endRow; ++row)
+    {
+        // The ghost word before the row holds the last cell of the row in its top bit, and the
+        // first cell of the row goes just past the last, in the padding bits or the next word.
+        LifeBoard::Word *data = paddedRow(board, row);
+        data[m_words - 1] &= lastMask;
+        data[m_words] = 0;
+        data[-1] = (data[m_words - 1] >> lastBit) << (LifeBoard::cellsPerWord - 1);
+        data[m_cols / LifeBoard::cellsPerWord] |= (data[0] & 1) << (m_cols % LifeBoard::cellsPerWord);
+    }
+}
+
+void PaddedStepper::refreshGhostRows(std::vector<LifeBoard::Word> &board)
+{
+    std::size_t bytes = m_stride * sizeof(LifeBoard::Word);
+    std::memcpy(paddedRow(board, -1) - paddedKernelSlack, paddedRow(board, m_rows - 1) - paddedKernelSlack, bytes);
+    std::memcpy(paddedRow(board, m_rows) - paddedKernelSlack, paddedRow(board, 0) - paddedKernelSlack, bytes);
+}
+
+void PaddedStepper::evolvePairs(int firstPair, int endPair, int scratch)
+{
+    PaddedKernel evolvePair = getPaddedKernel(activeKernel());
+    LifeBoard::Word *sums = m_scratch[scratch].data();
+
+    // With an odd number of rows the last pair writes the ghost row below the board as its second
+    // row, reading the spare row below that, and refreshGhostRows() overwrites it afterwards.
+    for(int beginWord = 0; beginWord < m_words; beginWord += m_stripWords)
+    {
+        int endWord = std::min(m_words, beginWord + m_stripWords);
+        for(int pair = firstPair; pair < endPair; ++pair)
+        {
+            int row = 2 * pair;
+            evolvePair(paddedRow(m_current, row - 1), paddedRow(m_current, row), paddedRow(m_current, row + 1), paddedRow(m_current, row + 2),
+                       paddedRow(m_updated, row), paddedRow(m_updated, row + 1), sums, beginWord, endWord);
+        }
+    }
+
+    refreshGhostWords(m_updated, 2 * firstPair, std::min(2 * endPair, m_rows));
+}
+
+void PaddedStepper::step()
+{
+    m_scratch.resize(std::max<std::size_t>(m_scratch.size(), 1));
+    m_scratch[0].resize(4 * static_cast<std::size_t>(m_stripWords + 2 * paddedKernelSlack));
+    METRICS_COUNT(Counter::CellsEvaluated, static_cast<std::uint64_t>(m_rows) * m_cols);
+
+    evolvePairs(0, (m_rows + 1) / 2, 0);
+    refreshGhostRows(m_updated);
+    std::swap(m_current, m_updated);
+    ++m_generation;
+}
+
+void PaddedStepper::step(ThreadPool &pool)
+{
+    int workers = pool.getThreadCount();
+    m_scratch.resize(std::max<std::size_t>(m_scratch.size(), workers));
+    for(std::vector<LifeBoard::Word> &sums : m_scratch)
+    {
+        sums.resize(4 * static_cast<std::size_t>(m_stripWords + 2 * paddedKernelSlack));
+    }
+    METRICS_COUNT(Counter::CellsEvaluated, static_cast<std::uint64_t>(m_rows) * m_cols);
+
+    // Each worker evolves a block of pairs of rows and refreshes their ghost words, the ghost
+    // rows are copied once all the rows are done.
+    int pairs = (m_rows + 1) / 2;
+    pool.run([&](int worker)
+    {
+        evolvePairs(pairs * worker / workers, pairs * (worker + 1) / workers, worker);
+    });
+    refreshGhostRows(m_updated);
+    std::swap(m_current, m_updated);
+    ++m_generation;
+}
+
+void PaddedStepper::advance(std::uint64_t generations, ThreadPool &pool)
+{
+    for(std::uint64_t generation = 0; generation < generations; ++generation)
+    {
+        step(pool);
+    }
+}
+
+std::uint64_t PaddedStepper::getGeneration() const
+{
+    return m_generation;
+}
@@ -0,0 +1,143 @@
+#ifndef PaddedStepper_hpp
+#define PaddedStepper_hpp
+
+#include <vector> // For the padded boards and the column sum buffers.
+#include <cstddef> // For std::size_t.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+
+class ThreadPool;
+
+/**
+ * \file
+ * \brief Class to model a stepper that keeps the board in a layout padded with ghost cells.
+ *
+ * The row kernels of update() have to wrap the first and last word of every row round the torus
+ * and mask off the padding bits. This stepper instead keeps its own copy of the board with a ghost
+ * row above and below it and a ghost word either side of every row, which hold the cells from the
+ * opposite edges. The ghosts are refreshed once per generation, after which every cell has all of
+ * its neighbours in memory next to it and the kernels have no branches, wrapping or modulos at all.
+ *
+ * Neighbours are counted with running column sums: the three cells of each column about a row are
+ * added up once and the sums shared by the three cells whose blocks they are in, and the sum of
+ * the two middle rows is shared between two rows evolved together. Boards with rows too wide
+ * for the rows being worked on and the sums to stay in cache are processed in strips of columns.
+ *
+ * The stepper owns the board between setBoard() and copyToBoard(), like HashLife and SparseLife,
+ * so several generations can be advanced without converting the layout. It does the least work
+ * per cell, which pays off most while the boards fit in the L2 cache, on boards several times
+ * larger update() keeps fewer rows streaming from memory at once and is usually faster.
+ */
+class PaddedStepper
+{
+private:
+    /// Member variable that holds number of rows in the board.
+    int m_rows;
+
+    /// Member variable that holds number of columns in the board.
+    int m_cols;
+
+    /// Member variable that holds number of words in each row of the board.
+    int m_words;
+
+    /// Member variable that holds number of words between the starts of neighbouring padded rows.
+    int m_stride;
+
+    /// Member variable that holds number of words in each strip of columns.
+    int m_stripWords;
+
+    /// Member variable that holds the number of bytes the data of a strip is kept under where possible.
+    std::size_t m_cacheBytes;
+
+    /// Member variable that holds the padded board, ghost row first, then the rows, the other ghost row and a spare row.
+    std::vector<LifeBoard::Word> m_current;
+
+    /// Member variable that holds the padded board the next generation is written to.
+    std::vector<LifeBoard::Word> m_updated;
+
+    /// Member variable that holds the column sum buffer of each worker.
+    std::vector<std::vector<LifeBoard::Word>> m_scratch;
+
+    /// Member variable that holds the number of generations that have been computed.
+    std::uint64_t m_generation;
+
+    /**
+     *\brief Gives access to the first real word of a padded row.
+     *\param board padded board.
+     *\param row row of the board, -1 and m_rows are the ghost rows.
+     *\return pointer to the word holding column 0 of the row, the ghost word is just before it.
+     */
+    LifeBoard::Word* paddedRow(std::vector<LifeBoard::Word> &board, int row);
+
+    /**
+     *\brief constant version of non-constant counterpart.
+     */
+    const LifeBoard::Word* paddedRow(const std::vector<LifeBoard::Word> &board, int row) const;
+
+    /**
+     *\brief Evolves a range of pairs of rows into m_updated and refreshes their ghost words.
+     *\param firstPair first pair, pair p is made of rows 2p and 2p+1.
+     *\param endPair pair one past the last to evolve.
+     *\param scratch index of the column sum buffer to use.
+     */
+    void evolvePairs(int firstPair, int endPair, int scratch);
+
+    /**
+     *\brief Sets the ghost words of a range of rows from the cells at the opposite ends of the rows.
+     *\param board padded board.
+     *\param firstRow first row to refresh.
+     *\param endRow row one past the last to refresh.
+     */
+    void refreshGhostWords(std::vector<LifeBoard::Word> &board, int firstRow, int endRow);
+
+    /**
+     *\brief Copies the first and last rows, ghost words included, into the ghost rows.
+     *\param board padded board.
+     */
+    void refreshGhostRows(std::vector<LifeBoard::Word> &board);
+
+public:
+    /**
+     *\brief Constructor that sets up a stepper holding an empty board.
+     *\param cacheBytes size in bytes the rows and sums of a strip are kept under where possible.
+     */
+    explicit PaddedStepper(std::size_t cacheBytes = std::size_t(1) << 18);
+
+    /**
+     *\brief Replaces the board of the stepper and resets the generation.
+     *\param board LifeBoard to copy.
+     */
+    void setBoard(const LifeBoard &board);
+
+    /**
+     *\brief Copies the board of the stepper into a board of the same dimensions.
+     *\param board LifeBoard to write to.
+     */
+    void copyToBoard(LifeBoard &board) const;
+
+    /**
+     *\brief Advances the board by one generation with periodic boundary conditions.
+     */
+    void step();
+
+    /**
+     *\brief Advances the board by one generation with periodic boundary conditions using a pool of threads.
+     *\param pool ThreadPool reference, the rows are shared out between the workers.
+     */
+    void step(ThreadPool &pool);
+
+    /**
+     *\brief Advances the board by a number of generations using a pool of threads.
+     *\param generations number of generations to advance by.
+     *\param pool ThreadPool reference, the rows are shared out between the workers.
+     */
+    void advance(std::uint64_t generations, ThreadPool &pool);
+
+    /**
+     *\brief Getter for the number of generations computed since the board was set.
+     *\return Integer value representing the generation.
+     */
+    std::uint64_t getGeneration() const;
+};
+
+#endif /* PaddedStepper_hpp */
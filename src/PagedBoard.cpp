@@ -0,0 +1,678 @@
+#include "PagedBoard.hpp"
+#include "EvolveKernels.hpp"
+#include "Metrics.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm> // For std::fill, std::copy, std::min and std::any_of.
+#include <stdexcept> // For std::runtime_error and std::invalid_argument.
+#include <cstring> // For std::memcmp, std::memcpy and std::strerror.
+#include <cerrno> // For errno.
+#include <iterator> // For std::prev.
+#include <exception> // For std::exception_ptr.
+#include <fcntl.h> // For open.
+#include <unistd.h> // For close, pread, pwrite, ftruncate and sysconf.
+#include <sys/mman.h> // For mmap and munmap.
+#include <sys/stat.h> // For fstat.
+
+namespace
+{
+    /// Bytes at the start of every board file.
+    const char boardFileMagic[8] = {'G', 'O', 'L', 'T', 'I', 'L', 'E', 'S'};
+
+    /// Version of the layout of the board file.
+    const std::uint32_t boardFileVersion = 2;
+
+    /**
+     * \struct BoardFileHeader
+     * \brief Header at the start of a board file, followed by the directory of slots and then the slots.
+     */
+    struct BoardFileHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t tileRows;
+        std::uint32_t tileWords;
+        std::int32_t  rows;
+        std::int32_t  cols;
+        std::uint32_t slotCount;
+        std::uint32_t slotBytes;
+    };
+
+    /**
+     *\brief Builds the exception thrown when a system call on a board file fails.
+     *\param what std::string describing what was being done.
+     *\param fileName std::string holding the name of the file.
+     *\return std::runtime_error holding the message and the reason for the failure.
+     */
+    std::runtime_error boardFileError(const std::string &what, const std::string &fileName)
+    {
+        return std::runtime_error("Could not " + what + " board file " + fileName + ": " + std::strerror(errno));
+    }
+
+    /// Largest slot stride accepted from a board file.
+    const std::uint32_t maxSlotBytes = 1u << 30;
+
+    /**
+     *\brief Works out the offset of slot 1, just after the directory rounded up to a whole slot.
+     *\param tiles number of tiles on the board.
+     *\param slotBytes number of bytes from the start of one slot to the start of the next.
+     *\return offset in bytes.
+     */
+    std::uint64_t slotOffsetFor(std::uint64_t tiles, std::uint64_t slotBytes)
+    {
+        std::uint64_t directoryEnd = sizeof(BoardFileHeader) + tiles * sizeof(std::uint32_t);
+        return (directoryEnd + slotBytes - 1) / slotBytes * slotBytes;
+    }
+
+    /**
+     *\brief Gives the size of the pages of this machine.
+     *\return number of bytes in a page.
+     */
+    std::uint64_t systemPageBytes()
+    {
+        long page = sysconf(_SC_PAGESIZE);
+        return page > 0 ? static_cast<std::uint64_t>(page) : 4096;
+    }
+
+    /**
+     *\brief Wraps an index onto the torus.
+     *\param index index that may be negative or past the end.
+     *\param size number of indices round the torus.
+     *\return index in the range [0, size).
+     */
+    int wrap(long long index, int size)
+    {
+        long long wrapped = index % size;
+        return static_cast<int>(wrapped < 0 ? wrapped + size : wrapped);
+    }
+}
+
+PagedBoard::PagedBoard(const std::string &fileName, int rows, int cols, std::size_t cacheBytes) :
+m_fileName{fileName},
+m_descriptor{-1},
+m_rows{rows},
+m_cols{cols},
+m_words{cols / LifeBoard::cellsPerWord},
+m_tilesDown{(rows + tileRows - 1) / tileRows},
+m_tilesAcross{(cols + tileCols - 1) / tileCols},
+m_slotOffset{0},
+m_slotBytes{0},
+m_pageBytes{systemPageBytes()},
+m_slotCount{0},
+m_cacheTiles{std::max<std::size_t>(cacheBytes / tileBytes, 1)}
+{
+    if(rows < 1 || cols < 1 || cols % LifeBoard::cellsPerWord != 0)
+    {
+        throw std::invalid_argument("A paged board needs at least one row and a column count that is a positive multiple of 64.");
+    }
+
+    m_descriptor = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(m_descriptor < 0)
+    {
+        throw boardFileError("create", fileName);
+    }
+
+    m_directory.assign(static_cast<std::size_t>(m_tilesDown) * m_tilesAcross, 0);
+    // Slots of whole pages let every tile be mapped on its own.
+    m_slotBytes  = static_cast<std::uint32_t>((tileBytes + m_pageBytes - 1) / m_pageBytes * m_pageBytes);
+    m_slotOffset = slotOffsetFor(m_directory.size(), m_slotBytes);
+    if(ftruncate(m_descriptor, static_cast<off_t>(m_slotOffset)) != 0)
+    {
+        int error = errno;
+        close(m_descriptor);
+        errno = error;
+        throw boardFileError("size", fileName);
+    }
+    writeDirectory();
+}
+
+PagedBoard::PagedBoard(const std::string &fileName, std::size_t cacheBytes) :
+m_fileName{fileName},
+m_descriptor{-1},
+m_rows{0},
+m_cols{0},
+m_words{0},
+m_tilesDown{0},
+m_tilesAcross{0},
+m_slotOffset{0},
+m_slotBytes{0},
+m_pageBytes{systemPageBytes()},
+m_slotCount{0},
+m_cacheTiles{std::max<std::size_t>(cacheBytes / tileBytes, 1)}
+{
+    m_descriptor = open(fileName.c_str(), O_RDWR);
+    if(m_descriptor < 0)
+    {
+        throw boardFileError("open", fileName);
+    }
+
+    // Close the file again if anything about it is wrong.
+    try
+    {
+        BoardFileHeader header;
+        if(pread(m_descriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            throw std::runtime_error("Board file " + fileName + " is too short.");
+        }
+        if(std::memcmp(header.magic, boardFileMagic, sizeof(boardFileMagic)) != 0 || header.version != boardFileVersion)
+        {
+            throw std::runtime_error("File " + fileName + " is not a board file of this version.");
+        }
+        if(header.tileRows != tileRows || header.tileWords != tileWords || header.rows < 1 || header.cols < 1 || header.cols % LifeBoard::cellsPerWord != 0
+           || header.slotBytes < tileBytes || header.slotBytes > maxSlotBytes)
+        {
+            throw std::runtime_error("Board file " + fileName + " has a layout this build does not support.");
+        }
+
+        m_rows        = header.rows;
+        m_cols        = header.cols;
+        m_words       = m_cols / LifeBoard::cellsPerWord;
+        m_tilesDown   = (m_rows + tileRows - 1) / tileRows;
+        m_tilesAcross = (m_cols + tileCols - 1) / tileCols;
+        m_slotCount   = header.slotCount;
+        m_slotBytes   = header.slotBytes;
+        m_directory.assign(static_cast<std::size_t>(m_tilesDown) * m_tilesAcross, 0);
+        m_slotOffset  = slotOffsetFor(m_directory.size(), m_slotBytes);
+
+        std::size_t directoryBytes = m_directory.size() * sizeof(std::uint32_t);
+        struct stat status;
+        if(fstat(m_descriptor, &status) != 0 || static_cast<std::uint64_t>(status.st_size) < m_slotOffset + static_cast<std::uint64_t>(m_slotCount) * m_slotBytes
+           || pread(m_descriptor, m_directory.data(), directoryBytes, sizeof(header)) != static_cast<ssize_t>(directoryBytes))
+        {
+            throw std::runtime_error("Board file " + fileName + " is truncated.");
+        }
+
+        // Slots no tile refers to are free, which also catches a directory that is corrupt.
+        std::vector<bool> used(static_cast<std::size_t>(m_slotCount) + 1, false);
+        for(std::uint32_t slot : m_directory)
+        {
+            if(slot > m_slotCount || (slot != 0 && used[slot]))
+            {
+                throw std::runtime_error("Board file " + fileName + " has a corrupt directory.");
+            }
+            used[slot] = true;
+        }
+        for(std::uint32_t slot = m_slotCount; slot >= 1; --slot)
+        {
+            if(!used[slot])
+            {
+                m_freeSlots.push_back(slot);
+            }
+        }
+    }
+    catch(...)
+    {
+        close(m_descriptor);
+        throw;
+    }
+}
+
+PagedBoard::~PagedBoard()
+{
+    // A destructor has no way to report a failure, callers that need to know use flush() first.
+    try
+    {
+        evictAll();
+        writeDirectory();
+    }
+    catch(const std::runtime_error&)
+    {
+    }
+    close(m_descriptor);
+}
+
+int PagedBoard::getRows() const
+{
+    return m_rows;
+}
+
+int PagedBoard::getCols() const
+{
+    return m_cols;
+}
+
+std::size_t PagedBoard::getStoredTiles() const
+{
+    return m_slotCount - m_freeSlots.size();
+}
+
+LifeBoard::Word* PagedBoard::tileData(std::uint32_t tile, bool create) const
+{
+    auto cached = m_cached.find(tile);
+    if(cached != m_cached.end())
+    {
+        m_cache.splice(m_cache.begin(), m_cache, cached->second);
+        return cached->second->words;
+    }
+
+    // Dead tiles have nothing to map unless they are about to be written to.
+    std::uint32_t slot = m_directory[tile];
+    bool fresh = false;
+    if(slot == 0)
+    {
+        if(!create)
+        {
+            return nullptr;
+        }
+        if(!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            // Growing the file gives the new slot zeros.
+            slot = m_slotCount + 1;
+            if(ftruncate(m_descriptor, static_cast<off_t>(m_slotOffset + static_cast<std::uint64_t>(slot) * m_slotBytes)) != 0)
+            {
+                throw boardFileError("grow", m_fileName);
+            }
+            m_slotCount = slot;
+        }
+        m_directory[tile] = slot;
+        fresh = true;
+    }
+
+    if(m_cache.size() >= m_cacheTiles)
+    {
+        evict(std::prev(m_cache.end()));
+    }
+
+    // A file written on a machine with smaller pages may have slots that do not start on a page
+    // of this one, so the mapping starts at the page holding the slot.
+    std::uint64_t offset = m_slotOffset + static_cast<std::uint64_t>(slot - 1) * m_slotBytes;
+    std::uint64_t start  = offset / m_pageBytes * m_pageBytes;
+    std::size_t mappedBytes = static_cast<std::size_t>(offset - start) + tileBytes;
+    void *mapped = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_descriptor, static_cast<off_t>(start));
+    if(mapped == MAP_FAILED)
+    {
+        throw boardFileError("map a tile of", m_fileName);
+    }
+    LifeBoard::Word *words = reinterpret_cast<LifeBoard::Word*>(static_cast<char*>(mapped) + (offset - start));
+
+    // Slots given back by tiles that died only hold zeros if the tile died before it was unmapped.
+    if(fresh)
+    {
+        std::fill(words, words + tileBytes / sizeof(LifeBoard::Word), LifeBoard::Word(0));
+    }
+
+    m_cache.push_front(CachedTile{tile, words, mapped, mappedBytes});
+    m_cached[tile] = m_cache.begin();
+    return words;
+}
+
+void PagedBoard::evict(std::list<CachedTile>::iterator entry) const
+{
+    // A tile that has died gives its slot back so dead tiles stay unstored.
+    LifeBoard::Word *words = entry->words;
+    if(!std::any_of(words, words + tileBytes / sizeof(LifeBoard::Word), [](LifeBoard::Word word){ return word != 0; }))
+    {
+        m_freeSlots.push_back(m_directory[entry->tile]);
+        m_directory[entry->tile] = 0;
+    }
+
+    munmap(entry->mapping, entry->mappedBytes);
+    m_cached.erase(entry->tile);
+    m_cache.erase(entry);
+}
+
+void PagedBoard::evictAll() const
+{
+    while(!m_cache.empty())
+    {
+        evict(m_cache.begin());
+    }
+}
+
+void PagedBoard::writeDirectory() const
+{
+    BoardFileHeader header;
+    std::memcpy(header.magic, boardFileMagic, sizeof(boardFileMagic));
+    header.version   = boardFileVersion;
+    header.tileRows  = tileRows;
+    header.tileWords = tileWords;
+    header.rows      = m_rows;
+    header.cols      = m_cols;
+    header.slotCount = m_slotCount;
+    header.slotBytes = m_slotBytes;
+
+    std::size_t directoryBytes = m_directory.size() * sizeof(std::uint32_t);
+    if(pwrite(m_descriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+       || pwrite(m_descriptor, m_directory.data(), directoryBytes, sizeof(header)) != static_cast<ssize_t>(directoryBytes))
+    {
+        throw boardFileError("write the directory of", m_fileName);
+    }
+}
+
+void PagedBoard::flush() const
+{
+    writeDirectory();
+}
+
+void PagedBoard::readTileBlock(int row, int word, int rows, int words, LifeBoard::Word *destination, int stride) const
+{
+    std::uint32_t tile = static_cast<std::uint32_t>(row / tileRows) * m_tilesAcross + word / tileWords;
+    const LifeBoard::Word *data = tileData(tile, false);
+    for(int blockRow = 0; blockRow < rows; ++blockRow)
+    {
+        LifeBoard::Word *out = destination + static_cast<std::size_t>(blockRow) * stride;
+        if(data)
+        {
+            const LifeBoard::Word *in = data + (row % tileRows + blockRow) * tileWords + word % tileWords;
+            std::copy(in, in + words, out);
+        }
+        else
+        {
+            std::fill(out, out + words, LifeBoard::Word(0));
+        }
+    }
+}
+
+void PagedBoard::readBlock(int row, int word, int rows, int words, LifeBoard::Word *destination, int stride) const
+{
+    for(int blockRow = row; blockRow < row + rows; blockRow = (blockRow / tileRows + 1) * tileRows)
+    {
+        int tileEnd = std::min(row + rows, (blockRow / tileRows + 1) * tileRows);
+        for(int blockWord = word; blockWord < word + words; blockWord = (blockWord / tileWords + 1) * tileWords)
+        {
+            int wordEnd = std::min(word + words, (blockWord / tileWords + 1) * tileWords);
+            readTileBlock(blockRow, blockWord, tileEnd - blockRow, wordEnd - blockWord,
+                          destination + static_cast<std::size_t>(blockRow - row) * stride + (blockWord - word), stride);
+        }
+    }
+}
+
+void PagedBoard::writeBits(int row, int word, LifeBoard::Word bits, LifeBoard::Word mask)
+{
+    std::uint32_t tile = static_cast<std::uint32_t>(row / tileRows) * m_tilesAcross + word / tileWords;
+    LifeBoard::Word *data = tileData(tile, (bits & mask) != 0);
+    if(data)
+    {
+        LifeBoard::Word &target = data[(row % tileRows) * tileWords + word % tileWords];
+        target = (target & ~mask) | (bits & mask);
+    }
+}
+
+LifeBoard::CellReference PagedBoard::operator()(int row, int col)
+{
+    row = wrap(row, m_rows);
+    col = wrap(col, m_cols);
+    std::uint32_t tile = static_cast<std::uint32_t>(row / tileRows) * m_tilesAcross + col / tileCols;
+    LifeBoard::Word *data = tileData(tile, true);
+    return LifeBoard::CellReference(data[(row % tileRows) * tileWords + (col % tileCols) / LifeBoard::cellsPerWord], LifeBoard::Word(1) << (col % LifeBoard::cellsPerWord));
+}
+
+LifeBoard::State PagedBoard::operator()(int row, int col) const
+{
+    row = wrap(row, m_rows);
+    col = wrap(col, m_cols);
+    std::uint32_t tile = static_cast<std::uint32_t>(row / tileRows) * m_tilesAcross + col / tileCols;
+    const LifeBoard::Word *data = tileData(tile, false);
+    if(!data)
+    {
+        return LifeBoard::Dead;
+    }
+    LifeBoard::Word word = data[(row % tileRows) * tileWords + (col % tileCols) / LifeBoard::cellsPerWord];
+    return ((word >> (col % LifeBoard::cellsPerWord)) & 1) ? LifeBoard::Alive : LifeBoard::Dead;
+}
+
+void PagedBoard::clear()
+{
+    // Unmap first so no tile is written after the file is cut back to the directory.
+    evictAll();
+    std::fill(m_directory.begin(), m_directory.end(), 0);
+    m_freeSlots.clear();
+    m_slotCount = 0;
+    if(ftruncate(m_descriptor, static_cast<off_t>(m_slotOffset)) != 0)
+    {
+        throw boardFileError("truncate", m_fileName);
+    }
+}
+
+void PagedBoard::randomise(std::uint64_t seed, double density)
+{
+    clear();
+    std::vector<LifeBoard::Word> words(tileBytes / sizeof(LifeBoard::Word));
+    for(int tileRow = 0; tileRow < m_tilesDown; ++tileRow)
+    {
+        for(int tileCol = 0; tileCol < m_tilesAcross; ++tileCol)
+        {
+            // The words are numbered as on a LifeBoard so both give the same board for a seed.
+            int rows  = std::min(tileRows, m_rows - tileRow * tileRows);
+            int width = std::min(tileWords, m_words - tileCol * tileWords);
+            std::fill(words.begin(), words.end(), LifeBoard::Word(0));
+            for(int row = 0; row < rows; ++row)
+            {
+                std::uint64_t first = static_cast<std::uint64_t>(tileRow * tileRows + row) * m_words + tileCol * tileWords;
+                for(int word = 0; word < width; ++word)
+                {
+                    words[row * tileWords + word] = LifeBoard::randomWord(seed, first + word, density);
+                }
+            }
+
+            if(std::any_of(words.begin(), words.end(), [](LifeBoard::Word word){ return word != 0; }))
+            {
+                std::copy(words.begin(), words.end(), tileData(static_cast<std::uint32_t>(tileRow) * m_tilesAcross + tileCol, true));
+            }
+        }
+    }
+}
+
+void PagedBoard::setRegion(int row, int col, const LifeBoard &region)
+{
+    // Each word of the region covers at most two words of the board, split at the shift.
+    int shift = wrap(col, m_cols) % LifeBoard::cellsPerWord;
+    for(int regionRow = 0; regionRow < region.getRows(); ++regionRow)
+    {
+        int boardRow = wrap(static_cast<long long>(row) + regionRow, m_rows);
+        const LifeBoard::Word *words = region.rowData(regionRow);
+        for(int regionWord = 0; regionWord < region.getWordsPerRow(); ++regionWord)
+        {
+            LifeBoard::Word mask = (regionWord == region.getWordsPerRow() - 1) ? region.lastWordMask() : ~LifeBoard::Word(0);
+            int boardWord = wrap(static_cast<long long>(col) + static_cast<long long>(regionWord) * LifeBoard::cellsPerWord, m_cols) / LifeBoard::cellsPerWord;
+            writeBits(boardRow, boardWord, words[regionWord] << shift, mask << shift);
+            if(shift > 0)
+            {
+                int shift2 = LifeBoard::cellsPerWord - shift;
+                writeBits(boardRow, (boardWord + 1) % m_words, words[regionWord] >> shift2, mask >> shift2);
+            }
+        }
+    }
+}
+
+void PagedBoard::copyRegion(int row, int col, LifeBoard &region) const
+{
+    int firstCol = wrap(col, m_cols);
+    int shift = firstCol % LifeBoard::cellsPerWord;
+    int regionWords = region.getWordsPerRow();
+
+    // Each row of the region is built from the words it overlaps, read a tile at a time and
+    // split where the row wraps round the board.
+    std::vector<LifeBoard::Word> source(static_cast<std::size_t>(regionWords) + 1);
+    int firstWord = firstCol / LifeBoard::cellsPerWord;
+    int sourceWords = static_cast<int>(source.size());
+    for(int regionRow = 0; regionRow < region.getRows(); ++regionRow)
+    {
+        int boardRow = wrap(static_cast<long long>(row) + regionRow, m_rows);
+        for(int done = 0; done < sourceWords; )
+        {
+            int word  = (firstWord + done) % m_words;
+            int count = std::min(sourceWords - done, m_words - word);
+            readBlock(boardRow, word, 1, count, source.data() + done, count);
+            done += count;
+        }
+
+        LifeBoard::Word *out = region.rowData(regionRow);
+        for(int word = 0; word < regionWords; ++word)
+        {
+            out[word] = shift ? (source[word] >> shift) | (source[word + 1] << (LifeBoard::cellsPerWord - shift)) : source[word];
+        }
+        out[regionWords - 1] &= region.lastWordMask();
+    }
+
+    region.setOrigin(row, col);
+}
+
+long long PagedBoard::getPopulation() const
+{
+    long long population = 0;
+    for(std::uint32_t tile = 0; tile < m_directory.size(); ++tile)
+    {
+        const LifeBoard::Word *words = tileData(tile, false);
+        if(words)
+        {
+            for(std::size_t word = 0; word < tileBytes / sizeof(LifeBoard::Word); ++word)
+            {
+                population += __builtin_popcountll(words[word]);
+            }
+        }
+    }
+    return population;
+}
+
+void PagedBoard::markActiveTiles(std::vector<char> &active) const
+{
+    // Cells can only change in tiles with live cells and in the tiles around them.
+    active.assign(m_directory.size(), 0);
+    for(int tileRow = 0; tileRow < m_tilesDown; ++tileRow)
+    {
+        for(int tileCol = 0; tileCol < m_tilesAcross; ++tileCol)
+        {
+            if(m_directory[static_cast<std::size_t>(tileRow) * m_tilesAcross + tileCol] == 0)
+            {
+                continue;
+            }
+            for(int rowOffset = -1; rowOffset <= 1; ++rowOffset)
+            {
+                for(int colOffset = -1; colOffset <= 1; ++colOffset)
+                {
+                    active[static_cast<std::size_t>(wrap(tileRow + rowOffset, m_tilesDown)) * m_tilesAcross + wrap(tileCol + colOffset, m_tilesAcross)] = 1;
+                }
+            }
+        }
+    }
+}
+
+void PagedBoard::evolveTile(std::uint32_t tile, const PagedBoard &currentBoard, std::vector<LifeBoard::Word> &halo, std::vector<LifeBoard::Word> &evolved)
+{
+    const int stride = tileWords + 2;
+    int firstRow  = static_cast<int>(tile / m_tilesAcross) * tileRows;
+    int firstWord = static_cast<int>(tile % m_tilesAcross) * tileWords;
+    int height    = std::min(tileRows, m_rows - firstRow);
+    int width     = std::min(tileWords, m_words - firstWord);
+
+    // Gather the tile and its halo as three bands of rows by three bands of words, each inside a
+    // single tile of the board. The lock is held for the whole gather so no other worker unmaps a
+    // tile while it is being copied.
+    const int bandRows[3]   = {wrap(firstRow - 1, m_rows), firstRow, wrap(firstRow + height, m_rows)};
+    const int bandHeights[3] = {1, height, 1};
+    const int bandWords[3]  = {wrap(firstWord - 1, m_words), firstWord, wrap(firstWord + width, m_words)};
+    const int bandWidths[3] = {1, width, 1};
+    {
+        std::lock_guard<std::mutex> lock(currentBoard.m_cacheMutex);
+        for(int band = 0, haloRow = 0; band < 3; haloRow += bandHeights[band], ++band)
+        {
+            for(int column = 0, haloWord = 0; column < 3; haloWord += bandWidths[column], ++column)
+            {
+                currentBoard.readTileBlock(bandRows[band], bandWords[column], bandHeights[band], bandWidths[column],
+                                           &halo[static_cast<std::size_t>(haloRow) * stride + haloWord], stride);
+            }
+        }
+    }
+
+    // The tile is evolved under dead edges, so only the halo words themselves come out wrong and
+    // they are dropped.
+    RowKernel evolveRow = getRowKernel<DeadEdge>(activeKernel());
+    bool alive = false;
+    for(int row = 0; row < height; ++row)
+    {
+        const LifeBoard::Word *centre = &halo[static_cast<std::size_t>(row + 1) * stride];
+        LifeBoard::Word *out = &evolved[static_cast<std::size_t>(row) * stride];
+        evolveRow(centre - stride, centre, centre + stride, out, width + 2, (width + 2) * LifeBoard::cellsPerWord, ~LifeBoard::Word(0), 1, width + 1);
+        for(int word = 1; word <= width; ++word)
+        {
+            alive = alive || out[word] != 0;
+        }
+    }
+    METRICS_COUNT(Counter::TilesUpdated, 1);
+    METRICS_COUNT(Counter::CellsEvaluated, static_cast<std::uint64_t>(height) * width * LifeBoard::cellsPerWord);
+
+    // Tiles that come out dead are left without a slot.
+    if(alive)
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        LifeBoard::Word *data = tileData(tile, true);
+        for(int row = 0; row < height; ++row)
+        {
+            const LifeBoard::Word *out = &evolved[static_cast<std::size_t>(row) * stride + 1];
+            std::copy(out, out + width, data + row * tileWords);
+        }
+    }
+}
+
+void update(PagedBoard &updatedBoard, const PagedBoard &currentBoard)
+{
+    updatedBoard.clear();
+    std::vector<char> active;
+    currentBoard.markActiveTiles(active);
+
+    // The tile is evolved in a buffer with a halo row above and below and a halo word either side.
+    const int stride = PagedBoard::tileWords + 2;
+    std::vector<LifeBoard::Word> halo(static_cast<std::size_t>(PagedBoard::tileRows + 2) * stride);
+    std::vector<LifeBoard::Word> evolved(static_cast<std::size_t>(PagedBoard::tileRows) * stride);
+    for(std::uint32_t tile = 0; tile < active.size(); ++tile)
+    {
+        if(!active[tile])
+        {
+            METRICS_COUNT(Counter::TilesSkipped, 1);
+            continue;
+        }
+        updatedBoard.evolveTile(tile, currentBoard, halo, evolved);
+    }
+}
+
+void update(PagedBoard &updatedBoard, const PagedBoard &currentBoard, ThreadPool &pool)
+{
+    updatedBoard.clear();
+    std::vector<char> active;
+    currentBoard.markActiveTiles(active);
+
+    const int tilesDown   = currentBoard.m_tilesDown;
+    const int tilesAcross = currentBoard.m_tilesAcross;
+    const int bands       = pool.getThreadCount();
+    const int stride      = PagedBoard::tileWords + 2;
+
+    // A failure to grow or map the board file is handed back to the calling thread.
+    std::vector<std::exception_ptr> failures(bands);
+    pool.run([&](int worker)
+    {
+        try
+        {
+            std::vector<LifeBoard::Word> halo(static_cast<std::size_t>(PagedBoard::tileRows + 2) * stride);
+            std::vector<LifeBoard::Word> evolved(static_cast<std::size_t>(PagedBoard::tileRows) * stride);
+
+            // Split the tile rows as evenly as possible between the workers.
+            int beginTileRow = static_cast<int>(static_cast<long long>(tilesDown) * worker / bands);
+            int endTileRow   = static_cast<int>(static_cast<long long>(tilesDown) * (worker + 1) / bands);
+            for(std::uint32_t tile = static_cast<std::uint32_t>(beginTileRow) * tilesAcross; tile < static_cast<std::uint32_t>(endTileRow) * tilesAcross; ++tile)
+            {
+                if(!active[tile])
+                {
+                    METRICS_COUNT(Counter::TilesSkipped, 1);
+                    continue;
+                }
+                updatedBoard.evolveTile(tile, currentBoard, halo, evolved);
+            }
+        }
+        catch(...)
+        {
+            failures[worker] = std::current_exception();
+        }
+    });
+    for(const std::exception_ptr &failure : failures)
+    {
+        if(failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+}
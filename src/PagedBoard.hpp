@@ -0,0 +1,318 @@
+#ifndef PagedBoard_hpp
+#define PagedBoard_hpp
+
+#include <vector> // For the tile directory and free slots.
+#include <list> // For the least recently used order of the cached tiles.
+#include <unordered_map> // For finding cached tiles.
+#include <mutex> // For sharing the cache between the workers of an update.
+#include <string> // For the name of the board file.
+#include <cstddef> // For std::size_t.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+
+class ThreadPool;
+
+/**
+ * \file
+ * \brief Class to model a board on the torus kept in a tiled file on disk, for boards bigger than memory.
+ *
+ * The board is cut into tiles of tileRows by tileCols cells, each stored in its own slot of the
+ * board file with the same packed rows as LifeBoard. Only tiles with live cells have a slot, a
+ * directory in front of the slots says which slot holds each tile and entirely dead tiles simply
+ * have none. Tiles are mapped into memory one at a time when they are first touched and kept in a
+ * cache of a fixed size, the least recently used tile being unmapped to make room for the next, so
+ * memory use is set by the size of the cache and the directory rather than by rows*cols.
+ *
+ * Cells are indexed like a LifeBoard, but all the other work goes a tile at a time so each tile is
+ * only looked up once: copyRegion() copies a rectangular viewport into a LifeBoard, which can then
+ * be drawn or have its centre of mass taken without touching the rest of the board, and update()
+ * only evolves the tiles that have live cells and their neighbours. The column count must be a
+ * multiple of LifeBoard::cellsPerWord so rows have no padding bits to wrap round.
+ */
+class PagedBoard
+{
+public:
+    /// Number of rows of cells in a tile.
+    static constexpr int tileRows = 256;
+
+    /// Number of words in each row of a tile.
+    static constexpr int tileWords = 4;
+
+    /// Number of columns of cells in a tile.
+    static constexpr int tileCols = tileWords * LifeBoard::cellsPerWord;
+
+    /// Number of bytes of cells in a tile, the slot of each tile is rounded up to whole pages.
+    static constexpr std::size_t tileBytes = static_cast<std::size_t>(tileRows) * tileWords * sizeof(LifeBoard::Word);
+
+private:
+    /**
+     * \struct CachedTile
+     * \brief A tile mapped into memory.
+     */
+    struct CachedTile
+    {
+        /// Index of the tile, tile row times the tiles across plus tile column.
+        std::uint32_t tile;
+
+        /// Mapped words of the tile, tileRows rows of tileWords words.
+        LifeBoard::Word *words;
+
+        /// Start of the mapping, the page holding the start of the slot.
+        void *mapping;
+
+        /// Number of bytes mapped, from the start of the page to the end of the tile.
+        std::size_t mappedBytes;
+    };
+
+    /// Member variable that holds the name of the board file.
+    std::string m_fileName;
+
+    /// Member variable that holds the descriptor of the open board file.
+    int m_descriptor;
+
+    /// Member variable that holds number of rows on the board.
+    int m_rows;
+
+    /// Member variable that holds number of columns on the board.
+    int m_cols;
+
+    /// Member variable that holds number of words in each row of the board.
+    int m_words;
+
+    /// Member variable that holds number of tiles down the board.
+    int m_tilesDown;
+
+    /// Member variable that holds number of tiles across the board.
+    int m_tilesAcross;
+
+    /// Member variable that holds the offset in the file of slot 1, slot 0 stands for a dead tile.
+    std::uint64_t m_slotOffset;
+
+    /// Member variable that holds the number of bytes from the start of one slot to the next, recorded in the file.
+    std::uint32_t m_slotBytes;
+
+    /// Member variable that holds the size of the pages of this machine, which mappings start on.
+    std::uint64_t m_pageBytes;
+
+    /// Member variable that holds the number of slots in the file.
+    mutable std::uint32_t m_slotCount;
+
+    /// Member variable that holds the slot of each tile, 0 for tiles that are entirely dead.
+    mutable std::vector<std::uint32_t> m_directory;
+
+    /// Member variable that holds slots in the file that no tile uses.
+    mutable std::vector<std::uint32_t> m_freeSlots;
+
+    /// Member variable that holds the greatest number of tiles kept mapped at once.
+    std::size_t m_cacheTiles;
+
+    /// Member variable that holds the mapped tiles, most recently used first.
+    mutable std::list<CachedTile> m_cache;
+
+    /// Member variable that finds the entry of each mapped tile in m_cache.
+    mutable std::unordered_map<std::uint32_t, std::list<CachedTile>::iterator> m_cached;
+
+    /// Member variable that guards the cache, the directory and the free slots while workers share the board.
+    mutable std::mutex m_cacheMutex;
+
+    /**
+     *\brief Gives access to the words of a tile, mapping it if it is not cached.
+     *\param tile index of the tile.
+     *\param create whether a dead tile is given a slot, otherwise nullptr is returned for it.
+     *\return pointer to the words of the tile, valid until the next tile is mapped.
+     */
+    LifeBoard::Word* tileData(std::uint32_t tile, bool create) const;
+
+    /**
+     *\brief Unmaps a cached tile, giving its slot back if the tile has died.
+     *\param entry iterator to the tile in m_cache.
+     */
+    void evict(std::list<CachedTile>::iterator entry) const;
+
+    /**
+     *\brief Unmaps every cached tile.
+     */
+    void evictAll() const;
+
+    /**
+     *\brief Copies a block of words that lies inside a single tile, dead tiles give zeros.
+     *\param row first row of the block.
+     *\param word first word of the block.
+     *\param rows number of rows in the block.
+     *\param words number of words in each row of the block.
+     *\param destination pointer to the first word to copy to.
+     *\param stride number of words between the rows of the destination.
+     */
+    void readTileBlock(int row, int word, int rows, int words, LifeBoard::Word *destination, int stride) const;
+
+    /**
+     *\brief Copies a block of words on the board without wrapping round, a tile at a time.
+     *\param row first row of the block.
+     *\param word first word of the block.
+     *\param rows number of rows in the block.
+     *\param words number of words in each row of the block.
+     *\param destination pointer to the first word to copy to.
+     *\param stride number of words between the rows of the destination.
+     */
+    void readBlock(int row, int word, int rows, int words, LifeBoard::Word *destination, int stride) const;
+
+    /**
+     *\brief Sets some of the bits of a word of the board.
+     *\param row row of the word.
+     *\param word index of the word in the row.
+     *\param bits new values of the bits.
+     *\param mask bits of the word to set.
+     */
+    void writeBits(int row, int word, LifeBoard::Word bits, LifeBoard::Word mask);
+
+    /**
+     *\brief Writes the header and the directory to the board file.
+     */
+    void writeDirectory() const;
+
+    /**
+     *\brief Marks the tiles whose cells can change in the next generation.
+     *\param active std::vector<char> that is set to 1 for tiles with live cells and the tiles around them.
+     */
+    void markActiveTiles(std::vector<char> &active) const;
+
+    /**
+     *\brief Evolves one tile of a board into this board, holding each board's lock only while copying.
+     *\param tile index of the tile.
+     *\param currentBoard PagedBoard the tile is evolved from.
+     *\param halo std::vector<LifeBoard::Word> the tile and its halo are gathered into.
+     *\param evolved std::vector<LifeBoard::Word> the evolved rows are written to.
+     */
+    void evolveTile(std::uint32_t tile, const PagedBoard &currentBoard, std::vector<LifeBoard::Word> &halo, std::vector<LifeBoard::Word> &evolved);
+
+public:
+    /**
+     *\brief Constructor that creates a board file holding a board of dead cells, replacing any existing file.
+     *\param fileName std::string holding the name of the board file.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board, a multiple of LifeBoard::cellsPerWord.
+     *\param cacheBytes number of bytes of tiles to keep mapped at once, at least one tile is.
+     *\throws std::invalid_argument if the dimensions are not allowed.
+     *\throws std::runtime_error if the file cannot be created.
+     */
+    PagedBoard(const std::string &fileName, int rows, int cols, std::size_t cacheBytes);
+
+    /**
+     *\brief Constructor that opens an existing board file.
+     *\param fileName std::string holding the name of the board file.
+     *\param cacheBytes number of bytes of tiles to keep mapped at once, at least one tile is.
+     *\throws std::runtime_error if the file cannot be opened or is not a board file.
+     */
+    PagedBoard(const std::string &fileName, std::size_t cacheBytes);
+
+    /**
+     *\brief Destructor that writes the directory and closes the board file.
+     */
+    ~PagedBoard();
+
+    PagedBoard(const PagedBoard&) = delete;
+    PagedBoard& operator=(const PagedBoard&) = delete;
+
+    /**
+     *\brief Getter for the number of rows.
+     *\return Integer value representing the number of rows on the board.
+     */
+    int getRows() const;
+
+    /**
+     *\brief Getter for the number of columns.
+     *\return Integer value representing the number of columns on the board.
+     */
+    int getCols() const;
+
+    /**
+     *\brief Getter for the number of tiles with a slot in the file.
+     *\return number of stored tiles, tiles that died since they were last unmapped are included.
+     */
+    std::size_t getStoredTiles() const;
+
+    /**
+     *\brief Gives access to a cell, giving its tile a slot if it has none.
+     *\param row row of the cell, periodic boundary conditions apply.
+     *\param col column of the cell, periodic boundary conditions apply.
+     *\return proxy for the cell, valid until the next access to the board.
+     */
+    LifeBoard::CellReference operator()(int row, int col);
+
+    /**
+     *\brief Reads a cell, dead tiles are not given a slot.
+     *\param row row of the cell, periodic boundary conditions apply.
+     *\param col column of the cell, periodic boundary conditions apply.
+     *\return State of the cell.
+     */
+    LifeBoard::State operator()(int row, int col) const;
+
+    /**
+     *\brief Sets every cell dead, giving back the slots of all the tiles.
+     */
+    void clear();
+
+    /**
+     *\brief Randomises the cells from a seed exactly as LifeBoard::randomise() would, tiles left dead are not stored.
+     *\param seed std::uint64_t seed of the counters.
+     *\param density probability of each cell being alive.
+     */
+    void randomise(std::uint64_t seed, double density);
+
+    /**
+     *\brief Copies the cells of a board into a rectangle of this board.
+     *\param row row the top of the region goes to, periodic boundary conditions apply.
+     *\param col column the left of the region goes to, periodic boundary conditions apply.
+     *\param region LifeBoard holding the cells, no bigger than this board.
+     */
+    void setRegion(int row, int col, const LifeBoard &region);
+
+    /**
+     *\brief Copies a rectangular viewport of this board into a board, only reading the tiles it covers.
+     *\param row row of the top of the viewport, periodic boundary conditions apply.
+     *\param col column of the left of the viewport, periodic boundary conditions apply.
+     *\param region LifeBoard the viewport is copied to, its dimensions are those of the viewport.
+     *
+     * The origin of the region is set to the top left of the viewport, so its centreOfMass() is in 
+     * the coordinates of this board.
+     */
+    void copyRegion(int row, int col, LifeBoard &region) const;
+
+    /**
+     *\brief Counts the live cells, which maps every stored tile.
+     *\return number of live cells on the board.
+     */
+    long long getPopulation() const;
+
+    /**
+     *\brief Writes the directory so the file describes the board, the cached tiles are written back by the kernel.
+     */
+    void flush() const;
+
+    /**
+     *\brief Updates the board with periodic boundary conditions, only evolving tiles near live cells.
+     *\param updatedBoard PagedBoard that will hold the updated board, its cells are replaced.
+     *\param currentBoard PagedBoard that is the board the update is based on, a different board of the same dimensions.
+     *
+     * Each tile that has live cells, or is next to one that has, is copied with a halo of one cell
+     * from its neighbours, evolved with the active row kernel under the active rule and written
+     * back only if it has live cells. Tiles are processed in order so the tiles above stay cached
+     * if the cache holds three rows of tiles.
+     */
+    friend void update(PagedBoard &updatedBoard, const PagedBoard &currentBoard);
+
+    /**
+     *\brief Updates the board with periodic boundary conditions using a pool of threads.
+     *\param updatedBoard PagedBoard that will hold the updated board, its cells are replaced.
+     *\param currentBoard PagedBoard that is the board the update is based on, a different board of the same dimensions.
+     *\param pool ThreadPool reference, each worker evolves one contiguous band of tile rows.
+     *
+     * Produces exactly the same board as the serial update. Each worker has its own halo and
+     * evolved buffers and only takes the lock of a board to copy a tile in or out, so the rows
+     * are evolved concurrently. The tiles above each band stay cached if the cache holds three
+     * rows of tiles for every worker.
+     */
+    friend void update(PagedBoard &updatedBoard, const PagedBoard &currentBoard, ThreadPool &pool);
+};
+
+#endif /* PagedBoard_hpp */
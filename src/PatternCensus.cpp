@@ -0,0 +1,748 @@
+#include "PatternCensus.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm> // For std::sort, std::min and std::max.
+#include <atomic> // For handing out the components.
+#include <climits> // For INT_MAX and INT_MIN.
+#include <cstdio> // For std::snprintf.
+#include <map> // For counting neighbours when building the table.
+#include <set> // For the live cells when building the table.
+#include <unordered_map> // For the table and for gathering the census.
+#include <unordered_set> // For the pieces of the phases that fall apart.
+
+namespace
+{
+    /**
+     * \struct KnownObject
+     * \brief An object of Conway's Life whose phases are put in the table of known objects.
+     */
+    struct KnownObject
+    {
+        /// Name of the object.
+        const char *name;
+
+        /// Number of generations before the object returns to its first phase.
+        int period;
+
+        /// Cells of the first phase, rows separated by '/' with 'O' for a live cell.
+        const char *pattern;
+    };
+
+    const KnownObject knownObjects[] =
+    {
+        {"block",            1, "OO/OO"},
+        {"beehive",          1, ".OO./O..O/.OO."},
+        {"loaf",             1, ".OO./O..O/.O.O/..O."},
+        {"boat",             1, "OO./O.O/.O."},
+        {"ship",             1, "OO./O.O/.OO"},
+        {"tub",              1, ".O./O.O/.O."},
+        {"pond",             1, ".OO./O..O/O..O/.OO."},
+        {"long_boat",        1, "OO../O.O./.O.O/..O."},
+        {"barge",            1, ".O../O.O./.O.O/..O."},
+        {"mango",            1, ".OO../O..O./.O..O/..OO."},
+        {"eater_1",          1, "OO../O.O./..O./..OO"},
+        {"snake",            1, "OO.O/O.OO"},
+        {"blinker",          2, "OOO"},
+        {"toad",             2, ".OOO/OOO."},
+        {"beacon",           2, "OO../OO../..OO/..OO"},
+        {"glider",           4, ".O./..O/OOO"},
+        {"lwss",             4, ".O..O/O..../O...O/OOOO."},
+        {"mwss",             4, "...O../.O...O/O...../O....O/OOOOO."},
+        {"hwss",             4, "...OO../.O....O/O....../O.....O/OOOOOO."}
+    };
+
+    /**
+     *\brief Turns the pattern of a known object into its live cells.
+     *\param pattern rows separated by '/' with 'O' for a live cell.
+     *\return std::vector of the row and column of each live cell.
+     */
+    std::vector<std::pair<int,int>> parsePattern(const char *pattern)
+    {
+        std::vector<std::pair<int,int>> cells;
+        int row = 0;
+        int col = 0;
+        for(const char *character = pattern; *character != '\0'; ++character)
+        {
+            if(*character == '/')
+            {
+                ++row;
+                col = 0;
+                continue;
+            }
+
+            if(*character == 'O')
+            {
+                cells.emplace_back(row, col);
+            }
+            ++col;
+        }
+
+        return cells;
+    }
+
+    /**
+     *\brief Evolves a set of cells on an unbounded board under the rules of Conway's Life.
+     *\param cells std::vector of the live cells.
+     *\return std::vector of the live cells a generation later.
+     */
+    std::vector<std::pair<int,int>> stepCells(const std::vector<std::pair<int,int>> &cells)
+    {
+        std::set<std::pair<int,int>> alive(cells.begin(), cells.end());
+        std::map<std::pair<int,int>, int> neighbours;
+        for(const std::pair<int,int> &cell : cells)
+        {
+            for(int rowOffset = -1; rowOffset <= 1; ++rowOffset)
+            {
+                for(int colOffset = -1; colOffset <= 1; ++colOffset)
+                {
+                    if(rowOffset != 0 || colOffset != 0)
+                    {
+                        ++neighbours[std::make_pair(cell.first + rowOffset, cell.second + colOffset)];
+                    }
+                }
+            }
+        }
+
+        std::vector<std::pair<int,int>> next;
+        for(const std::pair<const std::pair<int,int>, int> &entry : neighbours)
+        {
+            if(entry.second == 3 || (entry.second == 2 && alive.count(entry.first) != 0))
+            {
+                next.push_back(entry.first);
+            }
+        }
+
+        return next;
+    }
+
+    /**
+     *\brief Splits a set of cells into the objects it is made of under the Moore neighbourhood.
+     *\param cells std::vector of the live cells.
+     *\return std::vector of the cells of each object, in which every cell can be reached from every other through touching cells.
+     */
+    std::vector<std::vector<std::pair<int,int>>> connectedPieces(const std::vector<std::pair<int,int>> &cells)
+    {
+        std::vector<std::vector<std::pair<int,int>>> pieces;
+        std::set<std::pair<int,int>> unvisited(cells.begin(), cells.end());
+        while(!unvisited.empty())
+        {
+            std::vector<std::pair<int,int>> piece{*unvisited.begin()};
+            std::vector<std::pair<int,int>> pending{*unvisited.begin()};
+            unvisited.erase(unvisited.begin());
+            while(!pending.empty())
+            {
+                std::pair<int,int> cell = pending.back();
+                pending.pop_back();
+                for(int rowOffset = -1; rowOffset <= 1; ++rowOffset)
+                {
+                    for(int colOffset = -1; colOffset <= 1; ++colOffset)
+                    {
+                        std::set<std::pair<int,int>>::iterator neighbour = unvisited.find(std::make_pair(cell.first + rowOffset, cell.second + colOffset));
+                        if(neighbour != unvisited.end())
+                        {
+                            piece.push_back(*neighbour);
+                            pending.push_back(*neighbour);
+                            unvisited.erase(neighbour);
+                        }
+                    }
+                }
+            }
+            pieces.push_back(piece);
+        }
+
+        return pieces;
+    }
+
+    /**
+     *\brief Mixes the position of a cell into a hash, the finaliser of SplitMix64 applied to the packed position.
+     *\param row row of the cell relative to the top of the object.
+     *\param col column of the cell relative to the left of the object.
+     *\return hash of the position.
+     */
+    inline std::uint64_t mixPosition(int row, int col)
+    {
+        std::uint64_t mixed = ((static_cast<std::uint64_t>(row) << 32) | static_cast<std::uint32_t>(col)) + 0x9E3779B97F4A7C15ull;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+        return mixed ^ (mixed >> 31);
+    }
+
+    /**
+     * \struct KnownTable
+     * \brief Canonical hashes of the phases of the known objects.
+     */
+    struct KnownTable
+    {
+        /// Name of the object of each phase, from the canonical hash of the whole phase.
+        std::unordered_map<std::uint64_t, std::string> names;
+
+        /// Canonical hashes of the pieces of the phases that fall apart into two pieces that do not touch.
+        std::unordered_set<std::uint64_t> pieces;
+    };
+
+    /**
+     *\brief Builds the table of known objects from the hashes of each of their phases.
+     *\return KnownTable of the phases and of the pieces of the phases that fall apart.
+     *
+     * Phases that fall apart into more than two pieces are left out, none of the objects in the
+     * table have any.
+     */
+    KnownTable buildKnownTable()
+    {
+        KnownTable table;
+        for(const KnownObject &object : knownObjects)
+        {
+            std::vector<std::pair<int,int>> cells = parsePattern(object.pattern);
+            for(int phase = 0; phase < object.period; ++phase)
+            {
+                std::vector<std::vector<std::pair<int,int>>> pieces = connectedPieces(cells);
+                if(pieces.size() <= 2)
+                {
+                    table.names.emplace(PatternCensus::canonicalHash(cells), object.name);
+                }
+                if(pieces.size() == 2)
+                {
+                    table.pieces.insert(PatternCensus::canonicalHash(pieces[0]));
+                    table.pieces.insert(PatternCensus::canonicalHash(pieces[1]));
+                }
+                cells = stepCells(cells);
+            }
+        }
+
+        return table;
+    }
+
+    /**
+     *\brief Gives the table of known objects, building it the first time.
+     *\return reference to the KnownTable.
+     */
+    const KnownTable& knownTable()
+    {
+        static const KnownTable table = buildKnownTable();
+        return table;
+    }
+
+    /**
+     *\brief Moves the cells of an object wrapping round an edge of the torus so it is in one piece.
+     *\param cells std::vector of the cells of the object.
+     *\param coordinate member of each cell to unwrap, the row or the column.
+     *\param size number of rows or columns on the board.
+     *
+     * The object is cut at the largest gap between the rows or columns it occupies, going round
+     * the torus, and whatever lies before the cut is moved a whole board on to follow the rest.
+     */
+    void unwrapCells(std::vector<std::pair<int,int>> &cells, int std::pair<int,int>::*coordinate, int size)
+    {
+        static thread_local std::vector<int> occupied;
+        occupied.clear();
+        for(const std::pair<int,int> &cell : cells)
+        {
+            occupied.push_back(cell.*coordinate);
+        }
+        std::sort(occupied.begin(), occupied.end());
+        occupied.erase(std::unique(occupied.begin(), occupied.end()), occupied.end());
+
+        // The gap across the edge is left alone if it is already the largest.
+        int largestGap = occupied.front() + size - occupied.back();
+        int cut = -1;
+        for(std::size_t index = 0; index + 1 < occupied.size(); ++index)
+        {
+            if(occupied[index + 1] - occupied[index] > largestGap)
+            {
+                largestGap = occupied[index + 1] - occupied[index];
+                cut = occupied[index];
+            }
+        }
+
+        for(std::pair<int,int> &cell : cells)
+        {
+            if(cell.*coordinate <= cut)
+            {
+                cell.*coordinate += size;
+            }
+        }
+    }
+
+    /**
+     *\brief Moves the cells of an object on the torus so it is in one piece, if it reaches opposite edges.
+     *\param cells std::vector of the cells of the object.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     */
+    void unwrapObject(std::vector<std::pair<int,int>> &cells, int rows, int cols)
+    {
+        bool top    = false;
+        bool bottom = false;
+        bool left   = false;
+        bool right  = false;
+        for(const std::pair<int,int> &cell : cells)
+        {
+            top    = top || cell.first == 0;
+            bottom = bottom || cell.first == rows - 1;
+            left   = left || cell.second == 0;
+            right  = right || cell.second == cols - 1;
+        }
+
+        // Only objects reaching both opposite edges can wrap round the torus.
+        if(top && bottom)
+        {
+            unwrapCells(cells, &std::pair<int,int>::first, rows);
+        }
+        if(left && right)
+        {
+            unwrapCells(cells, &std::pair<int,int>::second, cols);
+        }
+    }
+}
+
+PatternCensus::PatternCensus() :
+m_objectCount{0}
+{
+}
+
+std::uint32_t PatternCensus::find(std::uint32_t run)
+{
+    while(m_parent[run] != run)
+    {
+        m_parent[run] = m_parent[m_parent[run]];
+        run = m_parent[run];
+    }
+
+    return run;
+}
+
+void PatternCensus::unite(std::uint32_t first, std::uint32_t second)
+{
+    first  = find(first);
+    second = find(second);
+    if(first < second)
+    {
+        m_parent[second] = first;
+    }
+    else if(second < first)
+    {
+        m_parent[first] = second;
+    }
+}
+
+void PatternCensus::uniteRows(int row, int above, int cols, bool periodic)
+{
+    std::uint32_t beginAbove = m_rowFirstRun[above];
+    std::uint32_t endAbove   = m_rowFirstRun[above + 1];
+    std::uint32_t beginRow   = m_rowFirstRun[row];
+    std::uint32_t endRow     = m_rowFirstRun[row + 1];
+    if(beginAbove == endAbove || beginRow == endRow)
+    {
+        return;
+    }
+
+    // Walk along both rows at once, runs touch if they overlap or meet at a corner.
+    std::uint32_t upper = beginAbove;
+    std::uint32_t lower = beginRow;
+    while(upper < endAbove && lower < endRow)
+    {
+        const Run &upperRun = m_runs[upper];
+        const Run &lowerRun = m_runs[lower];
+        if(upperRun.end + 1 >= lowerRun.begin && lowerRun.end + 1 >= upperRun.begin)
+        {
+            unite(upper, lower);
+        }
+
+        if(upperRun.end < lowerRun.end)
+        {
+            ++upper;
+        }
+        else
+        {
+            ++lower;
+        }
+    }
+
+    // On the torus the ends of the rows also touch diagonally across the left and right edges.
+    if(periodic)
+    {
+        if(m_runs[endAbove - 1].end == cols - 1 && m_runs[beginRow].begin == 0)
+        {
+            unite(endAbove - 1, beginRow);
+        }
+        if(m_runs[endRow - 1].end == cols - 1 && m_runs[beginAbove].begin == 0)
+        {
+            unite(endRow - 1, beginAbove);
+        }
+    }
+}
+
+void PatternCensus::gatherCells(std::uint32_t component, std::vector<std::pair<int,int>> &cells) const
+{
+    for(std::uint32_t index = m_componentFirstRun[component]; index < m_componentFirstRun[component + 1]; ++index)
+    {
+        const Run &run = m_runs[m_order[index]];
+        for(int col = run.begin; col <= run.end; ++col)
+        {
+            cells.emplace_back(run.row, col);
+        }
+    }
+}
+
+std::uint64_t PatternCensus::hashComponent(std::uint32_t component, int rows, int cols, bool periodic) const
+{
+    if(m_componentCells[component] > maxClassifiedCells)
+    {
+        return 0;
+    }
+
+    static thread_local std::vector<std::pair<int,int>> cells;
+    cells.clear();
+    gatherCells(component, cells);
+    if(periodic)
+    {
+        unwrapObject(cells, rows, cols);
+    }
+
+    return canonicalHash(cells);
+}
+
+long long PatternCensus::mergePieces(std::uint32_t componentCount, int rows, int cols, bool periodic)
+{
+    const KnownTable &table = knownTable();
+    m_merged.assign(componentCount, 0);
+
+    // Bucket the pieces by their first cell. The buckets are at least bucketSize cells across, so
+    // the pieces of one phase, which lie within a few cells of each other, are always in the same
+    // bucket or in buckets next to each other, round the torus as well.
+    const int bucketSize = 8;
+    const int bucketRows = std::max(1, rows / bucketSize);
+    const int bucketCols = std::max(1, cols / bucketSize);
+    std::vector<std::pair<long long, std::uint32_t>> pieces;
+    for(std::uint32_t component = 0; component < componentCount; ++component)
+    {
+        if(table.pieces.count(m_componentHash[component]) != 0)
+        {
+            const Run &first = m_runs[m_order[m_componentFirstRun[component]]];
+            int bucketRow = std::min(first.row / bucketSize, bucketRows - 1);
+            int bucketCol = std::min(first.begin / bucketSize, bucketCols - 1);
+            pieces.emplace_back(static_cast<long long>(bucketRow) * bucketCols + bucketCol, component);
+        }
+    }
+    std::sort(pieces.begin(), pieces.end());
+
+    // Each piece is paired with the first piece nearby that makes a phase of a known object with it.
+    long long absorbed = 0;
+    std::vector<std::pair<int,int>> cells;
+    for(const std::pair<long long, std::uint32_t> &piece : pieces)
+    {
+        std::uint32_t component = piece.second;
+        int bucketRow = static_cast<int>(piece.first / bucketCols);
+        int bucketCol = static_cast<int>(piece.first % bucketCols);
+        for(int rowOffset = -1; rowOffset <= 1 && m_merged[component] == 0; ++rowOffset)
+        {
+            for(int colOffset = -1; colOffset <= 1 && m_merged[component] == 0; ++colOffset)
+            {
+                int row = bucketRow + rowOffset;
+                int col = bucketCol + colOffset;
+                if(!periodic && (row < 0 || row >= bucketRows || col < 0 || col >= bucketCols))
+                {
+                    continue;
+                }
+                long long bucket = static_cast<long long>((row + bucketRows) % bucketRows) * bucketCols + (col + bucketCols) % bucketCols;
+                std::vector<std::pair<long long, std::uint32_t>>::const_iterator other = std::lower_bound(pieces.begin(), pieces.end(), std::make_pair(bucket, std::uint32_t(0)));
+                for(; other != pieces.end() && other->first == bucket; ++other)
+                {
+                    if(other->second == component || m_merged[other->second] != 0)
+                    {
+                        continue;
+                    }
+
+                    cells.clear();
+                    gatherCells(component, cells);
+                    gatherCells(other->second, cells);
+                    if(periodic)
+                    {
+                        unwrapObject(cells, rows, cols);
+                    }
+                    std::uint64_t hash = canonicalHash(cells);
+                    if(table.names.count(hash) != 0)
+                    {
+                        m_componentHash[component] = hash;
+                        m_componentCells[component] += m_componentCells[other->second];
+                        m_merged[component] = 2;
+                        m_merged[other->second] = 1;
+                        ++absorbed;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return absorbed;
+}
+
+const std::vector<CensusEntry>& PatternCensus::count(const LifeBoard &board, bool periodic, ThreadPool &pool)
+{
+    int rows  = board.getRows();
+    int cols  = board.getCols();
+    int words = board.getWordsPerRow();
+    int bands = pool.getThreadCount();
+
+    // Count the runs starting in each row so every row knows where its runs go.
+    m_rowFirstRun.assign(rows + 1, 0);
+    pool.run([&](int worker)
+    {
+        int beginRow = static_cast<int>(static_cast<long long>(rows) * worker / bands);
+        int endRow   = static_cast<int>(static_cast<long long>(rows) * (worker + 1) / bands);
+        for(int row = beginRow; row < endRow; ++row)
+        {
+            const LifeBoard::Word *cells = board.rowData(row);
+            LifeBoard::Word carry = 0;
+            std::uint32_t runs = 0;
+            for(int word = 0; word < words; ++word)
+            {
+                runs += __builtin_popcountll(cells[word] & ~((cells[word] << 1) | carry));
+                carry = cells[word] >> 63;
+            }
+            m_rowFirstRun[row + 1] = runs;
+        }
+    });
+
+    for(int row = 0; row < rows; ++row)
+    {
+        m_rowFirstRun[row + 1] += m_rowFirstRun[row];
+    }
+    std::uint32_t runCount = m_rowFirstRun[rows];
+    m_runs.resize(runCount);
+    m_parent.resize(runCount);
+
+    // Cut each row into runs and link the runs that touch within each worker's band of rows,
+    // every link stays inside the band so the workers never share a tree.
+    pool.run([&](int worker)
+    {
+        int beginRow = static_cast<int>(static_cast<long long>(rows) * worker / bands);
+        int endRow   = static_cast<int>(static_cast<long long>(rows) * (worker + 1) / bands);
+        for(int row = beginRow; row < endRow; ++row)
+        {
+            const LifeBoard::Word *cells = board.rowData(row);
+            Run *runs = m_runs.data() + m_rowFirstRun[row];
+            int begins = 0;
+            int ends   = 0;
+            LifeBoard::Word carry = 0;
+            for(int word = 0; word < words; ++word)
+            {
+                LifeBoard::Word next = word + 1 < words ? cells[word + 1] & 1 : 0;
+                LifeBoard::Word starts = cells[word] & ~((cells[word] << 1) | carry);
+                LifeBoard::Word stops  = cells[word] & ~((cells[word] >> 1) | (next << 63));
+                for(; starts != 0; starts &= starts - 1)
+                {
+                    runs[begins].row   = row;
+                    runs[begins].begin = word * LifeBoard::cellsPerWord + __builtin_ctzll(starts);
+                    ++begins;
+                }
+                for(; stops != 0; stops &= stops - 1)
+                {
+                    runs[ends].end = word * LifeBoard::cellsPerWord + __builtin_ctzll(stops);
+                    ++ends;
+                }
+                carry = cells[word] >> 63;
+            }
+
+            std::uint32_t first = m_rowFirstRun[row];
+            std::uint32_t last  = m_rowFirstRun[row + 1];
+            for(std::uint32_t run = first; run < last; ++run)
+            {
+                m_parent[run] = run;
+            }
+
+            // On the torus the first and last runs of a row touch across the left and right edges.
+            if(periodic && last - first > 1 && m_runs[first].begin == 0 && m_runs[last - 1].end == cols - 1)
+            {
+                unite(first, last - 1);
+            }
+
+            if(row > beginRow)
+            {
+                uniteRows(row, row - 1, cols, periodic);
+            }
+        }
+    });
+
+    // Link the runs touching across the edges of the bands, and of the board on the torus.
+    for(int worker = 1; worker < bands; ++worker)
+    {
+        int beginRow = static_cast<int>(static_cast<long long>(rows) * worker / bands);
+        if(beginRow > 0 && beginRow < rows)
+        {
+            uniteRows(beginRow, beginRow - 1, cols, periodic);
+        }
+    }
+    if(periodic && rows > 1)
+    {
+        uniteRows(0, rows - 1, cols, periodic);
+    }
+
+    // Parents always come before their runs, so one pass in order labels every run with its component.
+    m_component.resize(runCount);
+    m_componentCells.clear();
+    for(std::uint32_t run = 0; run < runCount; ++run)
+    {
+        if(m_parent[run] == run)
+        {
+            m_component[run] = static_cast<std::uint32_t>(m_componentCells.size());
+            m_componentCells.push_back(0);
+        }
+        else
+        {
+            m_component[run] = m_component[m_parent[run]];
+        }
+        m_componentCells[m_component[run]] += m_runs[run].end - m_runs[run].begin + 1;
+    }
+    std::uint32_t componentCount = static_cast<std::uint32_t>(m_componentCells.size());
+
+    // Sort the runs by component, keeping them in order within each component.
+    m_componentFirstRun.assign(componentCount + 1, 0);
+    for(std::uint32_t run = 0; run < runCount; ++run)
+    {
+        ++m_componentFirstRun[m_component[run]];
+    }
+    std::uint32_t total = 0;
+    for(std::uint32_t component = 0; component <= componentCount; ++component)
+    {
+        std::uint32_t runs = m_componentFirstRun[component];
+        m_componentFirstRun[component] = total;
+        total += runs;
+    }
+    m_order.resize(runCount);
+    for(std::uint32_t run = 0; run < runCount; ++run)
+    {
+        m_order[m_componentFirstRun[m_component[run]]++] = run;
+    }
+    for(std::uint32_t component = componentCount; component > 0; --component)
+    {
+        m_componentFirstRun[component] = m_componentFirstRun[component - 1];
+    }
+    m_componentFirstRun[0] = 0;
+
+    // Hash the components in chunks handed out as the workers finish, objects vary a lot in size.
+    m_componentHash.resize(componentCount);
+    const std::uint32_t chunk = 256;
+    std::atomic<std::uint32_t> nextComponent{0};
+    pool.run([&](int)
+    {
+        for(std::uint32_t begin = nextComponent.fetch_add(chunk); begin < componentCount; begin = nextComponent.fetch_add(chunk))
+        {
+            std::uint32_t end = std::min(begin + chunk, componentCount);
+            for(std::uint32_t component = begin; component < end; ++component)
+            {
+                m_componentHash[component] = hashComponent(component, rows, cols, periodic);
+            }
+        }
+    });
+
+    // Phases of known objects that fall apart are put back together from their pieces.
+    long long absorbed = mergePieces(componentCount, rows, cols, periodic);
+
+    // Gather the components into kinds, components too big to classify all count as one kind.
+    std::unordered_map<std::uint64_t, std::size_t> kinds;
+    m_census.clear();
+    for(std::uint32_t component = 0; component < componentCount; ++component)
+    {
+        if(m_merged[component] == 1)
+        {
+            continue;
+        }
+        std::uint64_t hash = m_componentHash[component];
+        std::pair<std::unordered_map<std::uint64_t, std::size_t>::iterator, bool> kind = kinds.emplace(hash, m_census.size());
+        if(kind.second)
+        {
+            CensusEntry entry;
+            entry.hash  = hash;
+            entry.cells = hash == 0 ? 0 : m_componentCells[component];
+            entry.count = 0;
+            entry.name  = hash == 0 ? "oversized" : knownName(hash);
+            if(entry.name.empty())
+            {
+                char name[32];
+                std::snprintf(name, sizeof(name), "unknown_%016llx", static_cast<unsigned long long>(hash));
+                entry.name = name;
+            }
+            m_census.push_back(entry);
+        }
+        ++m_census[kind.first->second].count;
+    }
+
+    std::sort(m_census.begin(), m_census.end(), [](const CensusEntry &first, const CensusEntry &second)
+    {
+        return first.count != second.count ? first.count > second.count : first.name < second.name;
+    });
+    m_objectCount = static_cast<long long>(componentCount) - absorbed;
+
+    return m_census;
+}
+
+const std::vector<CensusEntry>& PatternCensus::getCensus() const
+{
+    return m_census;
+}
+
+long long PatternCensus::getObjectCount() const
+{
+    return m_objectCount;
+}
+
+std::uint64_t PatternCensus::canonicalHash(const std::vector<std::pair<int,int>> &cells)
+{
+    int minRow = INT_MAX;
+    int maxRow = INT_MIN;
+    int minCol = INT_MAX;
+    int maxCol = INT_MIN;
+    for(const std::pair<int,int> &cell : cells)
+    {
+        minRow = std::min(minRow, cell.first);
+        maxRow = std::max(maxRow, cell.first);
+        minCol = std::min(minCol, cell.second);
+        maxCol = std::max(maxCol, cell.second);
+    }
+
+    // Each of the eight orientations flips the rows, the columns or both, with or without swapping
+    // rows and columns, measured from the corner of the bounding box that becomes the top left.
+    // Summing the mixed positions makes the hashes independent of the order of the cells.
+    std::uint64_t hashes[8];
+    std::fill(hashes, hashes + 8, cells.size() * 0x9E3779B97F4A7C15ull);
+    for(const std::pair<int,int> &cell : cells)
+    {
+        int row        = cell.first - minRow;
+        int col        = cell.second - minCol;
+        int flippedRow = maxRow - cell.first;
+        int flippedCol = maxCol - cell.second;
+        hashes[0] += mixPosition(row, col);
+        hashes[1] += mixPosition(flippedRow, col);
+        hashes[2] += mixPosition(row, flippedCol);
+        hashes[3] += mixPosition(flippedRow, flippedCol);
+        hashes[4] += mixPosition(col, row);
+        hashes[5] += mixPosition(col, flippedRow);
+        hashes[6] += mixPosition(flippedCol, row);
+        hashes[7] += mixPosition(flippedCol, flippedRow);
+    }
+    std::uint64_t smallest = *std::min_element(hashes, hashes + 8);
+
+    // 0 stands for components too big to classify.
+    return smallest == 0 ? 1 : smallest;
+}
+
+std::string PatternCensus::knownName(std::uint64_t hash)
+{
+    const std::unordered_map<std::uint64_t, std::string> &names = knownTable().names;
+    std::unordered_map<std::uint64_t, std::string>::const_iterator known = names.find(hash);
+    return known == names.end() ? std::string() : known->second;
+}
+
+void writeCensusCsvHeader(std::ostream &out)
+{
+    out << "generation,object,cells,count\n";
+}
+
+void writeCensusCsv(std::ostream &out, std::uint64_t generation, const std::vector<CensusEntry> &census)
+{
+    for(const CensusEntry &entry : census)
+    {
+        out << generation << ',' << entry.name << ',' << entry.cells << ',' << entry.count << '\n';
+    }
+}
@@ -0,0 +1,212 @@
+#ifndef PatternCensus_hpp
+#define PatternCensus_hpp
+
+#include <vector> // For the runs, the labels and the census.
+#include <string> // For the names of the objects.
+#include <utility> // For std::pair.
+#include <iostream> // For the stream the census is written to.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+
+class ThreadPool;
+
+/**
+ * \file
+ * \brief Class to model a census of the separate objects on a board, such as the ash left by a soup.
+ *
+ * Objects are the connected components of live cells under the Moore neighbourhood, wrapping
+ * round the edges on the torus. The live cells of each row are first cut into runs, the workers
+ * of a ThreadPool each label the runs of a band of rows with a union-find forest that links runs
+ * touching in neighbouring rows, and the few runs touching across the edges of the bands and the
+ * board are linked afterwards. Every link makes the higher run point at the lower one, so a
+ * single pass in order then gives every run the root of its component.
+ *
+ * Each component is then classified from a hash of its cells in a canonical orientation, the
+ * smallest of the hashes of its eight rotations and reflections, so the same object matches
+ * however it lies. The hashes of the phases of the common objects of Conway's Life are known and
+ * anything else is reported by its hash. Some phases fall apart into two pieces that do not touch,
+ * such as the second phases of the toad and the beacon, so pieces of those phases lying near each
+ * other are put back together when together they make the phase, and are counted as one object.
+ */
+
+/**
+ * \struct CensusEntry
+ * \brief Number of objects of one kind found on a board.
+ */
+struct CensusEntry
+{
+    /// Name of the object, unknown_ followed by the hash for objects not in the table.
+    std::string name;
+
+    /// Canonical hash of the object, 0 for components too big to classify.
+    std::uint64_t hash;
+
+    /// Number of live cells in each object, 0 for components too big to classify.
+    int cells;
+
+    /// Number of objects of this kind.
+    long long count;
+};
+
+class PatternCensus
+{
+private:
+    /**
+     * \struct Run
+     * \brief Horizontal run of live cells in a row.
+     */
+    struct Run
+    {
+        /// Row of the run.
+        int row;
+
+        /// Column of the first cell of the run.
+        int begin;
+
+        /// Column of the last cell of the run.
+        int end;
+    };
+
+    /// Member variable that holds the runs of the board, row by row from left to right.
+    std::vector<Run> m_runs;
+
+    /// Member variable that holds the index of the first run of each row, with one past the last run at the end.
+    std::vector<std::uint32_t> m_rowFirstRun;
+
+    /// Member variable that holds the parent of each run in the union-find forest, never above the run itself.
+    std::vector<std::uint32_t> m_parent;
+
+    /// Member variable that holds the component of each run.
+    std::vector<std::uint32_t> m_component;
+
+    /// Member variable that holds the index of the first run of each component in m_order, with one past the last at the end.
+    std::vector<std::uint32_t> m_componentFirstRun;
+
+    /// Member variable that holds the runs sorted by component.
+    std::vector<std::uint32_t> m_order;
+
+    /// Member variable that holds the number of cells in each component.
+    std::vector<int> m_componentCells;
+
+    /// Member variable that holds the canonical hash of each component.
+    std::vector<std::uint64_t> m_componentHash;
+
+    /// Member variable that holds 1 for components counted as part of another, 2 for components that took in another.
+    std::vector<char> m_merged;
+
+    /// Member variable that holds the census of the last board counted.
+    std::vector<CensusEntry> m_census;
+
+    /// Member variable that holds the number of objects on the last board counted.
+    long long m_objectCount;
+
+    /**
+     *\brief Finds the root of the tree of a run, halving the path on the way.
+     *\param run index of the run.
+     *\return index of the root run.
+     */
+    std::uint32_t find(std::uint32_t run);
+
+    /**
+     *\brief Links the trees of two runs, the higher root pointing at the lower.
+     *\param first index of a run.
+     *\param second index of another run.
+     */
+    void unite(std::uint32_t first, std::uint32_t second);
+
+    /**
+     *\brief Links the runs of a row that touch runs of the row above it.
+     *\param row row whose runs are linked to those of the row above.
+     *\param above row above, which is the last row on the torus for row 0.
+     *\param cols number of columns on the board.
+     *\param periodic whether runs touch across the left and right edges.
+     */
+    void uniteRows(int row, int above, int cols, bool periodic);
+
+    /**
+     *\brief Works out the canonical hash of a component.
+     *\param component index of the component.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     *\param periodic whether the component may wrap round the edges.
+     *\return canonical hash of the cells of the component.
+     */
+    std::uint64_t hashComponent(std::uint32_t component, int rows, int cols, bool periodic) const;
+
+    /**
+     *\brief Appends the cells of a component, as they lie on the board.
+     *\param component index of the component.
+     *\param cells std::vector the row and column of each cell is appended to.
+     */
+    void gatherCells(std::uint32_t component, std::vector<std::pair<int,int>> &cells) const;
+
+    /**
+     *\brief Puts together pairs of components that are the pieces of a phase of a known object.
+     *\param componentCount number of components.
+     *\param rows number of rows on the board.
+     *\param cols number of columns on the board.
+     *\param periodic whether the pieces may lie across the edges.
+     *\return number of components taken in by another, which no longer count as objects.
+     */
+    long long mergePieces(std::uint32_t componentCount, int rows, int cols, bool periodic);
+
+public:
+    /// Largest number of cells of a component that is classified, bigger ones are counted together as oversized.
+    static constexpr int maxClassifiedCells = 4096;
+
+    /**
+     *\brief Constructor that sets up an empty census.
+     */
+    PatternCensus();
+
+    /**
+     *\brief Labels the objects on a board and counts them by kind.
+     *\param board LifeBoard to take the census of.
+     *\param periodic whether objects wrap round the edges of the board, true on the torus.
+     *\param pool ThreadPool reference, the rows and components are shared out between the workers.
+     *\return reference to the census, most common objects first, valid until the next count.
+     */
+    const std::vector<CensusEntry>& count(const LifeBoard &board, bool periodic, ThreadPool &pool);
+
+    /**
+     *\brief Getter for the census of the last board counted.
+     *\return reference to the census, most common objects first.
+     */
+    const std::vector<CensusEntry>& getCensus() const;
+
+    /**
+     *\brief Getter for the number of objects on the last board counted.
+     *\return number of connected components.
+     */
+    long long getObjectCount() const;
+
+    /**
+     *\brief Works out the hash of a set of cells that is the same for all its rotations and reflections.
+     *\param cells std::vector of the row and column of each live cell, in any order.
+     *\return canonical hash of the cells, never 0.
+     */
+    static std::uint64_t canonicalHash(const std::vector<std::pair<int,int>> &cells);
+
+    /**
+     *\brief Looks up the name of a known object from its canonical hash.
+     *\param hash canonical hash of the object.
+     *\return name of the object, or an empty std::string if it is not known.
+     */
+    static std::string knownName(std::uint64_t hash);
+};
+
+/**
+ *\brief Writes the header of a census CSV file.
+ *\param out std::ostream reference to write to.
+ */
+void writeCensusCsvHeader(std::ostream &out);
+
+/**
+ *\brief Writes one line per kind of object of a census to a CSV file.
+ *\param out std::ostream reference to write to.
+ *\param generation generation the census was taken at.
+ *\param census std::vector of the entries of the census.
+ */
+void writeCensusCsv(std::ostream &out, std::uint64_t generation, const std::vector<CensusEntry> &census);
+
+#endif /* PatternCensus_hpp */
@@ -0,0 +1,423 @@
+#include "PatternIO.hpp"
+#include "Rule.hpp"
+#include <stdexcept> // For std::runtime_error.
+#include <cctype> // For std::isdigit, std::isspace and std::isalpha.
+#include <algorithm> // For std::max and std::min.
+#include <sstream> // For std::istringstream to parse numbers.
+#include <climits> // For INT_MAX.
+
+namespace
+{
+    /// Longest line written to an RLE file, as recommended by the format.
+    constexpr int maxRleLineLength = 70;
+
+    /**
+     *\brief Removes leading and trailing white space from a string.
+     *\param text std::string to trim.
+     *\return std::string holding the trimmed text.
+     */
+    std::string trim(const std::string &text)
+    {
+        std::size_t begin = text.find_first_not_of(" \t\r\n");
+        std::size_t end   = text.find_last_not_of(" \t\r\n");
+        return (begin == std::string::npos) ? std::string() : text.substr(begin, end - begin + 1);
+    }
+
+    /**
+     *\brief Sets a run of cells in a row of a board alive, writing whole words of the packed row.
+     *\param board LifeBoard reference to set the cells on.
+     *\param row row of the run, periodic boundary conditions apply.
+     *\param col column of the first cell of the run, periodic boundary conditions apply.
+     *\param count number of cells in the run, which wraps round to the start of the row.
+     */
+    void setAliveRun(LifeBoard &board, long long row, long long col, long long count)
+    {
+        int rows = board.getRows();
+        int cols = board.getCols();
+        row = (row % rows + rows) % rows;
+        col = (col % cols + cols) % cols;
+        LifeBoard::Word *words = board.rowData(static_cast<int>(row));
+
+        // A run as long as the row covers all of it however often it wraps, so the padding bits are never reached.
+        long long remaining = std::min(count, static_cast<long long>(cols));
+        while(remaining > 0)
+        {
+            int begin = static_cast<int>(col);
+            int end   = static_cast<int>(std::min(col + remaining, static_cast<long long>(cols)));
+            remaining -= end - begin;
+            col = 0;
+
+            int firstWord = begin / LifeBoard::cellsPerWord;
+            int lastWord  = (end - 1) / LifeBoard::cellsPerWord;
+            LifeBoard::Word firstMask = ~LifeBoard::Word(0) << (begin % LifeBoard::cellsPerWord);
+            LifeBoard::Word lastMask  = ~LifeBoard::Word(0) >> (LifeBoard::cellsPerWord - 1 - (end - 1) % LifeBoard::cellsPerWord);
+            if(firstWord == lastWord)
+            {
+                words[firstWord] |= firstMask & lastMask;
+                continue;
+            }
+            words[firstWord] |= firstMask;
+            for(int word = firstWord + 1; word < lastWord; ++word)
+            {
+                words[word] = ~LifeBoard::Word(0);
+            }
+            words[lastWord] |= lastMask;
+        }
+    }
+
+    /**
+     *\brief Finds where a run of cells of the same state ends in a row.
+     *\param board LifeBoard reference to search.
+     *\param row row to search.
+     *\param col column the run starts at.
+     *\param alive state of the cells in the run.
+     *\return Integer value holding the column one past the end of the run.
+     */
+    int findRunEnd(const LifeBoard &board, int row, int col, bool alive)
+    {
+        const LifeBoard::Word *words = board.rowData(row);
+        int wordCount = board.getWordsPerRow();
+        int word = col / LifeBoard::cellsPerWord;
+
+        // Look for the first bit that differs from the run, skipping whole words at a time.
+        LifeBoard::Word differs = (alive ? ~words[word] : words[word]) & (~LifeBoard::Word(0) << (col % LifeBoard::cellsPerWord));
+        while(differs == 0)
+        {
+            if(++word == wordCount)
+            {
+                return board.getCols();
+            }
+            differs = alive ? ~words[word] : words[word];
+        }
+
+        return std::min(board.getCols(), word * LifeBoard::cellsPerWord + __builtin_ctzll(differs));
+    }
+
+    /**
+     * \class RleEncoder
+     * \brief Writes RLE runs to a stream wrapping the lines at the recommended length.
+     */
+    class RleEncoder
+    {
+    private:
+        /// Stream the runs are written to.
+        std::ostream &m_out;
+
+        /// Number of characters on the current line.
+        int m_lineLength;
+
+    public:
+        explicit RleEncoder(std::ostream &out) : m_out(out), m_lineLength{0} {}
+
+        /**
+         *\brief Writes a run.
+         *\param count number of repeats, written as a prefix when more than 1.
+         *\param tag character of the run, 'b' for dead, 'o' for alive, '$' for end of row or '!' for the end.
+         */
+        void write(int count, char tag)
+        {
+            std::string item = (count > 1) ? std::to_string(count) + tag : std::string(1, tag);
+            if(m_lineLength + static_cast<int>(item.size()) > maxRleLineLength)
+            {
+                m_out << '\n';
+                m_lineLength = 0;
+            }
+            m_out << item;
+            m_lineLength += static_cast<int>(item.size());
+        }
+    };
+
+    PatternInfo readRle(std::istream &in, LifeBoard &board, int rowOffset, int colOffset)
+    {
+        PatternInfo info{0, 0, ""};
+
+        // Skip the comment lines and read the header line.
+        std::string line;
+        while(std::getline(in, line))
+        {
+            line = trim(line);
+            if(line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            if(line[0] != 'x')
+            {
+                throw std::runtime_error("RLE pattern is missing its header line.");
+            }
+            break;
+        }
+
+        // The header is a comma separated list of key = value pairs.
+        std::size_t start = 0;
+        while(start < line.size())
+        {
+            std::size_t end = line.find(',', start);
+            std::string item = line.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            std::size_t equals = item.find('=');
+            if(equals != std::string::npos)
+            {
+                std::string key   = trim(item.substr(0, equals));
+                std::string value = trim(item.substr(equals + 1));
+                if(key == "x" || key == "y")
+                {
+                    std::istringstream size(value);
+                    if(!(size >> (key == "x" ? info.width : info.height)))
+                    {
+                        throw std::runtime_error("RLE pattern header has an invalid " + key + " value.");
+                    }
+                }
+                else if(key == "rule")
+                {
+                    info.rule = value;
+                }
+            }
+            start = (end == std::string::npos) ? line.size() : end + 1;
+        }
+
+        // Decode the runs straight into the packed rows of the board. Counts and positions are held
+        // in 64 bits and limited to INT_MAX, so neither a long run of digits nor many long runs overflow.
+        long long row = 0;
+        long long col = 0;
+        long long count = 0;
+        char character;
+        while(in.get(character) && character != '!')
+        {
+            if(std::isdigit(static_cast<unsigned char>(character)))
+            {
+                count = count * 10 + (character - '0');
+                if(count > INT_MAX)
+                {
+                    throw std::runtime_error("RLE pattern has a run count that is too large.");
+                }
+                continue;
+            }
+
+            long long repeats = std::max(count, 1LL);
+            count = 0;
+            if(character == 'b' || character == '.')
+            {
+                col += repeats;
+            }
+            else if(character == '$')
+            {
+                row += repeats;
+                col = 0;
+            }
+            else if(std::isalpha(static_cast<unsigned char>(character)))
+            {
+                setAliveRun(board, rowOffset + row, colOffset + col, repeats);
+                col += repeats;
+            }
+            else if(!std::isspace(static_cast<unsigned char>(character)))
+            {
+                throw std::runtime_error(std::string("Unexpected character '") + character + "' in RLE pattern.");
+            }
+
+            if(row > INT_MAX || col > INT_MAX)
+            {
+                throw std::runtime_error("RLE pattern is too large.");
+            }
+        }
+
+        return info;
+    }
+
+    PatternInfo readLife106(std::istream &in, LifeBoard &board, int rowOffset, int colOffset)
+    {
+        PatternInfo info{0, 0, ""};
+
+        // Every line other than the comments holds the x (column) and y (row) of a live cell.
+        std::string line;
+        while(std::getline(in, line))
+        {
+            line = trim(line);
+            if(line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            int x;
+            int y;
+            std::istringstream coordinates(line);
+            if(!(coordinates >> x >> y))
+            {
+                throw std::runtime_error("Life 1.06 pattern line \"" + line + "\" is not a pair of coordinates.");
+            }
+            board(rowOffset + y, colOffset + x) = LifeBoard::Alive;
+            info.width  = std::max(info.width, x + 1);
+            info.height = std::max(info.height, y + 1);
+        }
+
+        return info;
+    }
+
+    PatternInfo readPlaintext(std::istream &in, LifeBoard &board, int rowOffset, int colOffset)
+    {
+        PatternInfo info{0, 0, ""};
+
+        int row = 0;
+        int col = 0;
+        bool comment = false;
+        bool lineStart = true;
+        char character;
+        while(in.get(character))
+        {
+            if(character == '\n')
+            {
+                row += comment ? 0 : 1;
+                info.height = comment ? info.height : row;
+                col = 0;
+                comment = false;
+                lineStart = true;
+                continue;
+            }
+
+            if(lineStart && character == '!')
+            {
+                comment = true;
+            }
+            lineStart = false;
+            if(comment || character == '\r')
+            {
+                continue;
+            }
+
+            if(character == 'O' || character == '*')
+            {
+                board(rowOffset + row, colOffset + col) = LifeBoard::Alive;
+            }
+            else if(character != '.')
+            {
+                throw std::runtime_error(std::string("Unexpected character '") + character + "' in plaintext pattern.");
+            }
+            info.width = std::max(info.width, ++col);
+        }
+
+        // The last line may not end in a new line.
+        info.height = std::max(info.height, col > 0 ? row + 1 : row);
+
+        return info;
+    }
+
+    void writeRle(std::ostream &out, const LifeBoard &board)
+    {
+        out << "x = " << board.getCols() << ", y = " << board.getRows() << ", rule = " << activeRule().toString() << '\n';
+
+        // Empty rows at the end of a row are merged into the next live run's row break.
+        RleEncoder encoder(out);
+        int pendingRows = 0;
+        for(int row = 0; row < board.getRows(); ++row)
+        {
+            int col = 0;
+            while(col < board.getCols())
+            {
+                int deadEnd = findRunEnd(board, row, col, false);
+                if(deadEnd == board.getCols())
+                {
+                    break;
+                }
+                if(pendingRows > 0)
+                {
+                    encoder.write(pendingRows, '$');
+                    pendingRows = 0;
+                }
+                if(deadEnd > col)
+                {
+                    encoder.write(deadEnd - col, 'b');
+                }
+
+                int aliveEnd = findRunEnd(board, row, deadEnd, true);
+                encoder.write(aliveEnd - deadEnd, 'o');
+                col = aliveEnd;
+            }
+            ++pendingRows;
+        }
+
+        encoder.write(1, '!');
+        out << '\n';
+    }
+
+    void writeLife106(std::ostream &out, const LifeBoard &board)
+    {
+        out << "#Life 1.06\n";
+        for(int row = 0; row < board.getRows(); ++row)
+        {
+            int col = findRunEnd(board, row, 0, false);
+            while(col < board.getCols())
+            {
+                int aliveEnd = findRunEnd(board, row, col, true);
+                for(; col < aliveEnd; ++col)
+                {
+                    out << col << ' ' << row << '\n';
+                }
+                col = (col < board.getCols()) ? findRunEnd(board, row, col, false) : col;
+            }
+        }
+    }
+
+    void writePlaintext(std::ostream &out, const LifeBoard &board)
+    {
+        for(int row = 0; row < board.getRows(); ++row)
+        {
+            // Trailing dead cells are left off each line.
+            int col = 0;
+            while(col < board.getCols())
+            {
+                int deadEnd = findRunEnd(board, row, col, false);
+                if(deadEnd == board.getCols())
+                {
+                    break;
+                }
+                int aliveEnd = findRunEnd(board, row, deadEnd, true);
+                out << std::string(deadEnd - col, '.') << std::string(aliveEnd - deadEnd, 'O');
+                col = aliveEnd;
+            }
+            out << '\n';
+        }
+    }
+}
+
+PatternFormat patternFormatFromFileName(const std::string &fileName)
+{
+    std::size_t dot = fileName.rfind('.');
+    std::string extension = (dot == std::string::npos) ? std::string() : fileName.substr(dot + 1);
+
+    if(extension == "lif" || extension == "life")
+    {
+        return PatternFormat::Life106;
+    }
+    if(extension == "cells")
+    {
+        return PatternFormat::Plaintext;
+    }
+    return PatternFormat::Rle;
+}
+
+PatternInfo readPattern(std::istream &in, PatternFormat format, LifeBoard &board, int rowOffset, int colOffset)
+{
+    switch(format)
+    {
+        case PatternFormat::Life106:
+            return readLife106(in, board, rowOffset, colOffset);
+        case PatternFormat::Plaintext:
+            return readPlaintext(in, board, rowOffset, colOffset);
+        default:
+            return readRle(in, board, rowOffset, colOffset);
+    }
+}
+
+void writePattern(std::ostream &out, PatternFormat format, const LifeBoard &board)
+{
+    switch(format)
+    {
+        case PatternFormat::Life106:
+            writeLife106(out, board);
+            break;
+        case PatternFormat::Plaintext:
+            writePlaintext(out, board);
+            break;
+        default:
+            writeRle(out, board);
+            break;
+    }
+}
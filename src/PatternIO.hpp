@@ -0,0 +1,78 @@
+#ifndef PatternIO_hpp
+#define PatternIO_hpp
+
+#include <iostream> // For the streams patterns are read from and written to.
+#include <string> // For file names and rules.
+#include "LifeBoard.hpp"
+
+/**
+ * \file
+ * \brief Functions to read and write patterns in the standard Life file formats.
+ *
+ * Three formats are supported, run length encoded (.rle), Life 1.06 (.lif or .life) and 
+ * plaintext (.cells). Readers decode the stream character by character straight into the cells of 
+ * a LifeBoard, so loading takes time proportional to the size of the file plus the number of live 
+ * cells and only needs constant extra memory. Writers scan the packed rows for runs of cells so 
+ * large dead regions are skipped a word at a time.
+ */
+
+/**
+ * \enum PatternFormat
+ * \brief Enumeration type to identify the file format of a pattern.
+ */
+enum class PatternFormat
+{
+    Rle,
+    Life106,
+    Plaintext,
+};
+
+/**
+ * \struct PatternInfo
+ * \brief Information about a pattern that was read.
+ */
+struct PatternInfo
+{
+    /// Number of columns the pattern spans, for Life 1.06 this is measured from column 0.
+    int width;
+
+    /// Number of rows the pattern spans, for Life 1.06 this is measured from row 0.
+    int height;
+
+    /// Rule given in the header of an RLE file, empty if there was none.
+    std::string rule;
+};
+
+/**
+ *\brief Works out the format of a pattern file from its extension.
+ *\param fileName std::string holding the name of the file.
+ *\return PatternFormat of the file, RLE if the extension is not recognised.
+ */
+PatternFormat patternFormatFromFileName(const std::string &fileName);
+
+/**
+ *\brief Reads a pattern into a board.
+ *
+ * Live cells of the pattern are set on the board, cells the pattern leaves dead are not touched 
+ * so patterns can be layered. Cell (i,j) of the pattern goes to cell (i + rowOffset, j + colOffset) 
+ * of the board, wrapping round the edges as operator() does.
+ *
+ *\param in std::istream reference to read from.
+ *\param format PatternFormat of the stream.
+ *\param board LifeBoard reference the pattern is placed on.
+ *\param rowOffset row of the board the top of the pattern is placed at.
+ *\param colOffset column of the board the left of the pattern is placed at.
+ *\return PatternInfo describing the pattern.
+ *\throws std::runtime_error if the stream is not a valid pattern of the given format.
+ */
+PatternInfo readPattern(std::istream &in, PatternFormat format, LifeBoard &board, int rowOffset = 0, int colOffset = 0);
+
+/**
+ *\brief Writes the whole of a board as a pattern.
+ *\param out std::ostream reference to write to.
+ *\param format PatternFormat to write in.
+ *\param board LifeBoard reference to write, RLE files record the active rule in their header.
+ */
+void writePattern(std::ostream &out, PatternFormat format, const LifeBoard &board);
+
+#endif /* PatternIO_hpp */
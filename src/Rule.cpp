@@ -0,0 +1,108 @@
+#include "Rule.hpp"
+#include <stdexcept> // For std::invalid_argument.
+#include <cctype> // For std::toupper and std::isdigit.
+
+namespace
+{
+    /// Rule used by update(), shared by every board.
+    Rule& activeRuleStorage()
+    {
+        static Rule rule;
+        return rule;
+    }
+}
+
+Rule::Rule() : 
+Rule(ConwayRule::birth, ConwayRule::survival)
+{}
+
+Rule::Rule(unsigned birth, unsigned survival) :
+m_birth{birth & 0x1FF},
+m_survival{survival & 0x1FF},
+m_table{m_birth | (m_survival << 9)}
+{}
+
+Rule::Rule(const std::string &notation) :
+Rule(0, 0)
+{
+    bool seenBirth = false;
+    bool seenSurvival = false;
+    unsigned *current = nullptr;
+
+    for(char character : notation)
+    {
+        char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(character)));
+        if(upper == 'B' && !seenBirth)
+        {
+            current = &m_birth;
+            seenBirth = true;
+        }
+        else if(upper == 'S' && !seenSurvival)
+        {
+            current = &m_survival;
+            seenSurvival = true;
+        }
+        else if(std::isdigit(static_cast<unsigned char>(upper)) && upper != '9' && current)
+        {
+            *current |= 1u << (upper - '0');
+        }
+        else if(upper != '/')
+        {
+            throw std::invalid_argument("Invalid rule " + notation + ", expected B/S notation such as B3/S23.");
+        }
+    }
+
+    if(!seenBirth || !seenSurvival)
+    {
+        throw std::invalid_argument("Invalid rule " + notation + ", both the B and S parts are required.");
+    }
+    if(m_birth & 1)
+    {
+        throw std::invalid_argument("Rule " + notation + " gives birth with 0 neighbours which is not supported.");
+    }
+
+    m_table = m_birth | (m_survival << 9);
+}
+
+unsigned Rule::getBirthMask() const
+{
+    return m_birth;
+}
+
+unsigned Rule::getSurvivalMask() const
+{
+    return m_survival;
+}
+
+std::string Rule::toString() const
+{
+    std::string notation = "B";
+    for(int count = 0; count <= 8; ++count)
+    {
+        if(m_birth & (1u << count))
+        {
+            notation += static_cast<char>('0' + count);
+        }
+    }
+
+    notation += "/S";
+    for(int count = 0; count <= 8; ++count)
+    {
+        if(m_survival & (1u << count))
+        {
+            notation += static_cast<char>('0' + count);
+        }
+    }
+
+    return notation;
+}
+
+const Rule& activeRule()
+{
+    return activeRuleStorage();
+}
+
+void setActiveRule(const Rule &rule)
+{
+    activeRuleStorage() = rule;
+}
@@ -0,0 +1,149 @@
+#ifndef Rule_hpp
+#define Rule_hpp
+
+#include <string> // For the rule notation.
+
+/**
+ * \file
+ * \brief Classes to model Life-like cellular automaton rules in B/S notation.
+ *
+ * A Life-like rule is defined by the neighbour counts at which a dead cell is born and the counts 
+ * at which a live cell survives, for example Conway's rules are B3/S23. Both sets are stored as 
+ * 9 bit masks, bit n being set if a count of n is in the set, so the masks double as a 
+ * branchless lookup table keyed on the state and the neighbour count.
+ */
+
+/**
+ * \struct StaticRule
+ * \brief A rule fixed at compile time so kernels can be specialised for it.
+ * \tparam Birth mask of the neighbour counts at which a dead cell is born.
+ * \tparam Survival mask of the neighbour counts at which a live cell survives.
+ */
+template<unsigned Birth, unsigned Survival>
+struct StaticRule
+{
+    /// Mask of the neighbour counts at which a dead cell is born.
+    static constexpr unsigned birth = Birth;
+
+    /// Mask of the neighbour counts at which a live cell survives.
+    static constexpr unsigned survival = Survival;
+
+    /**
+     *\brief Looks up whether a cell is alive in the next generation.
+     *\param alive whether the cell is currently alive.
+     *\param liveNeighbours number of live cells in the Moore neighbourhood.
+     *\return boolean value representing whether the cell will be alive.
+     */
+    static constexpr bool isBorn(bool alive, int liveNeighbours)
+    {
+        return (((alive ? Survival : Birth) >> liveNeighbours) & 1) != 0;
+    }
+};
+
+/// Conway's Game of Life, B3/S23.
+typedef StaticRule<0x008, 0x00C> ConwayRule;
+
+/// HighLife, B36/S23.
+typedef StaticRule<0x048, 0x00C> HighLifeRule;
+
+/// Day & Night, B3678/S34678.
+typedef StaticRule<0x1C8, 0x1D8> DayAndNightRule;
+
+/// Seeds, B2/S.
+typedef StaticRule<0x004, 0x000> SeedsRule;
+
+/**
+ * \class Rule
+ * \brief A rule chosen at runtime, typically parsed from the command line.
+ */
+class Rule
+{
+private:
+    /// Member variable that holds the mask of the neighbour counts at which a dead cell is born.
+    unsigned m_birth;
+
+    /// Member variable that holds the mask of the neighbour counts at which a live cell survives.
+    unsigned m_survival;
+
+    /// Member variable that holds the birth mask in bits 0-8 and the survival mask in bits 9-17.
+    unsigned m_table;
+
+public:
+    /**
+     *\brief Constructor that creates Conway's rule.
+     */
+    Rule();
+
+    /**
+     *\brief Constructor that creates a rule from its masks.
+     *\param birth mask of the neighbour counts at which a dead cell is born.
+     *\param survival mask of the neighbour counts at which a live cell survives.
+     */
+    Rule(unsigned birth, unsigned survival);
+
+    /**
+     *\brief Constructor that parses a rule in B/S notation such as "B36/S23".
+     *
+     * The letters are case insensitive and the two halves may come in either order. Rules that 
+     * give birth with 0 neighbours are rejected since they would fill the infinite dead regions 
+     * that the engines rely on staying dead.
+     *
+     *\param notation std::string holding the rule.
+     *\throws std::invalid_argument if the notation is not a valid rule.
+     */
+    explicit Rule(const std::string &notation);
+
+    /**
+     *\brief Getter for the birth mask.
+     *\return Mask with bit n set if a dead cell with n live neighbours is born.
+     */
+    unsigned getBirthMask() const;
+
+    /**
+     *\brief Getter for the survival mask.
+     *\return Mask with bit n set if a live cell with n live neighbours survives.
+     */
+    unsigned getSurvivalMask() const;
+
+    /**
+     *\brief Looks up whether a cell is alive in the next generation.
+     *\param alive whether the cell is currently alive.
+     *\param liveNeighbours number of live cells in the Moore neighbourhood.
+     *\return boolean value representing whether the cell will be alive.
+     */
+    bool isBorn(bool alive, int liveNeighbours) const
+    {
+        return ((m_table >> (liveNeighbours + (alive ? 9 : 0))) & 1) != 0;
+    }
+
+    /**
+     *\brief Checks whether this rule is the same as a compile-time rule.
+     *\tparam StaticRuleType StaticRule instantiation to compare with.
+     *\return boolean value representing the result of the query.
+     */
+    template<class StaticRuleType>
+    bool is() const
+    {
+        return m_birth == StaticRuleType::birth && m_survival == StaticRuleType::survival;
+    }
+
+    /**
+     *\brief Formats the rule in B/S notation.
+     *\return std::string holding the rule such as "B3/S23".
+     */
+    std::string toString() const;
+};
+
+/**
+ *\brief Gets the rule used by update() and LifeBoard::nextState(), Conway's rule unless overridden.
+ *\return constant reference to the active rule.
+ */
+const Rule& activeRule();
+
+/**
+ *\brief Overrides the rule used by update() and LifeBoard::nextState().
+ *\param rule Rule to use.
+ */
+void setActiveRule(const Rule &rule);
+
+#endif /* Rule_hpp */
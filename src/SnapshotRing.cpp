@@ -0,0 +1,123 @@
+#include "SnapshotRing.hpp"
+#include <chrono> // For bounding how long consumers sleep.
+#include <utility> // For std::swap.
+
+namespace
+{
+    /// Longest a consumer sleeps before checking for a snapshot again, covers wake ups missed since the producer never locks.
+    constexpr std::chrono::milliseconds consumerPollInterval(10);
+}
+
+SnapshotRing::Snapshot::Snapshot(SnapshotRing *ring, int slot) :
+m_ring{ring},
+m_slot{slot}
+{}
+
+SnapshotRing::Snapshot::Snapshot(Snapshot &&other) :
+m_ring{other.m_ring},
+m_slot{other.m_slot}
+{
+    other.m_ring = nullptr;
+}
+
+SnapshotRing::Snapshot& SnapshotRing::Snapshot::operator=(Snapshot &&other)
+{
+    std::swap(m_ring, other.m_ring);
+    std::swap(m_slot, other.m_slot);
+    return *this;
+}
+
+SnapshotRing::Snapshot::~Snapshot()
+{
+    if(m_ring)
+    {
+        m_ring->m_readers[m_slot].fetch_sub(1);
+    }
+}
+
+SnapshotRing::Snapshot::operator bool() const
+{
+    return m_ring != nullptr;
+}
+
+const LifeBoard& SnapshotRing::Snapshot::board() const
+{
+    return m_ring->m_boards[m_slot];
+}
+
+std::uint64_t SnapshotRing::Snapshot::generation() const
+{
+    return m_ring->m_generations[m_slot];
+}
+
+SnapshotRing::SnapshotRing(int consumerCount, const LifeBoard &board) :
+m_boards(consumerCount + 2, board),
+m_generations(consumerCount + 2, 0),
+m_readers(new std::atomic<int>[consumerCount + 2]),
+m_latest{-1},
+m_closed{false}
+{
+    for(int slot = 0; slot < consumerCount + 2; ++slot)
+    {
+        m_readers[slot] = 0;
+    }
+}
+
+void SnapshotRing::publish(const LifeBoard &board, std::uint64_t generation)
+{
+    // Any slot other than the newest with no readers is free, one always exists.
+    int latest = m_latest.load();
+    int slot = 0;
+    while(slot == latest || m_readers[slot].load() != 0)
+    {
+        slot = (slot + 1) % static_cast<int>(m_boards.size());
+    }
+
+    m_boards[slot] = board;
+    m_generations[slot] = generation;
+    m_latest.store(slot);
+    m_published.notify_all();
+}
+
+SnapshotRing::Snapshot SnapshotRing::acquire(std::uint64_t after, bool first)
+{
+    while(true)
+    {
+        // Read the flag first so a snapshot published just before the ring was closed is not missed.
+        bool closed = m_closed.load();
+
+        int slot = m_latest.load();
+        if(slot >= 0)
+        {
+            // Register as a reader then make sure the producer has not moved on, if it has it may 
+            // already be overwriting the slot so try again.
+            m_readers[slot].fetch_add(1);
+            if(m_latest.load() == slot)
+            {
+                if(first || m_generations[slot] > after)
+                {
+                    return Snapshot(this, slot);
+                }
+            }
+            m_readers[slot].fetch_sub(1);
+            if(m_latest.load() != slot)
+            {
+                continue;
+            }
+        }
+
+        // Nothing new so sleep until the producer publishes or gives up.
+        if(closed)
+        {
+            return Snapshot(nullptr, 0);
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_published.wait_for(lock, consumerPollInterval);
+    }
+}
+
+void SnapshotRing::close()
+{
+    m_closed.store(true);
+    m_published.notify_all();
+}
@@ -0,0 +1,135 @@
+#ifndef SnapshotRing_hpp
+#define SnapshotRing_hpp
+
+#include <vector> // For holding the snapshot boards.
+#include <atomic> // For the lock free slot hand over.
+#include <memory> // For std::unique_ptr.
+#include <mutex> // For sleeping consumers.
+#include <condition_variable> // For waking sleeping consumers.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+
+/**
+ * \file
+ * \brief Class to model a bounded ring that hands generations from the simulation to consumers.
+ *
+ * The stepping thread publishes a copy of each generation into one of a fixed set of slots and 
+ * consumer threads, such as the renderer or the analysis, take the newest snapshot whenever they 
+ * are ready. Publishing never waits: there is one slot per consumer plus two, so there is always 
+ * a slot that is neither the newest snapshot nor being read and the producer overwrites it. A 
+ * consumer that falls behind therefore simply skips the generations it missed instead of holding 
+ * up the simulation.
+ *
+ * Slots are handed over without locks, each slot counts its readers and a consumer only keeps a 
+ * slot if it is still the newest one after registering as a reader, while the producer only 
+ * reuses slots with no readers. The mutex is only used to let idle consumers sleep.
+ */
+class SnapshotRing
+{
+private:
+    /// Member variable that holds the board of each slot.
+    std::vector<LifeBoard> m_boards;
+
+    /// Member variable that holds the generation of the board in each slot.
+    std::vector<std::uint64_t> m_generations;
+
+    /// Member variable that holds the number of consumers reading each slot.
+    std::unique_ptr<std::atomic<int>[]> m_readers;
+
+    /// Member variable that holds the slot of the newest snapshot, -1 before the first is published.
+    std::atomic<int> m_latest;
+
+    /// Member variable that tells consumers no more snapshots will be published.
+    std::atomic<bool> m_closed;
+
+    /// Member variable used with m_published to let idle consumers sleep.
+    std::mutex m_mutex;
+
+    /// Member variable used to wake consumers when a snapshot is published.
+    std::condition_variable m_published;
+
+public:
+    /**
+     * \class Snapshot
+     * \brief Read only view of a published generation that holds on to its slot until destroyed.
+     */
+    class Snapshot
+    {
+    private:
+        /// Member variable that holds the ring the snapshot belongs to, nullptr if empty.
+        SnapshotRing *m_ring;
+
+        /// Member variable that holds the slot being read.
+        int m_slot;
+
+    public:
+        /**
+         *\brief Constructor that takes ownership of a reader registration on a slot.
+         *\param ring SnapshotRing pointer the slot belongs to, nullptr for an empty snapshot.
+         *\param slot index of the slot.
+         */
+        Snapshot(SnapshotRing *ring, int slot);
+
+        Snapshot(Snapshot &&other);
+        Snapshot& operator=(Snapshot &&other);
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        /**
+         *\brief Destructor that releases the slot back to the producer.
+         */
+        ~Snapshot();
+
+        /**
+         *\brief Checks whether the snapshot holds a generation.
+         *\return false if the ring was closed before a new generation was published.
+         */
+        explicit operator bool() const;
+
+        /**
+         *\brief Getter for the board of the snapshot.
+         *\return constant reference to the board.
+         */
+        const LifeBoard& board() const;
+
+        /**
+         *\brief Getter for the generation of the snapshot.
+         *\return generation of the board.
+         */
+        std::uint64_t generation() const;
+    };
+
+    /**
+     *\brief Constructor that allocates the slots.
+     *\param consumerCount number of consumer threads that will read from the ring.
+     *\param board LifeBoard reference used to size the slots so publishing does not allocate.
+     */
+    SnapshotRing(int consumerCount, const LifeBoard &board);
+
+    /**
+     *\brief Publishes a generation without ever waiting for consumers.
+     *
+     * Must only be called from a single producer thread.
+     *
+     *\param board LifeBoard reference that is copied into a free slot.
+     *\param generation generation of the board.
+     */
+    void publish(const LifeBoard &board, std::uint64_t generation);
+
+    /**
+     *\brief Takes the newest snapshot, waiting until one newer than a given generation is published.
+     *\param after generation the consumer last saw, any newer snapshot is returned.
+     *\param first true if the consumer has not seen any snapshot yet, so any snapshot is returned.
+     *\return Snapshot of the newest generation, empty if the ring was closed first.
+     */
+    Snapshot acquire(std::uint64_t after, bool first = false);
+
+    /**
+     *\brief Tells consumers that no more generations will be published and wakes them.
+     *
+     * Consumers still receive the newest snapshot if they have not seen it yet.
+     */
+    void close();
+};
+
+#endif /* SnapshotRing_hpp */
@@ -0,0 +1,187 @@
+#include "SparseLife.hpp"
+#include "Metrics.hpp"
+#include <algorithm> // For std::sort, std::fill and std::binary_search.
+
+constexpr std::uint8_t SparseLife::aliveFlag;
+
+SparseLife::CellKey SparseLife::makeKey(std::int32_t row, std::int32_t col)
+{
+    // Flipping the sign bits makes the unsigned order of the halves match the signed order.
+    return (static_cast<CellKey>(static_cast<std::uint32_t>(row) ^ 0x80000000u) << 32) | (static_cast<std::uint32_t>(col) ^ 0x80000000u);
+}
+
+std::int32_t SparseLife::rowOf(CellKey key)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32) ^ 0x80000000u);
+}
+
+std::int32_t SparseLife::colOf(CellKey key)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(key) ^ 0x80000000u);
+}
+
+SparseLife::SparseLife() :
+m_generation{0},
+m_rule(activeRule())
+{}
+
+SparseLife::SparseLife(const LifeBoard &board) :
+SparseLife()
+{
+    setBoard(board);
+}
+
+void SparseLife::setBoard(const LifeBoard &board)
+{
+    m_rule = activeRule();
+    m_generation = 0;
+    m_cells.clear();
+
+    // Rows are scanned in order and each row a word at a time, so the keys come out sorted.
+    int words = board.getWordsPerRow();
+    for(int row = 0; row < board.getRows(); ++row)
+    {
+        const LifeBoard::Word *data = board.rowData(row);
+        for(int word = 0; word < words; ++word)
+        {
+            for(LifeBoard::Word bits = data[word]; bits != 0; bits &= bits - 1)
+            {
+                m_cells.push_back(makeKey(row, word * LifeBoard::cellsPerWord + __builtin_ctzll(bits)));
+            }
+        }
+    }
+}
+
+void SparseLife::copyToBoard(LifeBoard &board) const
+{
+    board.clear();
+
+    // Only the rows of the window need looking at since the keys are sorted by row.
+    std::vector<CellKey>::const_iterator cell = std::lower_bound(m_cells.begin(), m_cells.end(), makeKey(0, INT32_MIN));
+    std::vector<CellKey>::const_iterator end  = std::lower_bound(m_cells.begin(), m_cells.end(), makeKey(board.getRows(), INT32_MIN));
+    for(; cell != end; ++cell)
+    {
+        std::int32_t col = colOf(*cell);
+        if(col >= 0 && col < board.getCols())
+        {
+            board(rowOf(*cell), col) = LifeBoard::Alive;
+        }
+    }
+}
+
+SparseLife::Slot& SparseLife::slotOf(CellKey key)
+{
+    // Finaliser of SplitMix64 to spread neighbouring cells over the table.
+    std::uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+    hash ^= hash >> 31;
+
+    std::size_t mask = m_table.size() - 1;
+    for(std::size_t index = hash & mask; ; index = (index + 1) & mask)
+    {
+        Slot &slot = m_table[index];
+        if(slot.state == 0)
+        {
+            slot.key = key;
+            return slot;
+        }
+        if(slot.key == key)
+        {
+            return slot;
+        }
+    }
+}
+
+void SparseLife::step()
+{
+    // At most nine cells per live cell go in the table, keep it at most half full.
+    std::size_t capacity = 16;
+    while(capacity < 18 * m_cells.size())
+    {
+        capacity *= 2;
+    }
+    if(m_table.size() != capacity)
+    {
+        m_table.assign(capacity, Slot{0, 0});
+    }
+    else
+    {
+        std::fill(m_table.begin(), m_table.end(), Slot{0, 0});
+    }
+
+    for(CellKey cell : m_cells)
+    {
+        std::int32_t row = rowOf(cell);
+        std::int32_t col = colOf(cell);
+        slotOf(cell).state |= aliveFlag;
+        for(int i = -1; i <= 1; ++i)
+        {
+            for(int j = -1; j <= 1; ++j)
+            {
+                if(i != 0 || j != 0)
+                {
+                    ++slotOf(makeKey(row + i, col + j)).state;
+                }
+            }
+        }
+    }
+
+    // Every cell that can be alive next generation is in the table, including live cells with
+    // no neighbours since they were marked alive.
+    m_nextCells.clear();
+    std::size_t evaluated = 0;
+    for(const Slot &slot : m_table)
+    {
+        if(slot.state == 0)
+        {
+            continue;
+        }
+        ++evaluated;
+        if(m_rule.isBorn((slot.state & aliveFlag) != 0, slot.state & (aliveFlag - 1)))
+        {
+            m_nextCells.push_back(slot.key);
+        }
+    }
+    METRICS_COUNT(Counter::CellsEvaluated, evaluated);
+    std::sort(m_nextCells.begin(), m_nextCells.end());
+    std::swap(m_cells, m_nextCells);
+    ++m_generation;
+}
+
+void SparseLife::advance(std::uint64_t generations)
+{
+    for(std::uint64_t generation = 0; generation < generations; ++generation)
+    {
+        step();
+    }
+}
+
+bool SparseLife::isAlive(std::int32_t row, std::int32_t col) const
+{
+    return std::binary_search(m_cells.begin(), m_cells.end(), makeKey(row, col));
+}
+
+long long SparseLife::getPopulation() const
+{
+    return static_cast<long long>(m_cells.size());
+}
+
+std::pair<double,double> SparseLife::centreOfMass() const
+{
+    double rowSum = 0;
+    double colSum = 0;
+    for(CellKey cell : m_cells)
+    {
+        rowSum += rowOf(cell);
+        colSum += colOf(cell);
+    }
+
+    double population = static_cast<double>(m_cells.size());
+    return std::pair<double,double>(rowSum / population, colSum / population);
+}
+
+std::uint64_t SparseLife::getGeneration() const
+{
+    return m_generation;
+}
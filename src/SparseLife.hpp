@@ -0,0 +1,152 @@
+#ifndef SparseLife_hpp
+#define SparseLife_hpp
+
+#include <vector> // For holding the live cells and the neighbour table.
+#include <utility> // For std::pair.
+#include <cstdint> // For fixed width integers.
+#include "LifeBoard.hpp"
+#include "Rule.hpp"
+
+/**
+ * \file
+ * \brief Class to model an unbounded GOL universe that only stores its live cells.
+ *
+ * The live cells are kept as a sorted list of packed coordinates, so memory is proportional to
+ * the population however far apart the cells are. Each generation every live cell adds one to
+ * the neighbour count of the eight cells around it in an open addressed hash table. Only cells
+ * in that table can be alive in the next generation, so the cost of a step is proportional to
+ * the population rather than to the area the pattern covers.
+ *
+ * Like HashLife the universe is an infinite plane, coordinates are 32-bit so a pattern can
+ * travel about two billion cells in each direction.
+ */
+class SparseLife
+{
+public:
+    /// Type of the packed coordinates of a cell, the row in the high half and the column in the low half.
+    typedef std::uint64_t CellKey;
+
+private:
+    /**
+     * \struct Slot
+     * \brief Entry of the neighbour table.
+     */
+    struct Slot
+    {
+        /// Coordinates of the cell.
+        CellKey key;
+
+        /// Number of live neighbours in the low 4 bits, aliveFlag if the cell is alive, 0 if the slot is empty.
+        std::uint8_t state;
+    };
+
+    /// Bit of Slot::state set for cells that are alive.
+    static constexpr std::uint8_t aliveFlag = 16;
+
+    /// Member variable that holds the live cells sorted by row and then column.
+    std::vector<CellKey> m_cells;
+
+    /// Member variable that holds the neighbour table, its size is a power of 2.
+    std::vector<Slot> m_table;
+
+    /// Member variable that holds the list the next generation is built in.
+    std::vector<CellKey> m_nextCells;
+
+    /// Member variable that holds the number of generations that have been computed.
+    std::uint64_t m_generation;
+
+    /// Member variable that holds the rule the universe evolves under.
+    Rule m_rule;
+
+    /**
+     *\brief Finds the slot of a cell in the neighbour table, claiming an empty one if it is not there.
+     *\param key CellKey of the cell.
+     *\return reference to the Slot of the cell.
+     */
+    Slot& slotOf(CellKey key);
+
+public:
+    /**
+     *\brief Packs the coordinates of a cell, keys sort in the same order as rows and then columns.
+     *\param row row of the cell.
+     *\param col column of the cell.
+     *\return CellKey of the cell.
+     */
+    static CellKey makeKey(std::int32_t row, std::int32_t col);
+
+    /**
+     *\brief Unpacks the row of a cell.
+     *\param key CellKey of the cell.
+     *\return row of the cell.
+     */
+    static std::int32_t rowOf(CellKey key);
+
+    /**
+     *\brief Unpacks the column of a cell.
+     *\param key CellKey of the cell.
+     *\return column of the cell.
+     */
+    static std::int32_t colOf(CellKey key);
+
+    /**
+     *\brief Constructor that creates an empty universe evolving under the active rule.
+     */
+    SparseLife();
+
+    /**
+     *\brief Constructor that creates a universe holding the live cells of a board evolving under the active rule.
+     *\param board LifeBoard to copy, cell (i,j) of the board becomes cell (i,j) of the universe.
+     */
+    explicit SparseLife(const LifeBoard &board);
+
+    /**
+     *\brief Replaces the universe with the live cells of a board and resets the generation.
+     *\param board LifeBoard to copy, cell (i,j) of the board becomes cell (i,j) of the universe.
+     */
+    void setBoard(const LifeBoard &board);
+
+    /**
+     *\brief Copies the cells of the universe in the window covered by a board into the board.
+     *\param board LifeBoard to write to, cell (i,j) of the board is set to cell (i,j) of the universe.
+     */
+    void copyToBoard(LifeBoard &board) const;
+
+    /**
+     *\brief Advances the universe by one generation.
+     */
+    void step();
+
+    /**
+     *\brief Advances the universe by a number of generations.
+     *\param generations number of generations to advance by.
+     */
+    void advance(std::uint64_t generations);
+
+    /**
+     *\brief Calculates whether given cell is alive or dead.
+     *\param row row of cell in question.
+     *\param col column of cell in question.
+     *\return boolean value representing result of query.
+     */
+    bool isAlive(std::int32_t row, std::int32_t col) const;
+
+    /**
+     *\brief Getter for the number of live cells.
+     *\return Integer value representing the population.
+     */
+    long long getPopulation() const;
+
+    /**
+     *\brief Calculates the centre of mass of the live cells.
+     *\return pair of doubles representing the row and column of the centre of mass, NaN if there are no live cells.
+     */
+    std::pair<double,double> centreOfMass() const;
+
+    /**
+     *\brief Getter for the number of generations computed since the universe was set.
+     *\return Integer value representing the generation.
+     */
+    std::uint64_t getGeneration() const;
+};
+
+#endif /* SparseLife_hpp */
@@ -0,0 +1,108 @@
+#include "TemporalStepper.hpp"
+#include "EvolveKernels.hpp"
+#include "ThreadPool.hpp"
+#include "Metrics.hpp"
+#include <algorithm> // For std::max, std::min and std::swap.
+
+TemporalStepper::TemporalStepper(std::size_t cacheBytes) :
+m_cacheBytes{cacheBytes}
+{}
+
+int TemporalStepper::bandRows(const LifeBoard &board, int generations) const
+{
+    // Each buffer holds the band and a halo of one row per generation on either side, a band
+    // at least as tall as the halo keeps the extra rows read to at most three times the band.
+    std::size_t rowBytes = static_cast<std::size_t>(board.getWordsPerRow()) * sizeof(LifeBoard::Word);
+    int fit = static_cast<int>(std::min<std::size_t>(m_cacheBytes / rowBytes, board.getRows() + 2 * generations)) - 2 * generations;
+    return std::min(board.getRows(), std::max(fit, generations));
+}
+
+void TemporalStepper::evolveBand(LifeBoard &updatedBoard, const LifeBoard &currentBoard, int firstRow, int rows, int generations, int buffers)
+{
+    int maxRows = currentBoard.getRows();
+    int maxCols = currentBoard.getCols();
+    int words   = currentBoard.getWordsPerRow();
+    LifeBoard::Word lastMask = currentBoard.lastWordMask();
+    RowKernel evolveRow = getRowKernel(activeKernel());
+
+    // Row i of the buffers is row firstRow - generations + i of the board.
+    int height = rows + 2 * generations;
+    std::vector<LifeBoard::Word> &previous = m_buffers[2 * buffers];
+    std::vector<LifeBoard::Word> &next     = m_buffers[2 * buffers + 1];
+    previous.resize(static_cast<std::size_t>(height) * words);
+    next.resize(previous.size());
+
+    const LifeBoard::Word *board = currentBoard.rowData(0);
+    LifeBoard::Word *updated = updatedBoard.rowData(0);
+    LifeBoard::Word *in  = previous.data();
+    LifeBoard::Word *out = next.data();
+
+    // The first generation reads straight from the board and the last writes straight to the
+    // updated board, so the band is only copied between the buffers in between.
+    for(int generation = 1; generation <= generations; ++generation)
+    {
+        for(int i = generation; i < height - generation; ++i)
+        {
+            const LifeBoard::Word *above;
+            const LifeBoard::Word *row;
+            const LifeBoard::Word *below;
+            if(generation == 1)
+            {
+                int boardRow = ((firstRow - generations + i) % maxRows + maxRows) % maxRows;
+                above = board + static_cast<std::size_t>((boardRow + maxRows - 1) % maxRows) * words;
+                row   = board + static_cast<std::size_t>(boardRow) * words;
+                below = board + static_cast<std::size_t>((boardRow + 1) % maxRows) * words;
+            }
+            else
+            {
+                row   = in + static_cast<std::size_t>(i) * words;
+                above = row - words;
+                below = row + words;
+            }
+
+            LifeBoard::Word *destination = (generation == generations) ? updated + static_cast<std::size_t>(firstRow - generations + i) * words
+                                                                       : out + static_cast<std::size_t>(i) * words;
+            evolveRow(above, row, below, destination, words, maxCols, lastMask, 0, words);
+        }
+        std::swap(in, out);
+    }
+}
+
+void TemporalStepper::step(LifeBoard &updatedBoard, const LifeBoard &currentBoard, int generations)
+{
+    int band = bandRows(currentBoard, generations);
+    m_buffers.resize(std::max<std::size_t>(m_buffers.size(), 2));
+
+    updatedBoard.setStatisticsTracking(currentBoard.isTrackingStatistics());
+    updatedBoard.setHashTracking(currentBoard.isTrackingHash());
+    updatedBoard.invalidateStatistics();
+    METRICS_COUNT(Counter::CellsEvaluated, static_cast<std::uint64_t>(currentBoard.getRows()) * currentBoard.getCols() * generations);
+
+    for(int firstRow = 0; firstRow < currentBoard.getRows(); firstRow += band)
+    {
+        evolveBand(updatedBoard, currentBoard, firstRow, std::min(band, currentBoard.getRows() - firstRow), generations, 0);
+    }
+}
+
+void TemporalStepper::step(LifeBoard &updatedBoard, const LifeBoard &currentBoard, int generations, ThreadPool &pool)
+{
+    int band  = bandRows(currentBoard, generations);
+    int bands = (currentBoard.getRows() + band - 1) / band;
+    int workers = pool.getThreadCount();
+    m_buffers.resize(std::max<std::size_t>(m_buffers.size(), 2 * static_cast<std::size_t>(workers)));
+
+    updatedBoard.setStatisticsTracking(currentBoard.isTrackingStatistics());
+    updatedBoard.setHashTracking(currentBoard.isTrackingHash());
+    updatedBoard.invalidateStatistics();
+    METRICS_COUNT(Counter::CellsEvaluated, static_cast<std::uint64_t>(currentBoard.getRows()) * currentBoard.getCols() * generations);
+
+    // Deal the bands out in turn so every worker gets a similar number.
+    pool.run([&](int worker)
+    {
+        for(int index = worker; index < bands; index += workers)
+        {
+            int firstRow = index * band;
+            evolveBand(updatedBoard, currentBoard, firstRow, std::min(band, currentBoard.getRows() - firstRow), generations, worker);
+        }
+    });
+}
@@ -0,0 +1,79 @@
+#ifndef TemporalStepper_hpp
+#define TemporalStepper_hpp
+
+#include <vector> // For the band buffers.
+#include <cstddef> // For std::size_t.
+#include "LifeBoard.hpp"
+
+class ThreadPool;
+
+/**
+ * \file
+ * \brief Class to model a stepper that advances several generations per pass over the board.
+ *
+ * update() reads and writes the whole board every generation, so once the board is much larger
+ * than the cache its speed is set by memory bandwidth. This stepper splits the board into bands
+ * of whole rows, and copies each band plus a halo of k rows on either side into a buffer small
+ * enough to stay in cache. The buffer is evolved k generations, with the rows still valid
+ * shrinking by one at each end every generation, and only the rows of the band are written back.
+ * The board is therefore streamed from memory about once per k generations instead of k times.
+ *
+ * The rows wrap round the board as in LifeBoard::operator() and the kernels wrap round the
+ * columns, so the result is exactly that of k calls to update() with periodic boundary conditions.
+ */
+class TemporalStepper
+{
+private:
+    /// Member variable that holds the number of bytes each band buffer is kept under where possible.
+    std::size_t m_cacheBytes;
+
+    /// Member variable that holds the two buffers of each worker, evolved into one another alternately.
+    std::vector<std::vector<LifeBoard::Word>> m_buffers;
+
+    /**
+     *\brief Evolves one band of rows by several generations.
+     *\param updatedBoard LifeBoard object the band is written to.
+     *\param currentBoard LifeBoard object the band and its halo are read from.
+     *\param firstRow first row of the band.
+     *\param rows number of rows in the band.
+     *\param generations number of generations to advance.
+     *\param buffers index of the pair of buffers to work in.
+     */
+    void evolveBand(LifeBoard &updatedBoard, const LifeBoard &currentBoard, int firstRow, int rows, int generations, int buffers);
+
+    /**
+     *\brief Works out how many rows each band should hold.
+     *\param board LifeBoard object being stepped.
+     *\param generations number of generations to advance.
+     *\return Integer value representing the number of rows per band.
+     */
+    int bandRows(const LifeBoard &board, int generations) const;
+
+public:
+    /**
+     *\brief Constructor that sets up the stepper.
+     *\param cacheBytes size in bytes each band buffer, halo included, is kept under where possible.
+     */
+    explicit TemporalStepper(std::size_t cacheBytes = std::size_t(1) << 18);
+
+    /**
+     *\brief Advances the board several generations with periodic boundary conditions.
+     *\param updatedBoard LifeBoard object that will hold the board generations after currentBoard,
+     * it must have the same dimensions.
+     *\param currentBoard LifeBoard object that is the board the update is based on.
+     *\param generations number of generations to advance, at least 1.
+     */
+    void step(LifeBoard &updatedBoard, const LifeBoard &currentBoard, int generations);
+
+    /**
+     *\brief Advances the board several generations with periodic boundary conditions using a pool of threads.
+     *\param updatedBoard LifeBoard object that will hold the board generations after currentBoard,
+     * it must have the same dimensions.
+     *\param currentBoard LifeBoard object that is the board the update is based on.
+     *\param generations number of generations to advance, at least 1.
+     *\param pool ThreadPool reference, the bands are shared out between the workers.
+     */
+    void step(LifeBoard &updatedBoard, const LifeBoard &currentBoard, int generations, ThreadPool &pool);
+};
+
+#endif /* TemporalStepper_hpp */
@@ -0,0 +1,87 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(int threadCount) :
+m_invoke{nullptr},
+m_task{nullptr},
+m_taskNumber{0},
+m_running{0},
+m_stopping{false}
+{
+    // The calling thread is worker 0 so only threadCount-1 threads need to be created.
+    for(int worker = 1; worker < threadCount; ++worker)
+    {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskStarted.notify_all();
+
+    for(auto &thread : m_workers)
+    {
+        thread.join();
+    }
+}
+
+int ThreadPool::getThreadCount() const
+{
+    return static_cast<int>(m_workers.size()) + 1;
+}
+
+void ThreadPool::workerLoop(int worker)
+{
+    unsigned long lastTask = 0;
+
+    while(true)
+    {
+        // Sleep until there is a new task or the pool is being destroyed.
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskStarted.wait(lock, [&]{ return m_stopping || m_taskNumber != lastTask; });
+            if(m_stopping)
+            {
+                return;
+            }
+            lastTask = m_taskNumber;
+        }
+
+        m_invoke(m_task, worker);
+
+        // Let the caller of run() know once the last worker is done.
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(--m_running == 0)
+        {
+            m_taskFinished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runTask(void (*invoke)(const void *task, int worker), const void *task)
+{
+    // With no extra workers there is nothing to synchronise.
+    if(m_workers.empty())
+    {
+        invoke(task, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_invoke  = invoke;
+        m_task    = task;
+        m_running = static_cast<int>(m_workers.size());
+        ++m_taskNumber;
+    }
+    m_taskStarted.notify_all();
+
+    invoke(task, 0);
+
+    // Wait for the other workers, this is the barrier between successive tasks.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_taskFinished.wait(lock, [&]{ return m_running == 0; });
+}
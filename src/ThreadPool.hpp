@@ -0,0 +1,111 @@
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <vector> // For holding the worker threads.
+#include <thread> // For the worker threads.
+#include <mutex> // For protecting the shared state.
+#include <condition_variable> // For waking and waiting on workers.
+
+/**
+ * \file
+ * \brief Class to model a persistent pool of worker threads that run a task in lock step.
+ *
+ * The threads are created once when the pool is constructed and then sleep between tasks, so 
+ * running a task every generation does not pay for thread creation. The calling thread takes 
+ * part as worker 0 and run() only returns when every worker has finished, which acts as the 
+ * barrier between generations. Tasks are passed to the workers by address rather than copied into
+ * a std::function, so running one never allocates.
+ */
+class ThreadPool
+{
+private:
+    /// Member variable that holds the threads for workers 1 to threadCount-1.
+    std::vector<std::thread> m_workers;
+
+    /// Member variable that holds the function that calls the task currently being run.
+    void (*m_invoke)(const void *task, int worker);
+
+    /// Member variable that holds the address of the task currently being run.
+    const void *m_task;
+
+    /// Member variable that counts the tasks started so workers can tell when a new one arrives.
+    unsigned long m_taskNumber;
+
+    /// Member variable that holds the number of workers still running the current task.
+    int m_running;
+
+    /// Member variable that tells the workers to exit.
+    bool m_stopping;
+
+    /// Member variable that protects the shared state above.
+    std::mutex m_mutex;
+
+    /// Member variable used to wake workers when a task is started.
+    std::condition_variable m_taskStarted;
+
+    /// Member variable used to wake the caller of run() when the last worker finishes.
+    std::condition_variable m_taskFinished;
+
+    /**
+     *\brief Loop run by each worker thread.
+     *\param worker index of the worker.
+     */
+    void workerLoop(int worker);
+
+    /**
+     *\brief Runs a task on every worker and waits for all of them to finish.
+     *\param invoke function that calls the task for a worker.
+     *\param task address of the task, which must outlive the call.
+     */
+    void runTask(void (*invoke)(const void *task, int worker), const void *task);
+
+    /**
+     *\brief Calls a task of a known type for a worker.
+     *\param task address of the task.
+     *\param worker index of the worker.
+     */
+    template<typename Task>
+    static void invokeTask(const void *task, int worker);
+
+public:
+    /**
+     *\brief Constructor that starts the worker threads.
+     *\param threadCount total number of threads including the calling thread, must be at least 1.
+     */
+    explicit ThreadPool(int threadCount);
+
+    /**
+     *\brief Destructor that stops and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     *\brief Getter for the number of threads.
+     *\return Integer value representing the number of threads including the calling thread.
+     */
+    int getThreadCount() const;
+
+    /**
+     *\brief Runs a task on every worker and waits for all of them to finish.
+     *\param task callable taking the index of the worker in the range [0, threadCount).
+     */
+    template<typename Task>
+    void run(const Task &task);
+};
+
+template<typename Task>
+void ThreadPool::invokeTask(const void *task, int worker)
+{
+    (*static_cast<const Task*>(task))(worker);
+}
+
+template<typename Task>
+void ThreadPool::run(const Task &task)
+{
+    runTask(&ThreadPool::invokeTask<Task>, &task);
+}
+
+#endif /* ThreadPool_hpp */
@@ -0,0 +1,154 @@
+#include "TiledStepper.hpp"
+#include "EvolveKernels.hpp"
+#include "BoardHash.hpp"
+#include "Metrics.hpp"
+#include <algorithm> // For std::fill, std::min and std::count.
+
+TiledStepper::TiledStepper(int rows, int cols, int tileRows, int tileWords) :
+m_rowCount{rows},
+m_wordsPerRow{(cols + LifeBoard::cellsPerWord - 1) / LifeBoard::cellsPerWord},
+m_tileRows{tileRows},
+m_tileWords{tileWords},
+m_tileRowCount{(rows + tileRows - 1) / tileRows},
+m_tileColCount{(m_wordsPerRow + tileWords - 1) / tileWords},
+m_changed(static_cast<std::size_t>(m_tileRowCount) * m_tileColCount, 1),
+m_active(m_changed.size(), 1),
+m_differences(m_tileColCount, 0),
+m_primed{false},
+m_activeTiles{0}
+{}
+
+void TiledStepper::reset()
+{
+    m_primed = false;
+}
+
+void TiledStepper::step(LifeBoard &updatedBoard, LifeBoard &currentBoard)
+{
+    // Work out which tiles have a changed tile in their neighbourhood, with wrap round.
+    if(m_primed)
+    {
+        for(int tileRow = 0; tileRow < m_tileRowCount; ++tileRow)
+        {
+            for(int tileCol = 0; tileCol < m_tileColCount; ++tileCol)
+            {
+                char active = 0;
+                for(int i = -1; i <= 1 && !active; ++i)
+                {
+                    int neighbourRow = (tileRow + i + m_tileRowCount) % m_tileRowCount;
+                    for(int j = -1; j <= 1; ++j)
+                    {
+                        int neighbourCol = (tileCol + j + m_tileColCount) % m_tileColCount;
+                        active |= m_changed[neighbourRow * m_tileColCount + neighbourCol];
+                    }
+                }
+                m_active[tileRow * m_tileColCount + tileCol] = active;
+            }
+        }
+    }
+    else
+    {
+        std::fill(m_active.begin(), m_active.end(), 1);
+    }
+
+    int maxCols = currentBoard.getCols();
+    LifeBoard::Word lastMask = currentBoard.lastWordMask();
+    RowKernel evolveRow = getRowKernel(activeKernel());
+    m_activeTiles = 0;
+
+    // Skipped tiles match the current board, so the hash only changes by the words of the active tiles.
+    bool trackHash = currentBoard.isTrackingHash();
+    std::uint64_t hash = trackHash ? currentBoard.hash() : 0;
+    std::uint64_t evaluatedWords = 0;
+
+    for(int tileRow = 0; tileRow < m_tileRowCount; ++tileRow)
+    {
+        const char *active = &m_active[tileRow * m_tileColCount];
+        char *changed = &m_changed[tileRow * m_tileColCount];
+
+        int activeInRow = static_cast<int>(std::count(active, active + m_tileColCount, 1));
+        m_activeTiles += activeInRow;
+        if(activeInRow == 0)
+        {
+            std::fill(changed, changed + m_tileColCount, 0);
+            continue;
+        }
+
+        std::fill(m_differences.begin(), m_differences.end(), 0);
+        int endRow = std::min(m_rowCount, (tileRow + 1) * m_tileRows);
+        for(int row = tileRow * m_tileRows; row < endRow; ++row)
+        {
+            // Neighbouring rows taking into account periodic boundary conditions.
+            int above = (row == 0) ? m_rowCount - 1 : row - 1;
+            int below = (row == m_rowCount - 1) ? 0 : row + 1;
+            const LifeBoard::Word *current = currentBoard.rowData(row);
+            LifeBoard::Word *updated = updatedBoard.rowData(row);
+
+            // Evolve each run of neighbouring active tiles with a single kernel call.
+            int tileCol = 0;
+            while(tileCol < m_tileColCount)
+            {
+                if(!active[tileCol])
+                {
+                    ++tileCol;
+                    continue;
+                }
+                int runEnd = tileCol;
+                while(runEnd < m_tileColCount && active[runEnd])
+                {
+                    ++runEnd;
+                }
+
+                int beginWord = tileCol * m_tileWords;
+                int endWord   = std::min(m_wordsPerRow, runEnd * m_tileWords);
+                evolveRow(currentBoard.rowData(above), current, currentBoard.rowData(below), 
+                          updated, m_wordsPerRow, maxCols, lastMask, beginWord, endWord);
+                evaluatedWords += endWord - beginWord;
+
+                for(int word = beginWord; word < endWord; ++word)
+                {
+                    m_differences[word / m_tileWords] |= updated[word] ^ current[word];
+                }
+
+                if(trackHash)
+                {
+                    std::size_t index = static_cast<std::size_t>(row) * m_wordsPerRow + beginWord;
+                    hash += hashWords(index, updated + beginWord, endWord - beginWord) - hashWords(index, current + beginWord, endWord - beginWord);
+                }
+
+                tileCol = runEnd;
+            }
+        }
+
+        for(int tileCol = 0; tileCol < m_tileColCount; ++tileCol)
+        {
+            changed[tileCol] = active[tileCol] && m_differences[tileCol] != 0;
+        }
+    }
+
+    m_primed = true;
+    METRICS_COUNT(Counter::CellsEvaluated, evaluatedWords * LifeBoard::cellsPerWord);
+    METRICS_COUNT(Counter::TilesUpdated, m_activeTiles);
+    METRICS_COUNT(Counter::TilesSkipped, getTileCount() - m_activeTiles);
+
+    updatedBoard.setHashTracking(trackHash);
+    if(trackHash)
+    {
+        updatedBoard.setHash(hash);
+    }
+}
+
+int TiledStepper::getTileCount() const
+{
+    return m_tileRowCount * m_tileColCount;
+}
+
+int TiledStepper::getActiveTileCount() const
+{
+    return m_activeTiles;
+}
+
+int TiledStepper::getChangedTileCount() const
+{
+    return static_cast<int>(std::count(m_changed.begin(), m_changed.end(), 1));
+}
@@ -0,0 +1,99 @@
+#ifndef TiledStepper_hpp
+#define TiledStepper_hpp
+
+#include <vector> // For holding the tile flags.
+#include "LifeBoard.hpp"
+
+/**
+ * \file
+ * \brief Class to model a stepper that only updates the parts of a board that can change.
+ *
+ * The board is split into tiles of whole words and the stepper remembers which tiles changed 
+ * in the last generation. A tile can only change if it or one of its eight neighbouring tiles 
+ * changed in the last generation, taking the periodic boundary conditions into account, so every 
+ * other tile is skipped. Once a board has settled into still lifes the work done each 
+ * generation therefore depends on the number of active cells rather than the size of the board.
+ *
+ * Skipped tiles are not written at all, this relies on the updated board holding the generation 
+ * before the current board, so the stepper must be called with the same two boards swapped after 
+ * every step as is done in main.cpp. Call reset() if the boards are modified in any other way.
+ */
+class TiledStepper
+{
+private:
+    /// Member variable that holds number of rows in the boards.
+    int m_rowCount;
+
+    /// Member variable that holds number of words per row in the boards.
+    int m_wordsPerRow;
+
+    /// Member variable that holds number of board rows in each tile.
+    int m_tileRows;
+
+    /// Member variable that holds number of words of each row in each tile.
+    int m_tileWords;
+
+    /// Member variable that holds the number of rows of tiles.
+    int m_tileRowCount;
+
+    /// Member variable that holds the number of columns of tiles.
+    int m_tileColCount;
+
+    /// Member variable that holds whether each tile changed in the last generation.
+    std::vector<char> m_changed;
+
+    /// Member variable that holds whether each tile must be updated in the current generation.
+    std::vector<char> m_active;
+
+    /// Member variable that accumulates the differences between generations for a row of tiles.
+    std::vector<LifeBoard::Word> m_differences;
+
+    /// Member variable that holds whether the change flags describe the boards being stepped.
+    bool m_primed;
+
+    /// Member variable that holds the number of tiles updated in the last generation.
+    int m_activeTiles;
+
+public:
+    /**
+     *\brief Constructor that sets up the tiles for boards of the given size.
+     *\param rows number of rows on the boards.
+     *\param cols number of columns on the boards.
+     *\param tileRows number of board rows in each tile.
+     *\param tileWords number of words of each row in each tile, each word holds LifeBoard::cellsPerWord cells.
+     */
+    TiledStepper(int rows, int cols, int tileRows = 64, int tileWords = 1);
+
+    /**
+     *\brief Forgets which tiles changed so the next step updates every tile.
+     */
+    void reset();
+
+    /**
+     *\brief Updates the board based on the rules for the GOL skipping tiles that cannot change.
+     *\param updatedBoard LifeBoard object that will be the updated board, it must hold the 
+     * generation before currentBoard unless this is the first step since a reset.
+     *\param currentBoard LifeBoard object that is the board the update is based on.
+     */
+    void step(LifeBoard &updatedBoard, LifeBoard &currentBoard);
+
+    /**
+     *\brief Getter for the total number of tiles.
+     *\return Integer value representing the number of tiles.
+     */
+    int getTileCount() const;
+
+    /**
+     *\brief Getter for the number of tiles updated in the last generation.
+     *\return Integer value representing the number of active tiles.
+     */
+    int getActiveTileCount() const;
+
+    /**
+     *\brief Getter for the number of tiles that changed in the last generation.
+     *\return Integer value representing the number of changed tiles.
+     */
+    int getChangedTileCount() const;
+};
+
+#endif /* TiledStepper_hpp */
@@ -1,4 +1,22 @@
 #include "LifeBoard.hpp"
+#include "BoardBuffers.hpp"
+#include "EvolveKernels.hpp"
+#include "ThreadPool.hpp"
+#include "HashLife.hpp"
+#include "SparseLife.hpp"
+#include "TiledStepper.hpp"
+#include "TemporalStepper.hpp"
+#include "PaddedStepper.hpp"
+#include "Rule.hpp"
+#include "PatternIO.hpp"
+#include "Checkpoint.hpp"
+#include "FrameRenderer.hpp"
+#include "SnapshotRing.hpp"
+#include "CycleDetector.hpp"
+#include "Ensemble.hpp"
+#include "Metrics.hpp"
+#include "PagedBoard.hpp"
+#include "PatternCensus.hpp"
 #include <random>
 #include <iostream>
 #include <algorithm>
@@ -6,6 +24,25 @@
 #include <chrono>
 #include <boost/program_options.hpp>
 #include <fstream>
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+#include <unistd.h> // For STDOUT_FILENO.
+#include <csignal> // For stopping cleanly on Ctrl-C.
+#include <sstream> // For parsing the list of densities.
+#include <memory> // For std::unique_ptr.
+#include <cstdio> // For std::rename and std::remove.
+
+namespace
+{
+    /// Set when the user presses Ctrl-C so the main loop can stop and flush its output.
+    volatile std::sig_atomic_t interrupted = 0;
+
+    void handleInterrupt(int)
+    {
+        interrupted = 1;
+    }
+}
 
 int main(int argc, char const *argv[])
 {
@@ -13,16 +50,42 @@ int main(int argc, char const *argv[])
 ************************************************* Preparations **********************************************************
 *************************************************************************************************************************/
 
-    // Seed the pseudo random number generator using the system clock.
+    // By default seed the pseudo random number generator using the system clock.
     unsigned int seed = static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count());
 
-    // Create a generator that can be fed to any distribution to produce pseudo random numbers according to that distribution. 
-    std::default_random_engine generator(seed);
-
     // Input parameters.
     int rowCount;
     int colCount;
     int outputFrequency;
+    std::string kernel;
+    int threadCount;
+    std::string engine;
+    int stepLog2;
+    std::size_t nodeCap;
+    std::string boundary;
+    std::string rule;
+    long long generations;
+    std::string patternFile;
+    int patternRow;
+    int patternCol;
+    std::string savePatternFile;
+    std::string checkpointFile;
+    long long checkpointEvery;
+    std::string resumeFile;
+    std::string render;
+    int maxPeriod;
+    int temporalDepth;
+    int ensembleTrials;
+    std::string densities;
+    std::string ensembleOutput;
+    double density;
+    std::string metricsFile;
+    double metricsInterval;
+    std::string boardFile;
+    std::size_t cacheMegabytes;
+    std::string viewport;
+    long long censusEvery;
+    std::string censusOutput;
 
     // Set up optional command line argument.
     boost::program_options::options_description desc("Options for Game of Life program");
@@ -33,6 +96,41 @@ int main(int argc, char const *argv[])
         ("column-count,c", boost::program_options::value<int>(&rowCount)->default_value(50), "The number of rows in the board.")
         ("row-count,r", boost::program_options::value<int>(&colCount)->default_value(50), "The number of columns in the board.")
         ("output-frequency,f", boost::program_options::value<int>(&outputFrequency)->default_value(100), "The pause time between outputting the updated board")
+        ("kernel,k", boost::program_options::value<std::string>(&kernel)->default_value(kernelName(bestKernel())), "The update kernel to use (scalar, avx2 or avx512), defaults to the fastest the CPU supports.")
+        ("threads,t", boost::program_options::value<int>(&threadCount)->default_value(1), "The number of threads used to update the board.")
+        ("engine,e", boost::program_options::value<std::string>(&engine)->default_value("dense"), "The simulation engine to use (dense, hashlife or sparse for large empty planes with few live cells, or paged for boards kept on disk).")
+        ("step-log2", boost::program_options::value<int>(&stepLog2)->default_value(0), "With the hashlife engine advance 2^step-log2 generations between outputs.")
+        ("node-cap", boost::program_options::value<std::size_t>(&nodeCap)->default_value(HashLife::defaultMaxNodes), "With the hashlife engine the number of nodes above which garbage is collected.")
+        ("rule", boost::program_options::value<std::string>(&rule)->default_value("B3/S23"), "The Life-like rule in B/S notation, for example B36/S23 for HighLife.")
+        ("boundary,b", boost::program_options::value<std::string>(&boundary)->default_value("torus"), "The boundary conditions of the dense engine (torus, dead or unbounded).")
+        ("temporal-depth", boost::program_options::value<int>(&temporalDepth)->default_value(1), "With the dense engine on the torus advance this many generations per pass over the board, keeping bands of it in cache.")
+        ("padded", "With the dense engine on the torus keep the board padded with ghost cells and count neighbours with running column sums. Only headless runs gain from it, every generation shown interactively is copied back to the board and its statistics taken in a separate pass.")
+        ("dirty-tiles", "With the dense engine only update the tiles of the board that can have changed (single threaded).")
+        ("seed,s", boost::program_options::value<unsigned int>(&seed), "The seed for the random initial board, taken from the clock if not given.")
+        ("density", boost::program_options::value<double>(&density)->default_value(0.5), "The probability of each cell of the random initial board being alive.")
+        ("headless", "Run flat out without printing the board and report the speed of the simulation.")
+        ("generations,g", boost::program_options::value<long long>(&generations)->default_value(1000), "With --headless the number of generations to run.")
+        ("pattern,p", boost::program_options::value<std::string>(&patternFile), "Initialise with a pattern file (.rle, .lif, .life or .cells), its rule is used unless --rule is given.")
+        ("pattern-row", boost::program_options::value<int>(&patternRow)->default_value(0), "The row of the board the top of the pattern is placed at.")
+        ("pattern-col", boost::program_options::value<int>(&patternCol)->default_value(0), "The column of the board the left of the pattern is placed at.")
+        ("save-pattern", boost::program_options::value<std::string>(&savePatternFile), "With --headless write the final board to a pattern file, the format is taken from the extension.")
+        ("checkpoint", boost::program_options::value<std::string>(&checkpointFile), "Save the board to a binary checkpoint file, with --headless this is done at the end of the run.")
+        ("checkpoint-every", boost::program_options::value<long long>(&checkpointEvery)->default_value(0), "With --checkpoint also save the board every this many generations, 0 to disable.")
+        ("resume", boost::program_options::value<std::string>(&resumeFile), "Restore the board, generation, seed and rule from a checkpoint file, --generations then counts from generation 0 of the original run.")
+        ("render", boost::program_options::value<std::string>(&render)->default_value("cells"), "How the board is drawn, cells for one cell per character, half for 2 cells per character or braille for 8.")
+        ("diff", "Only redraw the parts of the board that changed since the last frame.")
+        ("detect-cycles", "With the dense engine stop as soon as the board dies out or repeats itself and report when.")
+        ("max-period", boost::program_options::value<int>(&maxPeriod)->default_value(64), "With --detect-cycles the longest period of oscillator that is recognised.")
+        ("ensemble", boost::program_options::value<int>(&ensembleTrials), "Instead of one board run this many random trials at each density on the torus, each until it settles or reaches --generations.")
+        ("densities", boost::program_options::value<std::string>(&densities)->default_value("0.5"), "With --ensemble a comma separated list of the probabilities of each cell starting alive.")
+        ("ensemble-output", boost::program_options::value<std::string>(&ensembleOutput)->default_value("ensemble.csv"), "With --ensemble the CSV file the result of every trial is written to.")
+        ("board-file", boost::program_options::value<std::string>(&boardFile), "With the paged engine the tiled file the board is kept in, an existing file is carried on from and otherwise one holding a random board is created.")
+        ("cache-mb", boost::program_options::value<std::size_t>(&cacheMegabytes)->default_value(256), "With the paged engine the megabytes of tiles of each board kept in memory at once.")
+        ("viewport", boost::program_options::value<std::string>(&viewport), "With the paged engine the part of the board that is drawn and measured as row,col,rows,cols, the top left 50x50 cells if not given.")
+        ("census-every", boost::program_options::value<long long>(&censusEvery)->default_value(0), "Count the objects left on the board by kind every this many generations, 0 to disable.")
+        ("census-output", boost::program_options::value<std::string>(&censusOutput)->default_value("census.csv"), "With --census-every the CSV file the count of each kind of object is written to.")
+        ("metrics-file", boost::program_options::value<std::string>(&metricsFile), "Write the phase timings and work counters to this file in the Prometheus text format, for example for the node exporter textfile collector.")
+        ("metrics-interval", boost::program_options::value<double>(&metricsInterval)->default_value(10.0), "With --metrics-file the number of seconds between rewrites of the file, it is also written when the run stops.")
         ("oscillator", "Initialise with an oscillator")
         ("glider", "Initialise with a glider")
         ("sink", "Initialise with a sink")
@@ -50,13 +148,339 @@ int main(int argc, char const *argv[])
         return 1;
     }
 
+    // Select the requested update kernel making sure the CPU can actually run it.
+    bool kernelFound = false;
+    for(KernelType type : {KernelType::Scalar, KernelType::Avx2, KernelType::Avx512})
+    {
+        if(kernel == kernelName(type) && isKernelSupported(type))
+        {
+            setActiveKernel(type);
+            kernelFound = true;
+        }
+    }
+    if(!kernelFound)
+    {
+        std::cerr << "Kernel " << kernel << " is not available on this CPU.\n";
+        return 1;
+    }
+
+    if(threadCount < 1)
+    {
+        std::cerr << "The number of threads must be at least 1.\n";
+        return 1;
+    }
+
+    if(engine != "dense" && engine != "hashlife" && engine != "sparse" && engine != "paged")
+    {
+        std::cerr << "Unknown engine " << engine << ".\n";
+        return 1;
+    }
+
+    // Parse the rule before any engine is created since they all pick up the active rule.
+    try
+    {
+        setActiveRule(Rule(rule));
+    }
+    catch(const std::invalid_argument &error)
+    {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    if(boundary != "torus" && boundary != "dead" && boundary != "unbounded")
+    {
+        std::cerr << "Unknown boundary " << boundary << ".\n";
+        return 1;
+    }
+
+    if(render != "cells" && render != "half" && render != "braille")
+    {
+        std::cerr << "Unknown render mode " << render << ".\n";
+        return 1;
+    }
+
+    if(checkpointEvery < 0)
+    {
+        std::cerr << "The checkpoint-every must not be negative.\n";
+        return 1;
+    }
+
+    if(stepLog2 < 0 || stepLog2 > 56)
+    {
+        std::cerr << "The step-log2 must be between 0 and 56.\n";
+        return 1;
+    }
+
+    if(maxPeriod < 1)
+    {
+        std::cerr << "The max-period must be at least 1.\n";
+        return 1;
+    }
+
+    if(vm.count("detect-cycles") && engine != "dense")
+    {
+        std::cerr << "Cycle detection is only available with the dense engine.\n";
+        return 1;
+    }
+
+    if(censusEvery < 0)
+    {
+        std::cerr << "The census-every must not be negative.\n";
+        return 1;
+    }
+
+    if(censusEvery > 0 && (engine == "paged" || vm.count("ensemble")))
+    {
+        std::cerr << "The census is not available with the paged engine or --ensemble.\n";
+        return 1;
+    }
+
+    if(density < 0.0 || density > 1.0)
+    {
+        std::cerr << "The density must be between 0 and 1.\n";
+        return 1;
+    }
+
+    if(temporalDepth < 1)
+    {
+        std::cerr << "The temporal-depth must be at least 1.\n";
+        return 1;
+    }
+
+    if(temporalDepth > 1 && (engine != "dense" || boundary != "torus" || vm.count("dirty-tiles") || vm.count("detect-cycles")))
+    {
+        std::cerr << "The temporal-depth can only be used with the dense engine on the torus, without --dirty-tiles or --detect-cycles.\n";
+        return 1;
+    }
+
+    if(vm.count("metrics-file") && !metricsEnabled())
+    {
+        std::cerr << "This build has no metrics, rebuild with make METRICS=1 to use --metrics-file.\n";
+        return 1;
+    }
+
+    if(metricsInterval <= 0.0)
+    {
+        std::cerr << "The metrics-interval must be positive.\n";
+        return 1;
+    }
+
+    // Rewrites the metrics file every interval, does nothing unless the user asked for one.
+    MetricsExporter metricsExporter(metricsFile, metricsInterval);
+    auto exportMetrics = [&]()
+    {
+        if(!metricsExporter.write())
+        {
+            std::cerr << "Could not write metrics file " << metricsFile << ".\n";
+        }
+    };
+
+    if(vm.count("padded") && (engine != "dense" || boundary != "torus" || vm.count("dirty-tiles") || temporalDepth > 1 || vm.count("detect-cycles")))
+    {
+        std::cerr << "The padded layout can only be used with the dense engine on the torus, without --dirty-tiles, --temporal-depth or --detect-cycles.\n";
+        return 1;
+    }
+
+    if(engine == "paged" && (!vm.count("board-file") || boundary != "torus" || vm.count("dirty-tiles") || vm.count("pattern") || vm.count("resume") || vm.count("checkpoint")
+                             || vm.count("save-pattern") || vm.count("oscillator") || vm.count("glider") || vm.count("sink")))
+    {
+        std::cerr << "The paged engine needs a --board-file and runs on the torus from a random board or the one in the file, without patterns, checkpoints or --dirty-tiles.\n";
+        return 1;
+    }
+
+    // Create the worker threads once up front so none are created per generation.
+    ThreadPool pool(threadCount);
+
+/*************************************************************************************************************************
+************************************************* Ensemble Run **********************************************************
+*************************************************************************************************************************/
+    if(vm.count("ensemble"))
+    {
+        EnsembleSettings settings{rowCount, colCount, {}, ensembleTrials, seed, static_cast<std::uint64_t>(std::max(generations, 0LL)), maxPeriod};
+
+        std::istringstream densityList(densities);
+        std::string density;
+        while(std::getline(densityList, density, ','))
+        {
+            std::istringstream parser(density);
+            double value;
+            if(!(parser >> value) || value < 0.0 || value > 1.0)
+            {
+                std::cerr << "Invalid density " << density << ".\n";
+                return 1;
+            }
+            settings.densities.push_back(value);
+        }
+        if(ensembleTrials < 1 || settings.densities.empty())
+        {
+            std::cerr << "The ensemble needs at least one trial and one density.\n";
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<TrialResult> results = runEnsemble(settings, pool);
+        double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        exportMetrics();
+
+        std::ofstream csvOutput(ensembleOutput);
+        writeEnsembleCsv(csvOutput, results);
+        if(!csvOutput)
+        {
+            std::cerr << "Could not write ensemble file " << ensembleOutput << ".\n";
+            return 1;
+        }
+
+        int outcomes[3] = {0, 0, 0};
+        for(const TrialResult &result : results)
+        {
+            ++outcomes[static_cast<int>(result.outcome)];
+        }
+
+        std::cout << "Seed:              " << seed << '\n';
+        std::cout << "Board:             " << rowCount << 'x' << colCount << '\n';
+        std::cout << "Trials:            " << results.size() << '\n';
+        std::cout << "Wall time (s):     " << wallTime << '\n';
+        std::cout << "Trials/s:          " << results.size() / wallTime << '\n';
+        std::cout << "Extinct:           " << outcomes[static_cast<int>(TrialOutcome::Extinct)] << '\n';
+        std::cout << "Cycles:            " << outcomes[static_cast<int>(TrialOutcome::Cycle)] << '\n';
+        std::cout << "Reached limit:     " << outcomes[static_cast<int>(TrialOutcome::Limit)] << '\n';
+        return 0;
+    }
+
+/*************************************************************************************************************************
+************************************************* Paged Run *************************************************************
+*************************************************************************************************************************/
+    if(engine == "paged")
+    {
+        // The two boards take turns holding the current generation, the other is kept in a scratch
+        // file beside the board file and the final generation is moved into the board file at the end.
+        std::string scratchFile = boardFile + ".next";
+        std::size_t cacheBytes = cacheMegabytes << 20;
+        std::unique_ptr<PagedBoard> pagedCurrent;
+        std::unique_ptr<PagedBoard> pagedUpdated;
+        try
+        {
+            if(std::ifstream(boardFile))
+            {
+                pagedCurrent.reset(new PagedBoard(boardFile, cacheBytes));
+            }
+            else
+            {
+                pagedCurrent.reset(new PagedBoard(boardFile, rowCount, colCount, cacheBytes));
+                pagedCurrent->randomise(seed, density);
+            }
+            pagedUpdated.reset(new PagedBoard(scratchFile, pagedCurrent->getRows(), pagedCurrent->getCols(), cacheBytes));
+        }
+        catch(const std::exception &error)
+        {
+            std::cerr << error.what() << '\n';
+            return 1;
+        }
+        rowCount = pagedCurrent->getRows();
+        colCount = pagedCurrent->getCols();
+
+        // Only the viewport is ever copied out of the board, to be drawn or measured.
+        int viewRow  = 0;
+        int viewCol  = 0;
+        int viewRows = std::min(rowCount, 50);
+        int viewCols = std::min(colCount, 50);
+        if(vm.count("viewport"))
+        {
+            std::istringstream parser(viewport);
+            char comma1, comma2, comma3;
+            if(!(parser >> viewRow >> comma1 >> viewCol >> comma2 >> viewRows >> comma3 >> viewCols) || comma1 != ',' || comma2 != ',' || comma3 != ','
+               || viewRows < 1 || viewCols < 1 || viewRows > rowCount || viewCols > colCount)
+            {
+                std::cerr << "Invalid viewport " << viewport << ", expected row,col,rows,cols no bigger than the board.\n";
+                return 1;
+            }
+        }
+        LifeBoard view(viewRows, viewCols, LifeBoard::Dead);
+
+        std::uint64_t generation = 0;
+        bool currentInScratch = false;
+        auto stepPaged = [&]()
+        {
+            METRICS_TIME(Phase::Step);
+            METRICS_COUNT(Counter::Generations, 1);
+            update(*pagedUpdated, *pagedCurrent, pool);
+            std::swap(pagedUpdated, pagedCurrent);
+            currentInScratch = !currentInScratch;
+            ++generation;
+        };
+
+        int status = 0;
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            if(vm.count("headless"))
+            {
+                while(generation < static_cast<std::uint64_t>(std::max(generations, 0LL)))
+                {
+                    stepPaged();
+                    metricsExporter.poll();
+                }
+            }
+            else
+            {
+                RenderMode renderMode = (render == "half") ? RenderMode::HalfBlock : (render == "braille") ? RenderMode::Braille : RenderMode::Cells;
+                FrameRenderer renderer(STDOUT_FILENO, renderMode, vm.count("diff") > 0);
+                std::signal(SIGINT, handleInterrupt);
+                while(!interrupted)
+                {
+                    stepPaged();
+                    {
+                        METRICS_TIME(Phase::Render);
+                        pagedCurrent->copyRegion(viewRow, viewCol, view);
+                        renderer.render(view);
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    metricsExporter.poll();
+                }
+            }
+            pagedCurrent->copyRegion(viewRow, viewCol, view);
+        }
+        catch(const std::runtime_error &error)
+        {
+            std::cerr << error.what() << '\n';
+            status = 1;
+        }
+        double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        exportMetrics();
+
+        if(vm.count("headless") && status == 0)
+        {
+            std::pair<double,double> centreOfMass = view.centreOfMass();
+            std::cout << "Seed:              " << seed << '\n';
+            std::cout << "Board:             " << rowCount << 'x' << colCount << '\n';
+            std::cout << "Generations:       " << generation << '\n';
+            std::cout << "Wall time (s):     " << wallTime << '\n';
+            std::cout << "Generations/s:     " << generation / wallTime << '\n';
+            std::cout << "Cells/s:           " << static_cast<double>(rowCount) * colCount * generation / wallTime << '\n';
+            std::cout << "Final population:  " << pagedCurrent->getPopulation() << '\n';
+            std::cout << "Stored tiles:      " << pagedCurrent->getStoredTiles() << '\n';
+            std::cout << "Viewport:          " << viewRows << 'x' << viewCols << " at " << viewRow << ',' << viewCol << '\n';
+            std::cout << "Viewport cells:    " << view.getPopulation() << '\n';
+            std::cout << "Viewport centre:   " << centreOfMass.first << ' ' << centreOfMass.second << '\n';
+        }
+
+        // Close both boards so their directories are written before the files are moved.
+        pagedCurrent.reset();
+        pagedUpdated.reset();
+        if(currentInScratch ? std::rename(scratchFile.c_str(), boardFile.c_str()) != 0 : std::remove(scratchFile.c_str()) != 0)
+        {
+            std::cerr << "Could not move the final board into " << boardFile << ".\n";
+            status = 1;
+        }
+        return status;
+    }
 
     
     std::ofstream comOutput("COM.dat",std::ofstream::out);
     
 
-    // Create a board that represents the current state of the system , initially it will be all dead.
-    LifeBoard boardCurrent(rowCount, colCount, LifeBoard::Dead);
+    // Create a board the initial state of the system is set up in, initially it will be all dead.
+    LifeBoard initialBoard(rowCount, colCount, LifeBoard::Dead);
 
     /*
      * It is useful to know what the ``centre'' cell is so we can place any specific configurations
@@ -66,93 +490,506 @@ int main(int argc, char const *argv[])
      int centreCol = colCount/2;
 
 
-    // If the user requested an example behaviour then display that.
-    if(vm.count("oscillator"))
+    // Generation the board is at, only non-zero when resuming a run.
+    std::uint64_t generation = 0;
+
+    // A resumed board is a view straight onto the mapped checkpoint until it is copied into the 
+    // boards that are stepped, so the mapping is kept until then.
+    std::unique_ptr<CheckpointMapping> resumedCheckpoint;
+
+    // If the user is resuming a run restore it, if they gave a pattern file load it, otherwise 
+    // display any example behaviour they requested.
+    if(vm.count("resume"))
+    {
+        try
+        {
+            resumedCheckpoint.reset(new CheckpointMapping(resumeFile));
+            initialBoard = resumedCheckpoint->view();
+            const CheckpointInfo &info = resumedCheckpoint->getInfo();
+
+            // The checkpoint decides the size of the board and carries on under the original rule.
+            rowCount   = initialBoard.getRows();
+            colCount   = initialBoard.getCols();
+            seed       = info.seed;
+            generation = info.generation;
+            if(vm["rule"].defaulted())
+            {
+                setActiveRule(info.rule);
+            }
+        }
+        catch(const std::exception &error)
+        {
+            std::cerr << error.what() << '\n';
+            return 1;
+        }
+    }
+    else if(vm.count("pattern"))
+    {
+        std::ifstream patternInput(patternFile);
+        if(!patternInput)
+        {
+            std::cerr << "Could not open pattern file " << patternFile << ".\n";
+            return 1;
+        }
+
+        try
+        {
+            PatternInfo info = readPattern(patternInput, patternFormatFromFileName(patternFile), initialBoard, patternRow, patternCol);
+
+            // A rule given on the command line takes precedence over the one in the file.
+            if(!info.rule.empty() && vm["rule"].defaulted())
+            {
+                setActiveRule(Rule(info.rule));
+            }
+        }
+        catch(const std::exception &error)
+        {
+            std::cerr << "Could not read pattern file " << patternFile << ": " << error.what() << '\n';
+            return 1;
+        }
+    }
+    else if(vm.count("oscillator"))
     {   
         /*
          * For an oscillator we can just place a blinker in the centre of the board.
          * The easiest way to do this is just a column of three alive cells.
          */
-        boardCurrent(centreRow-1, centreCol) = LifeBoard::Alive;
-        boardCurrent(centreRow, centreCol)   = LifeBoard::Alive;
-        boardCurrent(centreRow+1 ,centreCol) = LifeBoard::Alive;
+        initialBoard(centreRow-1, centreCol) = LifeBoard::Alive;
+        initialBoard(centreRow, centreCol)   = LifeBoard::Alive;
+        initialBoard(centreRow+1 ,centreCol) = LifeBoard::Alive;
     }
     else if(vm.count("glider"))
     {
         // For a glider we just place it in the middle of the board.
-        boardCurrent(centreRow-1, centreCol)    = LifeBoard::Alive;
-        boardCurrent(centreRow, centreCol+1)    = LifeBoard::Alive;
-        boardCurrent(centreRow+1, centreCol-1)  = LifeBoard::Alive;
-        boardCurrent(centreRow+1, centreCol)    = LifeBoard::Alive;
-        boardCurrent(centreRow+1,centreCol+1)   = LifeBoard::Alive;
+        initialBoard(centreRow-1, centreCol)    = LifeBoard::Alive;
+        initialBoard(centreRow, centreCol+1)    = LifeBoard::Alive;
+        initialBoard(centreRow+1, centreCol-1)  = LifeBoard::Alive;
+        initialBoard(centreRow+1, centreCol)    = LifeBoard::Alive;
+        initialBoard(centreRow+1,centreCol+1)   = LifeBoard::Alive;
     }
     else if(vm.count("sink"))
     {
         // For a sink we just place 4 live cells in a square in the middle of the board.
-        boardCurrent(centreRow, centreCol)      = LifeBoard::Alive;
-        boardCurrent(centreRow, centreCol+1)    = LifeBoard::Alive;
-        boardCurrent(centreRow+1, centreCol)    = LifeBoard::Alive;
-        boardCurrent(centreRow+1, centreCol+1)  = LifeBoard::Alive;
+        initialBoard(centreRow, centreCol)      = LifeBoard::Alive;
+        initialBoard(centreRow, centreCol+1)    = LifeBoard::Alive;
+        initialBoard(centreRow+1, centreCol)    = LifeBoard::Alive;
+        initialBoard(centreRow+1, centreCol+1)  = LifeBoard::Alive;
     }
     // Otherwise just use a random configuration.
     else
     {
-        boardCurrent.randomise(generator);
+        initialBoard.randomise(seed, density, pool);
     }
 
-    // Create a board that represents the updated state of the system making sure it is initially the same as the current board.
-    LifeBoard boardUpdated = boardCurrent;
+    // Cycle detection works from the hash of each generation, which the updates keep up to date as they go.
+    bool detectCycles = vm.count("detect-cycles") > 0;
+    initialBoard.setHashTracking(detectCycles);
+
+    // Step between a current and an updated board made once in an arena, with each worker first
+    // touching the rows it updates, so stepping never allocates and swapping the boards only
+    // exchanges the views. The arena holds the cells from here on so the initial board is released.
+    BoardBuffers boardBuffers(initialBoard, 0, pool);
+    initialBoard = LifeBoard(0, 0, LifeBoard::Dead);
+    resumedCheckpoint.reset();
+    LifeBoard &boardCurrent = boardBuffers.current();
+    LifeBoard &boardUpdated = boardBuffers.next();
+
+    // Tracks which tiles changed so settled parts of the board can be skipped.
+    TiledStepper tiledStepper(rowCount, colCount);
+
+    // Advances several generations per pass over the board when a temporal depth is given.
+    TemporalStepper temporalStepper;
+
+    // The hashlife and sparse engines evolve the pattern on an infinite plane and the boards just show the window onto it.
+    HashLife hashLife(nodeCap);
+    SparseLife sparseLife;
+    if(engine == "hashlife")
+    {
+        hashLife.setBoard(boardCurrent);
+    }
+    else if(engine == "sparse")
+    {
+        sparseLife.setBoard(boardCurrent);
+    }
+    PaddedStepper paddedStepper;
+    if(vm.count("padded"))
+    {
+        paddedStepper.setBoard(boardCurrent);
+    }
+
+    // Saves the current board to the checkpoint file if the user asked for one.
+    auto saveCheckpoint = [&](const LifeBoard &board)
+    {
+        if(vm.count("checkpoint"))
+        {
+            METRICS_TIME(Phase::Checkpoint);
+            writeCheckpoint(checkpointFile, board, CheckpointInfo{generation, seed, activeRule()});
+        }
+    };
+
+    // Checks whether the board has died out or repeated an earlier generation, describing what happened if it has.
+    // A repeated hash is confirmed by stepping a copy of the board through the period under the same boundary.
+    CycleDetector cycleDetector(maxPeriod);
+    std::string stopReason;
+    auto stepCopy = [&](LifeBoard &updated, LifeBoard &current)
+    {
+        if(boundary == "dead")
+        {
+            update<DeadEdge>(updated, current);
+        }
+        else if(boundary == "unbounded")
+        {
+            update<Unbounded>(updated, current);
+        }
+        else
+        {
+            update(updated, current, pool);
+        }
+    };
+    auto reachedSteadyState = [&](const LifeBoard &board)
+    {
+        METRICS_TIME(Phase::CycleCheck);
+        if(board.hash() == 0 && board.getPopulation() == 0)
+        {
+            stopReason = "extinct at generation " + std::to_string(generation);
+            return true;
+        }
+        if(cycleDetector.record(generation, board.hash()) && cycleDetector.confirm(board, stepCopy))
+        {
+            stopReason = "cycle of period " + std::to_string(cycleDetector.getPeriod()) + " from generation " + std::to_string(cycleDetector.getCycleStart());
+            return true;
+        }
+        return false;
+    };
+    bool steady = detectCycles && reachedSteadyState(boardCurrent);
+
+    // Counts the objects on the board by kind and writes them to the census file, objects only 
+    // wrap round the edges with the dense engine on the torus.
+    PatternCensus patternCensus;
+    std::ofstream censusFile;
+    if(censusEvery > 0)
+    {
+        censusFile.open(censusOutput);
+        writeCensusCsvHeader(censusFile);
+    }
+    std::uint64_t lastCensus = ~std::uint64_t(0);
+    auto takeCensus = [&](const LifeBoard &board)
+    {
+        METRICS_TIME(Phase::Census);
+        bool periodic = (engine == "dense" && boundary == "torus");
+        writeCensusCsv(censusFile, generation, patternCensus.count(board, periodic, pool));
+        lastCensus = generation;
+    };
+
+    // Number of generations each step advances, hashlife and temporal blocking can advance many at a time.
+    std::uint64_t generationsPerStep = (engine == "hashlife") ? std::uint64_t(1) << stepLog2 : static_cast<std::uint64_t>(temporalDepth);
+
+    // Advances the simulation by one step of the chosen engine leaving the result in boardUpdated, 
+    // apart from the padded layout which keeps it until it is copied out. The dense engine can be 
+    // asked for fewer generations than a whole step.
+    auto step = [&](std::uint64_t count)
+    {
+        METRICS_TIME(Phase::Step);
+        METRICS_COUNT(Counter::Generations, (engine == "dense") ? count : generationsPerStep);
+        if(engine == "hashlife")
+        {
+            hashLife.stepPow2(stepLog2);
+            hashLife.copyToBoard(boardUpdated);
+        }
+        else if(engine == "sparse")
+        {
+            sparseLife.step();
+            sparseLife.copyToBoard(boardUpdated);
+        }
+        else if(boundary == "dead")
+        {
+            update<DeadEdge>(boardUpdated, boardCurrent);
+        }
+        else if(boundary == "unbounded")
+        {
+            update<Unbounded>(boardUpdated, boardCurrent);
+        }
+        else if(vm.count("dirty-tiles"))
+        {
+            tiledStepper.step(boardUpdated, boardCurrent);
+        }
+        else if(vm.count("padded"))
+        {
+            paddedStepper.step(pool);
+        }
+        else if(count > 1)
+        {
+            temporalStepper.step(boardUpdated, boardCurrent, static_cast<int>(count), pool);
+        }
+        else
+        {
+            update(boardUpdated, boardCurrent, pool);
+        }
+    };
 
 
 /*************************************************************************************************************************
-************************************************* Main Loop *************************************************************
+************************************************* Headless Run **********************************************************
 *************************************************************************************************************************/
-    int counter = 0;
-    while(true)
+    if(vm.count("headless"))
     {
-        // Update the board.
-        update(boardUpdated, boardCurrent);
-    
-        // Print the updated board.
-        std::cout << boardUpdated;
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto start = std::chrono::steady_clock::now();
+
+        // A resumed run only has the generations left to do.
+        std::uint64_t finalGeneration = static_cast<std::uint64_t>(std::max(generations, 0LL));
+        std::uint64_t startGeneration = std::min(generation, finalGeneration);
+        std::uint64_t chunk = (checkpointEvery > 0) ? static_cast<std::uint64_t>(checkpointEvery) : finalGeneration;
+        std::uint64_t nextCheckpoint = std::min(finalGeneration, generation + chunk);
 
-        // If the user has asked for a glider we can calculate its centre of mass.
-        if(vm.count("glider"))
+        try
         {
-      		// The periodic boundary conditions will cause strange values for the centre of mass when the 
-      		// glider crosses a boundary so need to check if the boundary has been crossed.
+            // Hashlife, the sparse engine and the padded layout only need to fill the board at a checkpoint or census, the other dense engines step the board itself.
+            while(generation < finalGeneration && !steady)
+            {
+                std::uint64_t target = nextCheckpoint;
+                if(censusEvery > 0)
+                {
+                    target = std::min(target, (generation / static_cast<std::uint64_t>(censusEvery) + 1) * static_cast<std::uint64_t>(censusEvery));
+                }
+                if(engine == "hashlife")
+                {
+                    METRICS_TIME(Phase::Step);
+                    METRICS_COUNT(Counter::Generations, target - generation);
+                    hashLife.advance(target - generation);
+                    hashLife.copyToBoard(boardCurrent);
+                    generation = target;
+                }
+                else if(engine == "sparse")
+                {
+                    METRICS_TIME(Phase::Step);
+                    METRICS_COUNT(Counter::Generations, target - generation);
+                    sparseLife.advance(target - generation);
+                    sparseLife.copyToBoard(boardCurrent);
+                    generation = target;
+                }
+                else if(vm.count("padded"))
+                {
+                    METRICS_TIME(Phase::Step);
+                    METRICS_COUNT(Counter::Generations, target - generation);
+                    paddedStepper.advance(target - generation, pool);
+                    paddedStepper.copyToBoard(boardCurrent);
+                    generation = target;
+                }
+                else
+                {
+                    while(generation < target && !steady)
+                    {
+                        std::uint64_t count = std::min(generationsPerStep, target - generation);
+                        step(count);
+                        boardBuffers.flip();
+                        generation += count;
+                        steady = detectCycles && reachedSteadyState(boardCurrent);
+                        metricsExporter.poll();
+                    }
+                }
 
-            if(!boardUpdated.isBoundaryLive())
+                if(censusEvery > 0 && generation % static_cast<std::uint64_t>(censusEvery) == 0)
+                {
+                    takeCensus(boardCurrent);
+                }
+                if(generation == nextCheckpoint)
+                {
+                    if(generation < finalGeneration && !steady)
+                    {
+                        saveCheckpoint(boardCurrent);
+                    }
+                    nextCheckpoint = std::min(finalGeneration, generation + chunk);
+                }
+                metricsExporter.poll();
+            }
+            saveCheckpoint(boardCurrent);
+
+            // Make sure the census ends with the final board, whenever the run stopped.
+            if(censusEvery > 0 && lastCensus != generation)
             {
-            std::pair<double,double> centreOfMass = boardUpdated.centreOfMass();
+                takeCensus(boardCurrent);
+            }
+        }
+        catch(const std::runtime_error &error)
+        {
+            std::cerr << error.what() << '\n';
+            return 1;
+        }
 
-            // Print them to the file.
-            comOutput << counter++ << ' ' << centreOfMass.first << ' ' << centreOfMass.second << std::endl;
+        double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double cells = static_cast<double>(rowCount) * colCount * (generation - startGeneration);
+        exportMetrics();
+
+        std::cout << "Seed:              " << seed << '\n';
+        std::cout << "Board:             " << rowCount << 'x' << colCount << '\n';
+        std::cout << "Generations:       " << generation - startGeneration << '\n';
+        std::cout << "Wall time (s):     " << wallTime << '\n';
+        std::cout << "Generations/s:     " << (generation - startGeneration) / wallTime << '\n';
+        std::cout << "Cells/s:           " << cells / wallTime << '\n';
+        std::cout << "Final population:  " << boardCurrent.getPopulation() << '\n';
+        if(engine == "sparse")
+        {
+            std::cout << "Plane population:  " << sparseLife.getPopulation() << '\n';
+        }
+        if(steady)
+        {
+            std::cout << "Stopped:           " << stopReason << '\n';
+        }
+        if(cycleDetector.getCollisions() > 0)
+        {
+            std::cout << "Hash collisions:   " << cycleDetector.getCollisions() << '\n';
+        }
+        if(censusEvery > 0)
+        {
+            std::cout << "Objects:           " << patternCensus.getObjectCount() << '\n';
+            const std::vector<CensusEntry> &census = patternCensus.getCensus();
+            for(std::size_t kind = 0; kind < std::min(census.size(), std::size_t(5)); ++kind)
+            {
+                std::cout << "  " << census[kind].name << ": " << census[kind].count << '\n';
             }
-            else
+            if(!censusFile)
             {
-                counter++;
+                std::cerr << "Could not write census file " << censusOutput << ".\n";
+                return 1;
             }
+        }
 
+        if(vm.count("save-pattern"))
+        {
+            std::ofstream patternOutput(savePatternFile);
+            writePattern(patternOutput, patternFormatFromFileName(savePatternFile), boardCurrent);
+            if(!patternOutput)
+            {
+                std::cerr << "Could not write pattern file " << savePatternFile << ".\n";
+                return 1;
+            }
         }
 
-        // Move the cursor back to the top of the board.
-        for(int row = 0; row < boardCurrent.getRows(); ++row)
+        return 0;
+    }
+
+
+/*************************************************************************************************************************
+************************************************* Main Loop *************************************************************
+*************************************************************************************************************************/
+    RenderMode renderMode = (render == "half") ? RenderMode::HalfBlock : (render == "braille") ? RenderMode::Braille : RenderMode::Cells;
+    FrameRenderer renderer(STDOUT_FILENO, renderMode, vm.count("diff") > 0);
+
+    // Drawing and analysing the boards happens on their own threads, which take the newest 
+    // generation whenever they are ready and skip any they were too slow for, so neither can 
+    // hold up the simulation.
+    boardCurrent.setStatisticsTracking(true);
+    SnapshotRing snapshots(2, boardCurrent);
+
+    std::thread renderThread([&]()
+    {
+        std::uint64_t lastGeneration = 0;
+        while(SnapshotRing::Snapshot snapshot = snapshots.acquire(lastGeneration))
+        {
+            METRICS_TIME(Phase::Render);
+            renderer.render(snapshot.board());
+            lastGeneration = snapshot.generation();
+        }
+    });
+
+    std::thread analysisThread([&]()
+    {
+        std::uint64_t lastGeneration = 0;
+        while(SnapshotRing::Snapshot snapshot = snapshots.acquire(lastGeneration))
+        {
+            lastGeneration = snapshot.generation();
+
+            // If the user has asked for a glider we can calculate its centre of mass, which the 
+            // update has already gathered. On the torus it is a circular mean so it stays with the 
+            // glider as it crosses the boundary.
+            if(vm.count("glider"))
+            {
+                std::pair<double,double> centreOfMass;
+                {
+                    METRICS_TIME(Phase::Analysis);
+                    bool periodic = (engine == "dense" && boundary == "torus");
+                    centreOfMass = periodic ? snapshot.board().periodicCentreOfMass() : snapshot.board().centreOfMass();
+                }
+
+                // Print them to the file, which is flushed when the run stops rather than every generation.
+                METRICS_TIME(Phase::ComWrite);
+                comOutput << lastGeneration << ' ' << centreOfMass.first << ' ' << centreOfMass.second << '\n';
+            }
+        }
+    });
+
+    // Stop cleanly on Ctrl-C so the consumers finish and the output files are flushed.
+    std::signal(SIGINT, handleInterrupt);
+
+    int status = 0;
+    while(!interrupted && !steady)
+    {
+        // Update the board and hand it to the consumers.
+        step(generationsPerStep);
         {
-            std::cout << "\e[A";
-            std::cout << "\r";
+            // The padded layout only fills the board for the frame that is drawn.
+            METRICS_TIME(Phase::Publish);
+            if(vm.count("padded"))
+            {
+                paddedStepper.copyToBoard(boardUpdated);
+            }
+            snapshots.publish(boardUpdated, generation + generationsPerStep);
         }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
         // Swap the boards so no unnecessary copying takes place.
-        std::swap(boardUpdated, boardCurrent);
+        boardBuffers.flip();
+
+        // Periodically save the board so the run can be resumed.
+        std::uint64_t previousGeneration = generation;
+        generation += generationsPerStep;
+        if(checkpointEvery > 0 && generation / static_cast<std::uint64_t>(checkpointEvery) != previousGeneration / static_cast<std::uint64_t>(checkpointEvery))
+        {
+            try
+            {
+                saveCheckpoint(boardCurrent);
+            }
+            catch(const std::runtime_error &error)
+            {
+                std::cerr << error.what() << '\n';
+                status = 1;
+                break;
+            }
+        }
+
+        // Count the objects on the board every so often.
+        if(censusEvery > 0 && generation / static_cast<std::uint64_t>(censusEvery) != previousGeneration / static_cast<std::uint64_t>(censusEvery))
+        {
+            takeCensus(boardCurrent);
+        }
 
         // Check if the system has reached a steady state and if it has break the loop.
+        if(detectCycles && reachedSteadyState(boardCurrent))
+        {
+            break;
+        }
+        metricsExporter.poll();
     }
 
 /*************************************************************************************************************************
 ************************************************* Clean Up *************************************************************
 *************************************************************************************************************************/
 
-    return 0;
+    snapshots.close();
+    renderThread.join();
+    analysisThread.join();
+    exportMetrics();
+
+    if(!stopReason.empty())
+    {
+        std::cout << "Stopped: " << stopReason << '\n';
+    }
+
+    if(censusEvery > 0 && !censusFile)
+    {
+        std::cerr << "Could not write census file " << censusOutput << ".\n";
+        status = 1;
+    }
+
+    return status;
 }